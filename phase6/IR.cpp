@@ -0,0 +1,512 @@
+/*
+ * File:	IR.cpp
+ *
+ * Description:	This file contains the constructors, accessors, and flow
+ *		graph analyses for the intermediate representation.  The
+ *		dominators are computed using the iterative algorithm of
+ *		Cooper, Harvey, and Kennedy, which for graphs the size of
+ *		our functions is both simpler and faster than the algorithm
+ *		of Lengauer and Tarjan.
+ */
+
+# include <algorithm>
+# include "machine.h"
+# include "IR.h"
+# include "statistics.h"
+
+using namespace std;
+
+static unsigned counter = 0;
+
+static const char *opcodes[] = {
+    "const", "param", "frame", "global",
+    "get", "set", "load", "store", "call",
+    "add", "sub", "mul", "div", "rem", "neg",
+    "lt", "gt", "le", "ge", "eq", "ne",
+    "ext", "trunc", "copy", "phi", "move",
+    "splat", "iota",
+    "jump", "branch", "return",
+};
+
+
+/*
+ * Function:	Instruction::Instruction (constructor)
+ *
+ * Description:	Initialize this instruction with a unique number.
+ */
+
+Instruction::Instruction(int opcode, unsigned size, const Instructions &operands,
+	long value)
+    : _opcode(opcode), _size(size), _value(value), _operands(operands),
+      _block(nullptr), _number(counter ++), _line(0)
+{
+    if (memReport)
+	tallies[INSTRUCTIONS] ++;
+}
+
+
+/*
+ * Function:	Instruction::isTerminator
+ *
+ * Description:	Return whether this instruction ends a basic block.
+ */
+
+bool Instruction::isTerminator() const
+{
+    return _opcode == OP_JUMP || _opcode == OP_BRANCH || _opcode == OP_RETURN;
+}
+
+
+/*
+ * Function:	Instruction::isPure
+ *
+ * Description:	Return whether this instruction computes a value that
+ *		depends only upon its operands, and has no other effect, so
+ *		that it can be freely removed or reused.
+ */
+
+bool Instruction::isPure() const
+{
+    switch (_opcode) {
+    case OP_CONST: case OP_FRAME: case OP_GLOBAL:
+    case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_REM:
+    case OP_NEG: case OP_EXT: case OP_TRUNC: case OP_COPY:
+    case OP_SPLAT: case OP_IOTA:
+    case OP_LT: case OP_GT: case OP_LE: case OP_GE: case OP_EQ: case OP_NE:
+	return true;
+    }
+
+    return false;
+}
+
+
+/*
+ * Function:	Instruction::isCompare
+ *
+ * Description:	Return whether this instruction is a comparison.
+ */
+
+bool Instruction::isCompare() const
+{
+    return _opcode >= OP_LT && _opcode <= OP_NE;
+}
+
+
+/*
+ * Function:	Instruction::isVector
+ *
+ * Description:	Return whether this instruction computes, moves, or stores
+ *		a vector rather than a scalar.
+ */
+
+bool Instruction::isVector() const
+{
+    return _size > SIZEOF_LONG;
+}
+
+
+/*
+ * Function:	BasicBlock::BasicBlock (constructor)
+ *
+ * Description:	Initialize an empty block.
+ */
+
+BasicBlock::BasicBlock()
+    : _dominator(nullptr), _number(0), _count(-1)
+{
+    if (memReport)
+	tallies[BLOCKS] ++;
+}
+
+
+/*
+ * Function:	BasicBlock::terminator
+ *
+ * Description:	Return the last instruction of this block if it is a
+ *		terminator, and null otherwise.
+ */
+
+Instruction *BasicBlock::terminator() const
+{
+    if (_instructions.empty() || !_instructions.back()->isTerminator())
+	return nullptr;
+
+    return _instructions.back();
+}
+
+
+/*
+ * Function:	BasicBlock::isTail
+ *
+ * Description:	Return whether the call at the given position in this block
+ *		is a tail call: one followed only by returning either its
+ *		value or no value at all, possibly after jumping to a
+ *		block that does nothing else.
+ */
+
+bool BasicBlock::isTail(unsigned position) const
+{
+    Instruction *call = _instructions[position], *next;
+
+
+    if (position + 2 != _instructions.size())
+	return false;
+
+    next = _instructions.back();
+
+    if (next->_opcode == OP_JUMP) {
+	if (_successors[0]->_instructions.size() != 1)
+	    return false;
+
+	next = _successors[0]->_instructions[0];
+    }
+
+    if (next->_opcode != OP_RETURN)
+	return false;
+
+    return next->_operands.empty() || next->_operands[0] == call;
+}
+
+
+/*
+ * Function:	BasicBlock::insert
+ *
+ * Description:	Insert an instruction at the given position in this block.
+ */
+
+void BasicBlock::insert(Instruction *instruction, unsigned position)
+{
+    instruction->_block = this;
+    _instructions.insert(_instructions.begin() + position, instruction);
+}
+
+
+/*
+ * Function:	BasicBlock::append
+ *
+ * Description:	Append an instruction to the end of this block.
+ */
+
+void BasicBlock::append(Instruction *instruction)
+{
+    instruction->_block = this;
+    _instructions.push_back(instruction);
+}
+
+
+/*
+ * Function:	BasicBlock::disconnect
+ *
+ * Description:	Remove one occurrence of the given block from the
+ *		predecessors of this block, along with the corresponding
+ *		operand of every phi function.
+ */
+
+void BasicBlock::disconnect(BasicBlock *predecessor)
+{
+    unsigned i = find(_predecessors.begin(), _predecessors.end(),
+	    predecessor) - _predecessors.begin();
+
+    if (i == _predecessors.size())
+	return;
+
+    _predecessors.erase(_predecessors.begin() + i);
+
+    for (unsigned j = 0; j < _instructions.size(); j ++)
+	if (_instructions[j]->_opcode == OP_PHI)
+	    _instructions[j]->_operands.erase(_instructions[j]->_operands.begin() + i);
+}
+
+
+/*
+ * Function:	BasicBlock::taken
+ *
+ * Description:	Return the number of times the profile shows that control
+ *		passed from this block to the given successor, or -1 if
+ *		unknown.  If the successor can also be reached from other
+ *		blocks, the count is that of this block less that of its
+ *		other successor.
+ */
+
+long BasicBlock::taken(const BasicBlock *successor) const
+{
+    const BasicBlock *other;
+
+
+    if (successor->_predecessors.size() == 1 && successor->_count >= 0)
+	return successor->_count;
+
+    if (_successors.size() != 2 || _count < 0)
+	return -1;
+
+    other = _successors[_successors[0] == successor ? 1 : 0];
+
+    if (other->_predecessors.size() != 1 || other->_count < 0)
+	return -1;
+
+    return max(_count - other->_count, 0L);
+}
+
+
+/*
+ * Function:	Graph::Graph (constructor)
+ *
+ * Description:	Initialize a flow graph for the given function with an
+ *		empty entry block.
+ */
+
+Graph::Graph(const Symbol *id)
+    : _id(id), _entry(new BasicBlock()), _offset(0), _count(-1), _line(0)
+{
+    _blocks.push_back(_entry);
+}
+
+
+/*
+ * Function:	Graph::order
+ *
+ * Description:	Put the blocks in reverse postorder and number them.  Any
+ *		block that is unreachable from the entry block is removed
+ *		from the graph and from the predecessors of its successors.
+ *		The successor of a branch visited last usually follows it,
+ *		so the one executed more often is visited last.
+ */
+
+void Graph::order()
+{
+    vector<pair<BasicBlock *, unsigned>> stack;
+    BasicBlocks postorder;
+    vector<bool> visited;
+
+
+    /* Number the blocks so that we can mark them as visited. */
+
+    for (unsigned i = 0; i < _blocks.size(); i ++)
+	_blocks[i]->_number = i;
+
+    visited.assign(_blocks.size(), false);
+    visited[_entry->_number] = true;
+    stack.push_back(make_pair(_entry, 0));
+
+    while (!stack.empty()) {
+	BasicBlock *block = stack.back().first;
+	BasicBlocks &succs = block->_successors;
+	unsigned i = stack.back().second ++;
+
+	if (i < succs.size()) {
+	    if (succs.size() == 2 && block->taken(succs[1]) >= 0 &&
+		    block->taken(succs[0]) > block->taken(succs[1]))
+		i = 1 - i;
+
+	    BasicBlock *next = succs[i];
+
+	    if (!visited[next->_number]) {
+		visited[next->_number] = true;
+		stack.push_back(make_pair(next, 0));
+	    }
+
+	} else {
+	    postorder.push_back(block);
+	    stack.pop_back();
+	}
+    }
+
+
+    /* Remove the edges from unreachable blocks. */
+
+    for (unsigned i = 0; i < _blocks.size(); i ++)
+	if (!visited[i])
+	    for (unsigned j = 0; j < _blocks[i]->_successors.size(); j ++)
+		_blocks[i]->_successors[j]->disconnect(_blocks[i]);
+
+    _blocks.assign(postorder.rbegin(), postorder.rend());
+
+    for (unsigned i = 0; i < _blocks.size(); i ++)
+	_blocks[i]->_number = i;
+}
+
+
+/*
+ * Function:	intersect (private)
+ *
+ * Description:	Return the nearest common dominator of two blocks by
+ *		walking up the dominator tree from each.
+ */
+
+static BasicBlock *intersect(BasicBlock *a, BasicBlock *b)
+{
+    while (a != b) {
+	while (a->_number > b->_number)
+	    a = a->_dominator;
+
+	while (b->_number > a->_number)
+	    b = b->_dominator;
+    }
+
+    return a;
+}
+
+
+/*
+ * Function:	Graph::dominators
+ *
+ * Description:	Compute the immediate dominator of each block and the
+ *		children of each block in the dominator tree.  The blocks
+ *		must already be in reverse postorder.
+ */
+
+void Graph::dominators()
+{
+    bool changed = true;
+
+
+    for (unsigned i = 0; i < _blocks.size(); i ++) {
+	_blocks[i]->_dominator = nullptr;
+	_blocks[i]->_children.clear();
+    }
+
+    _entry->_dominator = _entry;
+
+    while (changed) {
+	changed = false;
+
+	for (unsigned i = 1; i < _blocks.size(); i ++) {
+	    BasicBlock *block = _blocks[i], *idom = nullptr;
+
+	    for (unsigned j = 0; j < block->_predecessors.size(); j ++) {
+		BasicBlock *pred = block->_predecessors[j];
+
+		if (pred->_dominator != nullptr)
+		    idom = idom == nullptr ? pred : intersect(pred, idom);
+	    }
+
+	    if (block->_dominator != idom) {
+		block->_dominator = idom;
+		changed = true;
+	    }
+	}
+    }
+
+    _entry->_dominator = nullptr;
+
+    for (unsigned i = 1; i < _blocks.size(); i ++)
+	_blocks[i]->_dominator->_children.push_back(_blocks[i]);
+}
+
+
+/*
+ * Function:	Graph::dominates
+ *
+ * Description:	Return whether the first block dominates the second.
+ */
+
+bool Graph::dominates(const BasicBlock *a, const BasicBlock *b) const
+{
+    while (b != nullptr && b != a)
+	b = b->_dominator;
+
+    return b == a;
+}
+
+
+/*
+ * Function:	Graph::replace
+ *
+ * Description:	Replace every use of each value in the given map with the
+ *		value it maps to.  A value may map to another value that is
+ *		itself replaced, so we follow the chain to its end.
+ */
+
+void Graph::replace(map<Instruction *, Instruction *> &values)
+{
+    map<Instruction *, Instruction *>::iterator it;
+
+
+    if (values.empty())
+	return;
+
+    for (unsigned i = 0; i < _blocks.size(); i ++) {
+	Instructions &instructions = _blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instructions &operands = instructions[j]->_operands;
+
+	    for (unsigned k = 0; k < operands.size(); k ++)
+		while ((it = values.find(operands[k])) != values.end())
+		    operands[k] = it->second;
+	}
+    }
+}
+
+
+/*
+ * Function:	normalize
+ *
+ * Description:	Return the given value truncated to the given size and then
+ *		sign extended, which is how we represent all constants.
+ */
+
+long normalize(long value, unsigned size)
+{
+    if (size == 1)
+	return (signed char) value;
+
+    if (size == 4)
+	return (int) value;
+
+    return value;
+}
+
+
+/*
+ * Function:	dump
+ *
+ * Description:	Write a flow graph in a readable form for debugging.
+ */
+
+void dump(const Graph *graph, ostream &ostr)
+{
+    ostr << "# " << graph->_id->name() << endl;
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+
+	ostr << "# b" << block->_number << ":";
+
+	for (unsigned j = 0; j < block->_predecessors.size(); j ++)
+	    ostr << (j == 0 ? "\t<- b" : ", b") << block->_predecessors[j]->_number;
+
+	ostr << endl;
+
+	for (unsigned j = 0; j < block->_instructions.size(); j ++) {
+	    Instruction *in = block->_instructions[j];
+
+	    ostr << "#\t";
+
+	    if (in->_size > 0 && in->_opcode != OP_MOVE && in->_opcode != OP_STORE)
+		ostr << "v" << in->_number << " = ";
+
+	    ostr << opcodes[in->_opcode];
+
+	    if (in->_size > 0)
+		ostr << "." << in->_size;
+
+	    if (in->_opcode == OP_CONST || in->_opcode == OP_PARAM ||
+		    in->_opcode == OP_FRAME || in->_opcode == OP_GET ||
+		    in->_opcode == OP_SET)
+		ostr << " " << in->_value;
+
+	    if (!in->_name.empty())
+		ostr << " " << in->_name;
+
+	    for (unsigned k = 0; k < in->_operands.size(); k ++)
+		ostr << (k == 0 ? " v" : ", v") << in->_operands[k]->_number;
+
+	    for (unsigned k = 0; k < block->_successors.size(); k ++)
+		if (in->isTerminator())
+		    ostr << (k == 0 ? " -> b" : ", b") << block->_successors[k]->_number;
+
+	    ostr << endl;
+	}
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ * File:	IR.h
+ *
+ * Description:	This file contains the class definitions and function
+ *		declarations for the intermediate representation used when
+ *		optimizing.  Each function is translated from its abstract
+ *		syntax tree into a flow graph of basic blocks, where each
+ *		block is a list of three-address instructions ending in a
+ *		single branch, jump, or return.
+ *
+ *		An instruction is also the value it computes, so operands
+ *		refer directly to the instructions that define them.  Local
+ *		scalar variables are initially read and written using get
+ *		and set instructions, which are then replaced by values and
+ *		phi functions when the graph is put in static single
+ *		assignment (SSA) form.  Variables whose address is taken,
+ *		arrays, and globals always live in memory, and are accessed
+ *		using load and store instructions.
+ *
+ *		IR.cpp - constructors, accessors, and flow graph analyses
+ *		builder.cpp - member functions to build the flow graph
+ *		inliner.cpp - inlining of calls to small leaf functions
+ *		optimizer.cpp - SSA construction and optimization passes
+ *		loops.cpp - loop invariant code motion and strength reduction
+ *		vectorizer.cpp - vectorization of simple counted loops
+ *		emitter.cpp - translation out of SSA form into assembly
+ *		passes.cpp - pass manager that runs the pipeline for each
+ *		    optimization level
+ */
+
+# ifndef IR_H
+# define IR_H
+# include <map>
+# include <string>
+# include <vector>
+# include <ostream>
+# include "Symbol.h"
+
+typedef std::vector<class Instruction *> Instructions;
+typedef std::vector<class BasicBlock *> BasicBlocks;
+
+
+/* The operations.  Values of size 1, 4, or 8 bytes are computed by all
+   but the stores, calls with no result, moves, and terminators.  A
+   vector of 16 or 32 bytes is computed by a vectorized load, add,
+   subtract, or multiply, by a splat of a scalar into every lane, or by
+   an iota, whose lanes are numbered from zero. */
+
+enum {
+    OP_CONST, OP_PARAM, OP_FRAME, OP_GLOBAL,
+    OP_GET, OP_SET, OP_LOAD, OP_STORE, OP_CALL,
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_REM, OP_NEG,
+    OP_LT, OP_GT, OP_LE, OP_GE, OP_EQ, OP_NE,
+    OP_EXT, OP_TRUNC, OP_COPY, OP_PHI, OP_MOVE,
+    OP_SPLAT, OP_IOTA,
+    OP_JUMP, OP_BRANCH, OP_RETURN
+};
+
+
+/* An instruction.  The value is the integer constant, parameter
+   number, frame offset, or variable number, depending upon the
+   operation, and the name is the operand for a global or the name of a
+   called function.  For a vector operation, the value is instead the
+   size of each lane.  The operands of a phi function are in the same
+   order as the predecessors of its block.  The line is that of the
+   statement from which the instruction was built, or zero if unknown. */
+
+class Instruction {
+    typedef std::string string;
+
+public:
+    int _opcode;
+    unsigned _size;
+    long _value;
+    string _name;
+    Instructions _operands;
+    class BasicBlock *_block;
+    unsigned _number;
+    unsigned _line;
+
+    Instruction(int opcode, unsigned size, const Instructions &operands = {},
+	    long value = 0);
+
+    bool isTerminator() const;
+    bool isPure() const;
+    bool isCompare() const;
+    bool isVector() const;
+};
+
+
+/* A basic block.  The successors of a branch are the targets when its
+   operand is nonzero and zero, respectively.  The count is the number
+   of times the block was executed according to the profile, or -1 if
+   unknown. */
+
+class BasicBlock {
+public:
+    Instructions _instructions;
+    BasicBlocks _predecessors, _successors;
+    BasicBlock *_dominator;
+    BasicBlocks _children;
+    unsigned _number;
+    long _count;
+
+    BasicBlock();
+    Instruction *terminator() const;
+    long taken(const BasicBlock *successor) const;
+    bool isTail(unsigned position) const;
+    void insert(Instruction *instruction, unsigned position);
+    void append(Instruction *instruction);
+    void disconnect(BasicBlock *predecessor);
+};
+
+
+/* A flow graph for a function.  Once ordered, the blocks are kept in
+   reverse postorder with the entry block first.  Each local scalar
+   variable is assigned a number, with the size of each variable
+   recorded.  With a profile, the graph also records how often the
+   function was entered and how often each of its calls was made.  The
+   line is that on which the function is defined. */
+
+class Graph {
+public:
+    const Symbol *_id;
+    BasicBlock *_entry;
+    BasicBlocks _blocks;
+    std::vector<unsigned> _variables;
+    int _offset;
+    long _count;
+    std::map<const Instruction *, unsigned long> _calls;
+    unsigned _line;
+
+    Graph(const Symbol *id);
+    void order();
+    void dominators();
+    bool dominates(const BasicBlock *a, const BasicBlock *b) const;
+    void replace(std::map<Instruction *, Instruction *> &values);
+};
+
+extern unsigned optimization;
+extern unsigned vectorSize;
+extern bool vectorizeLoops;
+extern unsigned inlineLimit;
+
+long normalize(long value, unsigned size);
+
+void inlineCalls(const std::vector<Graph *> &graphs);
+void constructSSA(Graph *graph);
+void propagateConstants(Graph *graph);
+void propagateCopies(Graph *graph);
+void numberValues(Graph *graph);
+void eliminateDeadCode(Graph *graph);
+void simplifyGraph(Graph *graph);
+void optimizeLoops(Graph *graph);
+bool vectorize(Graph *graph, BasicBlock *preheader, BasicBlock *header);
+void emit(Graph *graph);
+void dump(const Graph *graph, std::ostream &ostr);
+
+bool enablePass(const std::string &name, bool enabled);
+void runPasses(const std::vector<class Function *> &functions);
+
+# endif /* IR_H */
@@ -12,6 +12,7 @@
 
 # include <iostream>
 # include "Label.h"
+# include "machine.h"
 
 using std::ostream;
 
@@ -25,6 +26,10 @@ unsigned Label::number() const {
   return _number;
 }
 
+unsigned Label::count() {
+  return _counter;
+}
+
 ostream &operator <<(ostream &ostr, const Label &label) {
-  return ostr << ".L" << label.number();
+  return ostr << label_prefix << label.number();
 }
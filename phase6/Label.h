@@ -20,6 +20,7 @@ class Label {
 public:
   Label();
   unsigned number() const;
+  static unsigned count();
 };
 
 std::ostream &operator <<(std::ostream &ostr, const Label &label);
@@ -15,6 +15,7 @@
 
 # include <cassert>
 # include "Scope.h"
+# include "statistics.h"
 
 
 /*
@@ -26,6 +27,8 @@
 Scope::Scope(Scope *enclosing)
     : _enclosing(enclosing)
 {
+    if (memReport)
+	tallies[SCOPES] ++;
 }
 
 
@@ -7,6 +7,7 @@
  */
 
 # include "Symbol.h"
+# include "statistics.h"
 
 using std::string;
 
@@ -20,6 +21,8 @@ using std::string;
 Symbol::Symbol(const string &name, const Type &type)
     : _name(name), _type(type), _offset(0)
 {
+    if (memReport)
+	tallies[SYMBOLS] ++;
 }
 
 
@@ -20,12 +20,80 @@
  */
 
 # include "Tree.h"
+# include "lexer.h"
+# include "statistics.h"
 # include "tokens.h"
 # include <sstream>
 # include <cstdlib>
 
 using namespace std;
 
+static const unsigned long basis = 14695981039346656037UL;
+static unsigned long signature = basis;
+static unsigned numProbes = 1;
+
+
+/*
+ * Function:	probe (private)
+ *
+ * Description:	Allocate the given number of profile counters for a node
+ *		of the function being parsed, and fold the kind of node
+ *		into the checksum of the function using the FNV-1a hash.
+ */
+
+static unsigned probe(unsigned count, const string &kind)
+{
+    for (unsigned i = 0; i < kind.size(); i ++)
+	signature = (signature ^ (unsigned char) kind[i]) * 1099511628211UL;
+
+    numProbes += count;
+    return numProbes - count;
+}
+
+
+/*
+ * Function:	Node::Node (constructor)
+ *
+ * Description:	Initialize a node with the current line of the source.
+ */
+
+Node::Node()
+    : _line(lineno)
+{
+}
+
+
+/*
+ * Function:	Node::operator new
+ *
+ * Description:	Allocate a node, recording it if the nodes are being
+ *		reported.  A node on the stack is not recorded, since it is
+ *		gone by the time they are reported.
+ */
+
+void *Node::operator new(size_t size)
+{
+    void *node = ::operator new(size);
+
+
+    if (memReport)
+	record((Node *) node, size);
+
+    return node;
+}
+
+
+/*
+ * Function:	Node::operator delete
+ *
+ * Description:	Deallocate a node.
+ */
+
+void Node::operator delete(void *node)
+{
+    ::operator delete(node);
+}
+
 
 /*
  * Function:	Expression::Expression (constructor)
@@ -64,6 +132,19 @@ bool Expression::lvalue() const
 }
 
 
+/*
+ * Function:	Expression::isLiteral
+ *
+ * Description:	Return whether this expression is an integer literal, and
+ *		if so, its value.  In general, it is not.
+ */
+
+bool Expression::isLiteral(long &value) const
+{
+    return false;
+}
+
+
 /*
  * Function:	Binary::Binary (constructor)
  *
@@ -181,6 +262,23 @@ Number::Number(unsigned long value)
 }
 
 
+/*
+ * Function:	Number::Number (constructor)
+ *
+ * Description:	Initialize a number of the given type, such as one folded
+ *		from an expression, whose value may be negative.
+ */
+
+Number::Number(long value, const Type &type)
+    : Expression(type)
+{
+    stringstream ss;
+
+    ss << value;
+    _value = ss.str();
+}
+
+
 /*
  * Function:	Number::value (accessor)
  *
@@ -193,6 +291,19 @@ const string &Number::value() const
 }
 
 
+/*
+ * Function:	Number::isLiteral
+ *
+ * Description:	Return the value of this number, which is a literal.
+ */
+
+bool Number::isLiteral(long &value) const
+{
+    value = strtoul(_value.c_str(), nullptr, 0);
+    return true;
+}
+
+
 /*
  * Function:	Call::Call (constructor)
  *
@@ -202,6 +313,7 @@ const string &Number::value() const
 Call::Call(const Symbol *id, const Expressions &args, const Type &type)
     : Expression(type), _id(id), _args(args)
 {
+    _probe = probe(1, "call " + id->name() + ";");
 }
 
 
@@ -479,6 +591,7 @@ Scope *Block::declarations() const
 While::While(Expression *expr, Statement *stmt)
     : _expr(expr), _stmt(stmt)
 {
+    _probe = probe(2, "while;");
 }
 
 
@@ -491,16 +604,70 @@ While::While(Expression *expr, Statement *stmt)
 If::If(Expression *expr, Statement *thenStmt, Statement *elseStmt)
     : _expr(expr), _thenStmt(thenStmt), _elseStmt(elseStmt)
 {
+    _probe = probe(2, elseStmt != nullptr ? "if else;" : "if;");
 }
 
 
 /*
  * Function:	Function::Function (constructor)
  *
- * Description:	Initialize a function object.
+ * Description:	Initialize a function object.  Its body has already been
+ *		parsed, so it takes the counters allocated so far, and the
+ *		next function starts afresh.
  */
 
 Function::Function(const Symbol *id, Block *body)
-    : _id(id), _body(body)
+    : _id(id), _body(body), _graph(nullptr), _probes(numProbes),
+      _checksum(signature)
+{
+    numProbes = 1;
+    signature = basis;
+}
+
+
+/*
+ * Function:	Function::id (accessor)
+ *
+ * Description:	Return the symbol for this function.
+ */
+
+const Symbol *Function::id() const
+{
+    return _id;
+}
+
+
+/*
+ * Function:	Function::flowGraph (accessor)
+ *
+ * Description:	Return the flow graph of this function, once built.
+ */
+
+Graph *Function::flowGraph() const
+{
+    return _graph;
+}
+
+
+/*
+ * Function:	Function::probes (accessor)
+ *
+ * Description:	Return the number of profile counters for this function.
+ */
+
+unsigned Function::probes() const
+{
+    return _probes;
+}
+
+
+/*
+ * Function:	Function::checksum (accessor)
+ *
+ * Description:	Return the checksum of the structure of this function.
+ */
+
+unsigned long Function::checksum() const
 {
+    return _checksum;
 }
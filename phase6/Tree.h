@@ -21,6 +21,7 @@
  *		Tree.cpp - constructors and accessors
  *		allocator.cpp - member functions to do storage allocation
  *		generator.cpp - member functions to do code generation
+ *		builder.cpp - member functions to build the flow graph
  */
 
 # ifndef TREE_H
@@ -34,18 +35,29 @@
 typedef std::vector<class Statement *> Statements;
 typedef std::vector<class Expression *> Expressions;
 
+class Instruction;
+class BasicBlock;
+class Graph;
 
-/* The base class */
+
+/* The base class.  Each node records the line of the source on which
+   it was constructed, which for a statement is the line on which it
+   starts. */
 
 class Node {
 protected:
     typedef std::string string;
-    Node() {}
+    Node();
 
 public:
+    unsigned _line;
+
+    static void *operator new(size_t size);
+    static void operator delete(void *node);
     virtual ~Node() {}
     virtual void allocate(int &offset) const {}
     virtual void generate() {}
+    virtual void build() {}
 };
 
 
@@ -71,8 +83,15 @@ public:
 
     const Type &type() const;
     bool lvalue() const;
-    void test(const Label &label, bool ifTrue);
+    virtual bool isLiteral(long &value) const;
+    virtual void test(const Label &label, bool ifTrue);
     virtual Expression *getDereference() const{return nullptr;}
+
+    virtual Instruction *evaluate() = 0;
+    virtual Instruction *address();
+    virtual void store(Instruction *value);
+    virtual void condition(BasicBlock *ifTrue, BasicBlock *ifFalse);
+    virtual void build();
 };
 
 
@@ -103,6 +122,8 @@ public:
     String(const string &value);
     const string &value() const;
     virtual void generate();
+    virtual Instruction *evaluate();
+    virtual Instruction *address();
 };
 
 
@@ -115,6 +136,9 @@ public:
     Identifier(const Symbol *symbol);
     const Symbol *symbol() const;
     virtual void generate();
+    virtual Instruction *evaluate();
+    virtual Instruction *address();
+    virtual void store(Instruction *value);
 };
 
 
@@ -126,8 +150,13 @@ class Number : public Expression {
 public:
     Number(const string &value);
     Number(unsigned long value);
+    Number(long value, const Type &type);
     const string &value() const;
+    virtual bool isLiteral(long &value) const;
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual void condition(BasicBlock *ifTrue, BasicBlock *ifFalse);
+    virtual Instruction *evaluate();
 };
 
 
@@ -136,10 +165,12 @@ public:
 class Call : public Expression {
     const Symbol *_id;
     Expressions _args;
+    unsigned _probe;
 
 public:
     Call(const Symbol *id, const Expressions &args, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -148,7 +179,10 @@ public:
 class Not : public Unary {
 public:
     Not(Expression *expr, const Type &type);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual void condition(BasicBlock *ifTrue, BasicBlock *ifFalse);
+    virtual Instruction *evaluate();
 };
 
 
@@ -158,6 +192,7 @@ class Negate : public Unary {
 public:
     Negate(Expression *expr, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -168,6 +203,8 @@ public:
     Dereference(Expression *expr, const Type &type);
     virtual Expression *getDereference() const{return _expr;}
     virtual void generate();
+    virtual Instruction *evaluate();
+    virtual Instruction *address();
 };
 
 
@@ -177,6 +214,7 @@ class Address : public Unary {
 public:
     Address(Expression *expr, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -186,6 +224,7 @@ class Cast : public Unary {
 public:
     Cast(const Type &type, Expression *expr);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -195,6 +234,7 @@ class Multiply : public Binary {
 public:
     Multiply(Expression *left, Expression *right, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -204,6 +244,7 @@ class Divide : public Binary {
 public:
     Divide(Expression *left, Expression *right, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -213,6 +254,7 @@ class Remainder : public Binary {
 public:
     Remainder(Expression *left, Expression *right, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -222,6 +264,7 @@ class Add : public Binary {
 public:
     Add(Expression *left, Expression *right, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -231,6 +274,7 @@ class Subtract : public Binary {
 public:
     Subtract(Expression *left, Expression *right, const Type &type);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -239,8 +283,9 @@ public:
 class LessThan : public Binary {
 public:
     LessThan(Expression *left, Expression *right, const Type &type);
-    virtual void test(const Label &label, bool onTrue);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -249,8 +294,9 @@ public:
 class GreaterThan : public Binary {
 public:
     GreaterThan(Expression *left, Expression *right, const Type &type);
-    virtual void test(const Label &label, bool onTrue);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -259,8 +305,9 @@ public:
 class LessOrEqual : public Binary {
 public:
     LessOrEqual(Expression *left, Expression *right, const Type &type);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
-    friend void GreaterThan::test(const Label &label, bool onTrue);
+    virtual Instruction *evaluate();
 };
 
 
@@ -269,8 +316,9 @@ public:
 class GreaterOrEqual : public Binary {
 public:
     GreaterOrEqual(Expression *left, Expression *right, const Type &type);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
-    friend void LessThan::test(const Label &label, bool onTrue);
+    virtual Instruction *evaluate();
 };
 
 
@@ -279,7 +327,9 @@ public:
 class Equal : public Binary {
 public:
     Equal(Expression *left, Expression *right, const Type &type);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -288,7 +338,9 @@ public:
 class NotEqual : public Binary {
 public:
     NotEqual(Expression *left, Expression *right, const Type &type);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual Instruction *evaluate();
 };
 
 
@@ -297,7 +349,10 @@ public:
 class LogicalAnd: public Binary {
 public:
     LogicalAnd(Expression *left, Expression *right, const Type &type);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual Instruction *evaluate();
+    virtual void condition(BasicBlock *ifTrue, BasicBlock *ifFalse);
 };
 
 
@@ -306,7 +361,10 @@ public:
 class LogicalOr : public Binary {
 public:
     LogicalOr(Expression *left, Expression *right, const Type &type);
+    virtual void test(const Label &label, bool ifTrue);
     virtual void generate();
+    virtual Instruction *evaluate();
+    virtual void condition(BasicBlock *ifTrue, BasicBlock *ifFalse);
 };
 
 
@@ -318,6 +376,7 @@ class Assignment : public Statement {
 public:
     Assignment(Expression *left, Expression *right);
     virtual void generate();
+    virtual void build();
 };
 
 
@@ -329,6 +388,7 @@ class Return : public Statement {
 public:
     Return(Expression *expr);
     virtual void generate();
+    virtual void build();
 };
 
 
@@ -347,6 +407,7 @@ public:
     Scope *declarations() const;
     virtual void allocate(int &offset) const;
     virtual void generate();
+    virtual void build();
 };
 
 
@@ -355,11 +416,13 @@ public:
 class While : public Statement {
     Expression *_expr;
     Statement *_stmt;
+    unsigned _probe;
 
 public:
     While(Expression *expr, Statement *stmt);
     virtual void allocate(int &offset) const;
     virtual void generate();
+    virtual void build();
 };
 
 
@@ -368,24 +431,39 @@ public:
 class If : public Statement {
     Expression *_expr;
     Statement *_thenStmt, *_elseStmt;
+    unsigned _probe;
 
 public:
     If(Expression *expr, Statement *thenStmt, Statement *elseStmt);
     virtual void allocate(int &offset) const;
     virtual void generate();
+    virtual void build();
 };
 
 
-/* A function definition: id() { body } */
+/* A function definition: id() { body }.  When optimizing, its flow
+   graph is kept until the end of the translation unit.  For profiling,
+   the function has a counter for its entry, one for each call, and two
+   each for every if and while statement, which are numbered in the
+   order in which they are parsed.  The checksum summarizes these so
+   that a stale profile can be detected. */
 
 class Function : public Node {
     const Symbol *_id;
     Block *_body;
+    Graph *_graph;
+    unsigned _probes;
+    unsigned long _checksum;
 
 public:
     Function(const Symbol *id, Block *body);
+    const Symbol *id() const;
+    Graph *flowGraph() const;
+    unsigned probes() const;
+    unsigned long checksum() const;
     virtual void allocate(int &offset) const;
     virtual void generate();
+    virtual void build();
 };
 
 void load(Expression *expr, Register *reg);
@@ -17,14 +17,49 @@
  *		- predicate functions such as isArray()
  *		- stream operator
  *		- the error type
+ *		- packing into eight bytes
+ *
+ *		The specifier is stored as its position in the table of
+ *		specifiers, which is also the order of the table of sizes
+ *		in allocator.cpp.  Each distinct array length is stored
+ *		once, so two array types have the same length exactly when
+ *		they have the same index.  The parameter lists are stored
+ *		as created, with the unspecified list always first.
  */
 
+# include <map>
 # include <cassert>
 # include "tokens.h"
 # include "Type.h"
 
 using namespace std;
 
+static const int specifiers[] = {0, CHAR, INT, LONG};
+static const unsigned numSpecifiers = sizeof(specifiers) / sizeof(specifiers[0]);
+
+static vector<unsigned long> lengths;
+static map<unsigned long, unsigned> indices;
+static vector<Parameters *> lists(1, nullptr);
+
+
+/*
+ * Function:	encode (private)
+ *
+ * Description:	Return the position of a specifier in the table.
+ */
+
+static unsigned encode(int specifier)
+{
+    unsigned i = 0;
+
+
+    while (i < numSpecifiers && specifiers[i] != specifier)
+	i ++;
+
+    assert(i < numSpecifiers);
+    return i;
+}
+
 
 /*
  * Function:	Type::Type (constructor)
@@ -33,7 +68,7 @@ using namespace std;
  */
 
 Type::Type()
-    : _kind(ERROR)
+    : _kind(ERROR), _specifier(0), _indirection(0), _index(0)
 {
 }
 
@@ -45,7 +80,8 @@ Type::Type()
  */
 
 Type::Type(int specifier, unsigned indirection)
-    : _specifier(specifier), _indirection(indirection), _kind(SCALAR)
+    : _kind(SCALAR), _specifier(encode(specifier)), _indirection(indirection),
+      _index(0)
 {
 }
 
@@ -57,9 +93,19 @@ Type::Type(int specifier, unsigned indirection)
  */
 
 Type::Type(int specifier, unsigned indirection, unsigned long length)
-    : _specifier(specifier), _indirection(indirection), _length(length)
+    : _specifier(encode(specifier)), _indirection(indirection)
 {
+    map<unsigned long, unsigned>::iterator it = indices.find(length);
+
+
     _kind = ARRAY;
+
+    if (it != indices.end())
+	_index = it->second;
+    else {
+	_index = indices[length] = lengths.size();
+	lengths.push_back(length);
+    }
 }
 
 
@@ -70,9 +116,14 @@ Type::Type(int specifier, unsigned indirection, unsigned long length)
  */
 
 Type::Type(int specifier, unsigned indirection, Parameters *parameters)
-    : _specifier(specifier), _indirection(indirection), _parameters(parameters)
+    : _specifier(encode(specifier)), _indirection(indirection), _index(0)
 {
     _kind = FUNCTION;
+
+    if (parameters != nullptr) {
+	_index = lists.size();
+	lists.push_back(parameters);
+    }
 }
 
 
@@ -102,12 +153,12 @@ bool Type::operator ==(const Type &rhs) const
 	return true;
 
     if (_kind == ARRAY)
-	return _length == rhs._length;
+	return _index == rhs._index;
 
-    if (!_parameters || !rhs._parameters)
+    if (!lists[_index] || !lists[rhs._index])
 	return true;
 
-    return *_parameters == *rhs._parameters;
+    return *lists[_index] == *lists[rhs._index];
 }
 
 
@@ -181,7 +232,7 @@ bool Type::isError() const
 
 int Type::specifier() const
 {
-    return _specifier;
+    return specifiers[_specifier];
 }
 
 
@@ -208,7 +259,7 @@ unsigned Type::indirection() const
 unsigned long Type::length() const
 {
     assert(_kind == ARRAY);
-    return _length;
+    return lengths[_index];
 }
 
 
@@ -222,7 +273,7 @@ unsigned long Type::length() const
 Parameters *Type::parameters() const
 {
     assert(_kind == FUNCTION);
-    return _parameters;
+    return lists[_index];
 }
 
 
@@ -288,11 +339,11 @@ bool Type::isCompatibleWith(const Type &that) const
 
 Type Type::promote() const
 {
-    if (_kind == SCALAR && _indirection == 0 && _specifier == CHAR)
+    if (_kind == SCALAR && _indirection == 0 && specifier() == CHAR)
 	return Type(INT, 0);
 
     if (_kind == ARRAY)
-	return Type(_specifier, _indirection + 1);
+	return Type(specifier(), _indirection + 1);
 
     return *this;
 }
@@ -308,7 +359,7 @@ Type Type::promote() const
 Type Type::deref() const
 {
     assert(_kind == SCALAR && _indirection > 0);
-    return Type(_specifier, _indirection - 1);
+    return Type(specifier(), _indirection - 1);
 }
 
 
@@ -341,3 +392,21 @@ ostream &operator <<(ostream &ostr, const Type &type)
 
     return ostr;
 }
+
+
+/*
+ * Function:	Type::tables
+ *
+ * Description:	Return the number of array lengths and parameter lists in
+ *		the tables, and set the number of bytes that the tables
+ *		take.  Each entry of the index of the lengths is held in a
+ *		node of a red-black tree, with a color and three links.
+ */
+
+unsigned long Type::tables(unsigned long &bytes)
+{
+    bytes = lengths.capacity() * sizeof(unsigned long);
+    bytes += indices.size() * (sizeof(map<unsigned long, unsigned>::value_type) + 4 * sizeof(void *));
+    bytes += lists.capacity() * sizeof(Parameters *);
+    return lengths.size() + lists.size() - 1;
+}
@@ -20,6 +20,12 @@
  *		As we've designed them, types are essentially immutable,
  *		since we haven't included any mutators.  In practice, we'll
  *		be creating new types rather than changing existing types.
+ *
+ *		Since a type is copied into every expression and symbol, it
+ *		is packed into eight bytes: the kind, specifier, and
+ *		indirection share a word, and the length of an array or the
+ *		parameters of a function are kept in a table, with the type
+ *		holding only the index of its entry.
  */
 
 # ifndef TYPE_H
@@ -30,12 +36,12 @@
 typedef std::vector<class Type> Parameters;
 
 class Type {
-    int _specifier;
-    unsigned _indirection;
-    unsigned long _length;
-    Parameters *_parameters;
+    enum { ARRAY, ERROR, FUNCTION, SCALAR };
 
-    enum { ARRAY, ERROR, FUNCTION, SCALAR } _kind;
+    unsigned _kind : 2;
+    unsigned _specifier : 2;
+    unsigned _indirection : 28;
+    unsigned _index;
 
 public:
     Type();
@@ -55,6 +61,7 @@ public:
     unsigned indirection() const;
     unsigned long length() const;
     Parameters *parameters() const;
+    static unsigned long tables(unsigned long &bytes);
 
     bool isPointer() const;
     bool isNumeric() const;
@@ -14,12 +14,21 @@
 # include <iostream>
 # include "checker.h"
 # include "machine.h"
+# include "statistics.h"
 # include "tokens.h"
 # include "Tree.h"
 
 using namespace std;
 
 
+/* The size of each specifier on the target, in the order of the table
+   in Type.cpp, with the error type first. */
+
+static const unsigned sizes[] = {
+    0, SIZEOF_CHAR, SIZEOF_INT, SIZEOF_LONG
+};
+
+
 /*
  * Function:	Type::size
  *
@@ -32,21 +41,8 @@ unsigned Type::size() const
 
 
     assert(_kind != FUNCTION && _kind != ERROR);
-    count = (_kind == ARRAY ? _length : 1);
-
-    if (_indirection > 0)
-	return count * SIZEOF_PTR;
-
-    if (_specifier == LONG)
-	return count * SIZEOF_LONG;
-
-    if (_specifier == INT)
-	return count * SIZEOF_INT;
-
-    if (_specifier == CHAR)
-	return count * SIZEOF_CHAR;
-
-    return 0;
+    count = (_kind == ARRAY ? length() : 1);
+    return count * (_indirection > 0 ? SIZEOF_PTR : sizes[_specifier]);
 }
 
 
@@ -137,7 +133,11 @@ void Function::allocate(int &offset) const
     Parameters *params;
     Symbols symbols;
     int paramOffset;
+    Instant start;
+
 
+    if (timeReport || timeTrace)
+	start = now();
 
     params = _id->type().parameters();
     symbols = _body->declarations()->symbols();
@@ -149,4 +149,10 @@ void Function::allocate(int &offset) const
     }
 
     _body->allocate(offset);
+
+    if (timeReport)
+	charge(ALLOCATING, start);
+
+    if (timeTrace)
+	trace("allocate", start, _id->name());
 }
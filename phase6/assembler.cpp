@@ -0,0 +1,2045 @@
+/*
+ * File:	assembler.cpp
+ *
+ * Description:	This file contains the public and private function and
+ *		variable definitions for the assembler for Simple C.
+ *
+ *		Each line written by the generator is parsed into an
+ *		instruction consisting of a mnemonic and its operands in
+ *		AT&T syntax, which is then encoded directly into the bytes
+ *		of the current section.  All branches and calls use 32-bit
+ *		displacements, so the size of an instruction never depends
+ *		upon the value of a label, and a single pass suffices.
+ *		References that cannot be resolved until the end, such as
+ *		forward branches and the frame size set by the prologue,
+ *		are recorded as fixups and patched afterwards.  Fixups that
+ *		still cannot be resolved become relocations.
+ *
+ *		Extra functionality:
+ *		- multi-byte nops for alignment within code
+ *		- the SSE2 and AVX2 integer vector instructions written
+ *		  for vectorized loops, with the VEX prefix for AVX2
+ *		- common, local common, and absolute symbols
+ *		- line tables and call frame information from the .loc
+ *		  and .cfi directives written with -g
+ */
+
+# include <cctype>
+# include <cstdlib>
+# include <cstring>
+# include <iostream>
+# include <sstream>
+# include "assembler.h"
+
+using namespace std;
+
+
+/* An operand is a register, an immediate, or a memory reference.  A
+   memory reference without a base or index register is either an
+   absolute address or the target of a branch or call. */
+
+enum { REG, IMM, MEM };
+
+# define NONE	-1
+# define RIP	16
+
+struct Operand {
+    int kind;
+    int reg, size;
+    long value;
+    string symbol;
+    int base, index, scale;
+    bool indirect;
+};
+
+struct Instruction {
+    string mnemonic;
+    vector<Operand> operands;
+};
+
+
+/* A reference that must be patched once all symbols are known. */
+
+struct Fixup {
+    int section;
+    unsigned long offset;
+    int type;
+    string symbol;
+    long addend;
+};
+
+/* A row of the line table, mapping an offset in a section to a line
+   of a source file. */
+
+struct Row {
+    int section;
+    unsigned long offset;
+    unsigned file, line;
+};
+
+
+/* A rule of the call frame information, which takes effect at the
+   given offset, and the rules of a function between its .cfi_startproc
+   and .cfi_endproc. */
+
+struct Rule {
+    unsigned long offset;
+    int opcode, reg;
+    long value;
+};
+
+struct Frame {
+    int section;
+    unsigned long start, end;
+    vector<Rule> rules;
+    bool open;
+};
+
+static Object *object;
+static int current;
+static vector<Fixup> fixups;
+static vector<string> locals;
+static string line;
+
+static vector<string> files;
+static vector<Row> rows;
+static vector<Frame> frames;
+static unsigned numLabels;
+
+
+/* The register names for each access size, indexed by register number. */
+
+static const char *qwords[] = {
+    "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+    "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+};
+
+static const char *lwords[] = {
+    "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi",
+    "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d",
+};
+
+static const char *words[] = {
+    "ax", "cx", "dx", "bx", "sp", "bp", "si", "di",
+    "r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w",
+};
+
+static const char *bytes[] = {
+    "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil",
+    "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b",
+};
+
+
+/* The condition codes, along with their many synonyms. */
+
+static struct {
+    string name;
+    int code;
+} conditions[] = {
+    {"o", 0x0}, {"no", 0x1}, {"b", 0x2}, {"c", 0x2}, {"nae", 0x2},
+    {"ae", 0x3}, {"nb", 0x3}, {"nc", 0x3}, {"e", 0x4}, {"z", 0x4},
+    {"ne", 0x5}, {"nz", 0x5}, {"be", 0x6}, {"na", 0x6}, {"a", 0x7},
+    {"nbe", 0x7}, {"s", 0x8}, {"ns", 0x9}, {"p", 0xa}, {"pe", 0xa},
+    {"np", 0xb}, {"po", 0xb}, {"l", 0xc}, {"nge", 0xc}, {"ge", 0xd},
+    {"nl", 0xd}, {"le", 0xe}, {"ng", 0xe}, {"g", 0xf}, {"nle", 0xf},
+};
+
+# define numConditions (sizeof(conditions) / sizeof(conditions[0]))
+
+
+/* The DWARF register numbers, indexed by register number. */
+
+static const int dwarf[] = {
+    0, 2, 1, 3, 7, 6, 4, 5, 8, 9, 10, 11, 12, 13, 14, 15,
+};
+
+# define DW_RETURN_ADDRESS 16
+# define DW_DATA_ALIGNMENT -8
+
+
+/* The call frame instructions we write, and the line number opcodes. */
+
+enum {
+    DW_CFA_advance_loc1 = 0x02, DW_CFA_advance_loc2 = 0x03,
+    DW_CFA_advance_loc4 = 0x04, DW_CFA_remember_state = 0x0a,
+    DW_CFA_restore_state = 0x0b, DW_CFA_def_cfa = 0x0c,
+    DW_CFA_def_cfa_register = 0x0d, DW_CFA_def_cfa_offset = 0x0e,
+    DW_CFA_advance_loc = 0x40, DW_CFA_offset = 0x80,
+};
+
+enum {
+    DW_LNS_copy = 0x01, DW_LNS_advance_pc = 0x02, DW_LNS_advance_line = 0x03,
+    DW_LNS_set_file = 0x04, DW_LNE_end_sequence = 0x01,
+    DW_LNE_set_address = 0x02,
+};
+
+
+/* The vector instructions, with their mandatory prefix, the escape
+   bytes that follow 0x0f, and the opcode.  The same table gives the
+   AVX encodings, whose mnemonics begin with a v. */
+
+static struct {
+    string name;
+    int prefix, escape, opcode;
+} vectors[] = {
+    {"movdqa", 0x66, 0, 0x6f}, {"movdqu", 0xf3, 0, 0x6f},
+    {"movd", 0x66, 0, 0x6e}, {"pshufd", 0x66, 0, 0x70},
+    {"paddd", 0x66, 0, 0xfe}, {"paddq", 0x66, 0, 0xd4},
+    {"psubd", 0x66, 0, 0xfa}, {"psubq", 0x66, 0, 0xfb},
+    {"pmuludq", 0x66, 0, 0xf4}, {"pmulld", 0x66, 0x38, 0x40},
+    {"punpckldq", 0x66, 0, 0x62}, {"punpcklqdq", 0x66, 0, 0x6c},
+    {"pbroadcastd", 0x66, 0x38, 0x58}, {"pbroadcastq", 0x66, 0x38, 0x59},
+};
+
+# define numVectors (sizeof(vectors) / sizeof(vectors[0]))
+
+
+/* The arithmetic instructions sharing the same encoding pattern, with
+   the value of the opcode extension in the ModR/M byte. */
+
+static struct {
+    string name;
+    int digit;
+} arithmetic[] = {
+    {"add", 0}, {"or", 1}, {"adc", 2}, {"sbb", 3},
+    {"and", 4}, {"sub", 5}, {"xor", 6}, {"cmp", 7},
+}, shifts[] = {
+    {"rol", 0}, {"ror", 1}, {"shl", 4}, {"sal", 4}, {"shr", 5}, {"sar", 7},
+}, unaries[] = {
+    {"not", 2}, {"neg", 3}, {"mul", 4}, {"div", 6}, {"idiv", 7},
+};
+
+
+/*
+ * Function:	error (private)
+ *
+ * Description:	Report an instruction or directive we cannot handle and
+ *		terminate, since the generator should never produce one.
+ */
+
+static void error(const string &msg)
+{
+    cerr << "scc: assembler: " << msg << ": " << line << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	Object::section
+ *
+ * Description:	Return the index of the section with the given name,
+ *		creating it if necessary.  The attributes of the standard
+ *		sections are inferred from their names.
+ */
+
+int Object::section(const string &name)
+{
+    Section s;
+
+
+    for (unsigned i = 0; i < sections.size(); i ++)
+	if (sections[i].name == name)
+	    return i;
+
+    s.name = name;
+    s.size = 0;
+    s.align = 1;
+    s.exec = name == ".text";
+    s.write = name == ".data" || name == ".bss";
+    s.nobits = name == ".bss";
+    s.debug = name.compare(0, 7, ".debug_") == 0;
+    sections.push_back(s);
+    return sections.size() - 1;
+}
+
+
+/*
+ * Function:	Object::symbol
+ *
+ * Description:	Return the symbol with the given name, creating it as an
+ *		undefined symbol if necessary.
+ */
+
+ObjectSymbol &Object::symbol(const string &name)
+{
+    ObjectSymbol s;
+
+
+    if (table.count(name) == 0) {
+	s.name = name;
+	s.section = SYM_UNDEFINED;
+	s.value = s.size = 0;
+	s.global = s.function = false;
+	table[name] = symbols.size();
+	symbols.push_back(s);
+    }
+
+    return symbols[table[name]];
+}
+
+
+/*
+ * Function:	Object::defined
+ *
+ * Description:	Return whether the given symbol is defined.
+ */
+
+bool Object::defined(const string &name) const
+{
+    map<string, unsigned>::const_iterator it = table.find(name);
+    return it != table.end() && symbols[it->second].section != SYM_UNDEFINED;
+}
+
+
+/*
+ * Function:	emit (private)
+ *
+ * Description:	Append a value of the given number of bytes to the
+ *		current section in little-endian order.
+ */
+
+static void emit(unsigned long value, unsigned size = 1)
+{
+    Section &s = object->sections[current];
+
+    for (unsigned i = 0; i < size; i ++)
+	s.bytes.push_back((value >> (8 * i)) & 0xff);
+
+    s.size = s.bytes.size();
+}
+
+
+/*
+ * Function:	here (private)
+ *
+ * Description:	Return the current offset in the current section.
+ */
+
+static unsigned long here()
+{
+    return object->sections[current].size;
+}
+
+
+/*
+ * Function:	fixup (private)
+ *
+ * Description:	Record a reference to a symbol at the given offset of the
+ *		current section, and emit a placeholder of the right size.
+ */
+
+static void fixup(int type, const string &symbol, long addend)
+{
+    Fixup f;
+
+    f.section = current;
+    f.offset = here();
+    f.type = type;
+    f.symbol = symbol;
+    f.addend = addend;
+    fixups.push_back(f);
+
+    emit(0, type == RELOC_64 ? 8 : 4);
+}
+
+
+/*
+ * Function:	leb128 (private)
+ *
+ * Description:	Emit a value in the variable-length encoding used by
+ *		DWARF, either signed or unsigned.
+ */
+
+static void leb128(long value, bool sign = false)
+{
+    unsigned char byte;
+    bool more;
+
+
+    do {
+	byte = value & 0x7f;
+	value = sign ? value >> 7 : (long) ((unsigned long) value >> 7);
+
+	if (sign)
+	    more = !(value == 0 && !(byte & 0x40)) && !(value == -1 && (byte & 0x40));
+	else
+	    more = value != 0;
+
+	emit(more ? byte | 0x80 : byte);
+    } while (more);
+}
+
+
+/*
+ * Function:	patch (private)
+ *
+ * Description:	Overwrite a value of the given size already emitted at
+ *		the given offset of the current section, such as the
+ *		length of a table once the table is complete.
+ */
+
+static void patch(unsigned long offset, unsigned long value, unsigned size)
+{
+    Section &s = object->sections[current];
+
+    for (unsigned i = 0; i < size; i ++)
+	s.bytes[offset + i] = (value >> (8 * i)) & 0xff;
+}
+
+
+/*
+ * Function:	label (private)
+ *
+ * Description:	Define a new local label at the given offset of the
+ *		given section and return its name.
+ */
+
+static string label(int section, unsigned long offset)
+{
+    stringstream ss;
+
+
+    ss << ".Ldebug" << numLabels ++;
+    ObjectSymbol &symbol = object->symbol(ss.str());
+    symbol.section = section;
+    symbol.value = offset;
+    return ss.str();
+}
+
+
+/*
+ * Function:	trim (private)
+ *
+ * Description:	Remove any leading and trailing whitespace.
+ */
+
+static string trim(const string &s)
+{
+    size_t first = s.find_first_not_of(" \t");
+    size_t last = s.find_last_not_of(" \t\r");
+
+    if (first == string::npos)
+	return "";
+
+    return s.substr(first, last - first + 1);
+}
+
+
+/*
+ * Function:	split (private)
+ *
+ * Description:	Split a list of operands or arguments at the commas that
+ *		are not within parentheses or quotes.
+ */
+
+static vector<string> split(const string &s)
+{
+    vector<string> fields;
+    bool quoted = false;
+    int depth = 0;
+    string field;
+
+
+    for (unsigned i = 0; i < s.size(); i ++) {
+	if (s[i] == '"' && (i == 0 || s[i - 1] != '\\'))
+	    quoted = !quoted;
+	else if (!quoted && s[i] == '(')
+	    depth ++;
+	else if (!quoted && s[i] == ')')
+	    depth --;
+
+	if (s[i] == ',' && !quoted && depth == 0) {
+	    fields.push_back(trim(field));
+	    field.clear();
+	} else
+	    field += s[i];
+    }
+
+    if (!trim(field).empty() || !fields.empty())
+	fields.push_back(trim(field));
+
+    return fields;
+}
+
+
+/*
+ * Function:	expression (private)
+ *
+ * Description:	Parse a simple expression, which is an optional symbol
+ *		followed by an optional signed integer offset.  A symbol
+ *		already set to an absolute value is replaced by its value.
+ */
+
+static void expression(const string &s, long &value, string &symbol)
+{
+    unsigned i = 0;
+    char *end;
+
+
+    value = 0;
+    symbol.clear();
+
+    if (i < s.size() && (isalpha(s[i]) || s[i] == '_' || s[i] == '.')) {
+	while (i < s.size() && (isalnum(s[i]) || strchr("_.$", s[i])))
+	    symbol += s[i ++];
+
+	if (i < s.size() && s[i] != '+' && s[i] != '-')
+	    error("invalid expression");
+    }
+
+    if (i < s.size()) {
+	value = strtol(s.c_str() + i, &end, 0);
+
+	if (*end != '\0')
+	    error("invalid expression");
+    }
+
+    if (object->defined(symbol) && object->symbol(symbol).section == SYM_ABSOLUTE) {
+	value += object->symbol(symbol).value;
+	symbol.clear();
+    }
+}
+
+
+/*
+ * Function:	registerNumber (private)
+ *
+ * Description:	Look up a register by name, returning its number and
+ *		access size, or false if there is no such register.  The
+ *		vector registers have a size of 16 or 32 bytes.
+ */
+
+static bool registerNumber(const string &name, int &reg, int &size)
+{
+    for (reg = 0; reg < 16; reg ++) {
+	size = 8;
+	if (name == qwords[reg])
+	    return true;
+
+	size = 4;
+	if (name == lwords[reg])
+	    return true;
+
+	size = 2;
+	if (name == words[reg])
+	    return true;
+
+	size = 1;
+	if (name == bytes[reg])
+	    return true;
+    }
+
+    if (name.size() > 3 && (name.compare(0, 3, "xmm") == 0 ||
+		name.compare(0, 3, "ymm") == 0) && isdigit(name[3])) {
+	reg = atoi(name.c_str() + 3);
+	size = name[0] == 'x' ? 16 : 32;
+	return reg < 16;
+    }
+
+    return false;
+}
+
+
+/*
+ * Function:	operand (private)
+ *
+ * Description:	Parse a single operand in AT&T syntax.
+ */
+
+static Operand operand(string s)
+{
+    Operand op;
+    size_t paren;
+
+
+    op.reg = op.base = op.index = NONE;
+    op.size = op.value = op.scale = 0;
+    op.indirect = false;
+
+    if (!s.empty() && s[0] == '*') {
+	op.indirect = true;
+	s = s.substr(1);
+    }
+
+    if (!s.empty() && s[0] == '%') {
+	op.kind = REG;
+
+	if (!registerNumber(s.substr(1), op.reg, op.size))
+	    error("unknown register");
+
+    } else if (!s.empty() && s[0] == '$') {
+	op.kind = IMM;
+	expression(s.substr(1), op.value, op.symbol);
+
+    } else {
+	op.kind = MEM;
+	paren = s.find('(');
+	expression(trim(s.substr(0, paren)), op.value, op.symbol);
+
+	if (paren != string::npos) {
+	    string inside = s.substr(paren + 1, s.rfind(')') - paren - 1);
+	    vector<string> parts = split(inside);
+	    int size;
+
+	    if (parts.size() > 0 && !parts[0].empty()) {
+		if (parts[0] == "%rip")
+		    op.base = RIP;
+		else if (parts[0][0] != '%' ||
+			!registerNumber(parts[0].substr(1), op.base, size))
+		    error("invalid base register");
+	    }
+
+	    if (parts.size() > 1) {
+		if (parts[1][0] != '%' ||
+			!registerNumber(parts[1].substr(1), op.index, size))
+		    error("invalid index register");
+
+		op.scale = parts.size() > 2 ? atoi(parts[2].c_str()) : 1;
+	    }
+	}
+    }
+
+    return op;
+}
+
+
+/*
+ * Function:	condition (private)
+ *
+ * Description:	Return the encoding of a condition code, or -1 if the
+ *		string is not a condition code.
+ */
+
+static int condition(const string &s)
+{
+    for (unsigned i = 0; i < numConditions; i ++)
+	if (conditions[i].name == s)
+	    return conditions[i].code;
+
+    return -1;
+}
+
+
+/*
+ * Function:	fitsByte (private)
+ *
+ * Description:	Return whether an operand is an immediate that fits in a
+ *		signed byte.
+ */
+
+static bool fitsByte(const Operand &op)
+{
+    return op.symbol.empty() && op.value >= -128 && op.value <= 127;
+}
+
+
+/*
+ * Function:	fitsLong (private)
+ *
+ * Description:	Return whether an immediate fits in a signed 32-bit word.
+ */
+
+static bool fitsLong(const Operand &op)
+{
+    return !op.symbol.empty() || (op.value >= -2147483648L &&
+	    op.value <= 2147483647L);
+}
+
+
+/*
+ * Function:	needsRex (private)
+ *
+ * Description:	Return whether a byte register requires a REX prefix to be
+ *		accessible (%spl, %bpl, %sil, %dil, and %r8b and above).
+ */
+
+static bool needsRex(int reg, int size)
+{
+    return size == 1 && reg >= 4;
+}
+
+
+/*
+ * Function:	immediate (private)
+ *
+ * Description:	Emit an immediate operand of the given size for an operand
+ *		of the given width.  An immediate narrower than its operand
+ *		is sign extended, so its value must fit as a signed value,
+ *		and otherwise it may also fit as an unsigned one.  A value
+ *		that does not fit is an error, rather than being silently
+ *		truncated.
+ */
+
+static void immediate(const Operand &imm, unsigned size, unsigned width)
+{
+    long low, high;
+
+
+    if (!imm.symbol.empty()) {
+	if (size != 4)
+	    error("symbolic immediate must be 32 bits");
+
+	fixup(RELOC_32S, imm.symbol, imm.value);
+	return;
+    }
+
+    if (size < 8) {
+	low = -(1L << (size * 8 - 1));
+	high = width > size ? -low : 2 * -low;
+
+	if (imm.value < low || imm.value >= high)
+	    error("immediate out of range");
+    }
+
+    emit(imm.value, size);
+}
+
+
+/*
+ * Function:	modrm (private)
+ *
+ * Description:	Emit the ModR/M byte of an instruction, along with any SIB
+ *		byte, displacement, and immediate.  REG is either a register
+ *		number or an opcode extension, and RM is the register or
+ *		memory operand.  An optional immediate of IMMSIZE bytes
+ *		for an operand of WIDTH bytes follows.
+ */
+
+static void modrm(int reg, const Operand &rm, const Operand *imm,
+	unsigned immSize, unsigned width)
+{
+    int mod, base;
+    unsigned long disp = 0, reference = 0;
+    bool ripRelative = false;
+
+
+    reg &= 7;
+
+    if (rm.kind == REG) {
+	emit(0xc0 | reg << 3 | (rm.reg & 7));
+
+    } else if (rm.base == RIP) {
+	emit(0x05 | reg << 3);
+	disp = here();
+	reference = fixups.size();
+	ripRelative = true;
+
+	if (!rm.symbol.empty())
+	    fixup(RELOC_PC32, rm.symbol, rm.value);
+	else
+	    emit(rm.value, 4);
+
+    } else if (rm.base == NONE) {
+	int index = rm.index == NONE ? 4 : rm.index & 7;
+	int scale = rm.scale == 8 ? 3 : rm.scale == 4 ? 2 : rm.scale == 2;
+
+	emit(0x04 | reg << 3);
+	emit(scale << 6 | index << 3 | 5);
+
+	if (!rm.symbol.empty())
+	    fixup(RELOC_32S, rm.symbol, rm.value);
+	else
+	    emit(rm.value, 4);
+
+    } else {
+	base = rm.base & 7;
+
+	if (!rm.symbol.empty())
+	    mod = 2;
+	else if (rm.value == 0 && base != 5)
+	    mod = 0;
+	else if (rm.value >= -128 && rm.value <= 127)
+	    mod = 1;
+	else
+	    mod = 2;
+
+	if (rm.index != NONE) {
+	    int scale = rm.scale == 8 ? 3 : rm.scale == 4 ? 2 : rm.scale == 2;
+
+	    emit(mod << 6 | reg << 3 | 4);
+	    emit(scale << 6 | (rm.index & 7) << 3 | base);
+
+	} else if (base == 4) {
+	    emit(mod << 6 | reg << 3 | 4);
+	    emit(0x24);
+
+	} else
+	    emit(mod << 6 | reg << 3 | base);
+
+	if (!rm.symbol.empty())
+	    fixup(RELOC_32S, rm.symbol, rm.value);
+	else if (mod == 1)
+	    emit(rm.value, 1);
+	else if (mod == 2)
+	    emit(rm.value, 4);
+    }
+
+    if (imm != nullptr)
+	immediate(*imm, immSize, width);
+
+
+    /* A RIP-relative displacement is relative to the end of the
+       instruction, which is only now known. */
+
+    if (ripRelative) {
+	long adjust = here() - disp;
+	Section &s = object->sections[current];
+
+	if (!rm.symbol.empty())
+	    fixups[reference].addend -= adjust;
+	else
+	    for (unsigned i = 0; i < 4; i ++)
+		s.bytes[disp + i] = ((rm.value - adjust) >> (8 * i)) & 0xff;
+    }
+}
+
+
+/*
+ * Function:	encode (private)
+ *
+ * Description:	Emit an instruction with a ModR/M byte.  REG is either a
+ *		register number or an opcode extension, with REGSIZE being
+ *		the access size of that register or zero for an extension.
+ *		RM is the register or memory operand.  SIZE is the operand
+ *		size, which determines the prefixes.  An optional
+ *		immediate of IMMSIZE bytes follows.
+ */
+
+static void encode(unsigned size, const vector<int> &opcode, int reg,
+	int regSize, const Operand &rm, const Operand *imm = nullptr,
+	unsigned immSize = 0)
+{
+    int rex = 0;
+
+
+    if (size == 2)
+	emit(0x66);
+
+    if (size == 8)
+	rex |= 0x08;
+
+    if (reg >= 8)
+	rex |= 0x04;
+
+    if (needsRex(reg, regSize))
+	rex |= 0x40;
+
+    if (rm.kind == REG) {
+	if (rm.reg >= 8)
+	    rex |= 0x01;
+
+	if (needsRex(rm.reg, rm.size))
+	    rex |= 0x40;
+
+    } else {
+	if (rm.base != NONE && rm.base != RIP && rm.base >= 8)
+	    rex |= 0x01;
+
+	if (rm.index >= 8)
+	    rex |= 0x02;
+    }
+
+    if (rex != 0)
+	emit(0x40 | rex);
+
+    for (unsigned i = 0; i < opcode.size(); i ++)
+	emit(opcode[i]);
+
+    modrm(reg, rm, imm, immSize, size);
+}
+
+
+/*
+ * Function:	vex (private)
+ *
+ * Description:	Emit an instruction with a VEX prefix, which replaces the
+ *		REX prefix, the mandatory prefix, and the escape bytes.
+ *		VVVV is the extra source register, or zero if none.  The
+ *		two-byte form is used when it suffices.
+ */
+
+static void vex(int prefix, int escape, int opcode, bool wide, bool longer,
+	int reg, int vvvv, const Operand &rm, const Operand *imm = nullptr)
+{
+    int r, x = 0, b = 0, pp, mmmmm;
+
+
+    r = reg >= 8;
+
+    if (rm.kind == REG)
+	b = rm.reg >= 8;
+    else {
+	b = rm.base != NONE && rm.base != RIP && rm.base >= 8;
+	x = rm.index >= 8;
+    }
+
+    pp = prefix == 0x66 ? 1 : prefix == 0xf3 ? 2 : prefix == 0xf2 ? 3 : 0;
+    mmmmm = escape == 0x38 ? 2 : escape == 0x3a ? 3 : 1;
+
+    if (x == 0 && b == 0 && !wide && mmmmm == 1) {
+	emit(0xc5);
+	emit(!r << 7 | (~vvvv & 15) << 3 | longer << 2 | pp);
+
+    } else {
+	emit(0xc4);
+	emit(!r << 7 | !x << 6 | !b << 5 | mmmmm);
+	emit(wide << 7 | (~vvvv & 15) << 3 | longer << 2 | pp);
+    }
+
+    emit(opcode);
+    modrm(reg, rm, imm, imm != nullptr ? 1 : 0, 1);
+}
+
+
+/*
+ * Function:	branch (private)
+ *
+ * Description:	Emit the 32-bit displacement of a branch or call to a
+ *		label or symbol.
+ */
+
+static void branch(const Operand &target, int type)
+{
+    if (target.kind != MEM || target.base != NONE || target.symbol.empty())
+	error("invalid branch target");
+
+    fixup(type, target.symbol, target.value - 4);
+}
+
+
+/*
+ * Function:	operandSize (private)
+ *
+ * Description:	Determine the operand size of an instruction from its
+ *		suffix or, if it has none, from its register operands.
+ */
+
+static unsigned operandSize(const Instruction &insn, unsigned suffix)
+{
+    if (suffix != 0)
+	return suffix;
+
+    for (unsigned i = insn.operands.size(); i > 0; i --)
+	if (insn.operands[i - 1].kind == REG)
+	    return insn.operands[i - 1].size;
+
+    error("operand size is ambiguous");
+    return 0;
+}
+
+
+/*
+ * Function:	lookup (private)
+ *
+ * Description:	Return the opcode extension of a mnemonic in a table, or
+ *		-1 if it is not present.
+ */
+
+template<class T, unsigned N>
+static int lookup(const T (&table)[N], const string &name)
+{
+    for (unsigned i = 0; i < N; i ++)
+	if (table[i].name == name)
+	    return table[i].digit;
+
+    return -1;
+}
+
+
+/*
+ * Function:	simd (private)
+ *
+ * Description:	Encode a vector instruction, returning false if the
+ *		instruction is not one.  The destination is the register
+ *		field, except for a move to memory, which uses the opcode
+ *		for the other direction.  A movq to a vector register is a
+ *		movd with the REX.W or VEX.W bit.
+ */
+
+static bool simd(const Instruction &insn)
+{
+    const vector<Operand> &ops = insn.operands;
+    string m = insn.mnemonic;
+    unsigned n = ops.size(), first, i;
+    bool avx = false, wide = false, longer = false;
+    int opcode, reg, vvvv = 0;
+    const Operand *imm, *rm;
+
+
+    for (i = 0; i < n; i ++)
+	if (ops[i].kind == REG && ops[i].size >= 16) {
+	    longer = longer || ops[i].size == 32;
+
+	    if (m == "movq" || m == "vmovq") {
+		m[m.size() - 1] = 'd';
+		wide = true;
+	    }
+	}
+
+    if (m[0] == 'v' && m != "vmovd") {
+	m = m.substr(1);
+	avx = true;
+
+    } else if (m == "vmovd") {
+	m = "movd";
+	avx = true;
+    }
+
+    for (i = 0; i < numVectors; i ++)
+	if (vectors[i].name == m)
+	    break;
+
+    if (i == numVectors || n < 2)
+	return false;
+
+    first = ops[0].kind == IMM;
+    imm = first ? &ops[0] : nullptr;
+    opcode = vectors[i].opcode;
+
+    if (ops[n - 1].kind == MEM) {
+	opcode |= 0x10;
+	reg = ops[first].reg;
+	rm = &ops[n - 1];
+
+    } else {
+	reg = ops[n - 1].reg;
+	rm = &ops[first];
+    }
+
+    if (avx) {
+	if (n - first == 3)
+	    vvvv = ops[first + 1].reg;
+
+	vex(vectors[i].prefix, vectors[i].escape, opcode, wide, longer,
+		reg, vvvv, *rm, imm);
+
+    } else {
+	emit(vectors[i].prefix);
+
+	if (vectors[i].escape != 0)
+	    encode(wide ? 8 : 0, {0x0f, vectors[i].escape, opcode}, reg, 16, *rm,
+		    imm, imm != nullptr);
+	else
+	    encode(wide ? 8 : 0, {0x0f, opcode}, reg, 16, *rm, imm, imm != nullptr);
+    }
+
+    return true;
+}
+
+
+/*
+ * Function:	instruction (private)
+ *
+ * Description:	Encode a single instruction.
+ */
+
+static void instruction(const Instruction &insn)
+{
+    const string &m = insn.mnemonic;
+    const vector<Operand> &ops = insn.operands;
+    unsigned n = ops.size(), size, suffix = 0;
+    string base = m;
+    int digit, cc;
+
+
+    /* Instructions without operands. */
+
+    if (n == 0) {
+	if (m == "ret" || m == "retq")
+	    emit(0xc3);
+	else if (m == "leave" || m == "leaveq")
+	    emit(0xc9);
+	else if (m == "cltd" || m == "cdq")
+	    emit(0x99);
+	else if (m == "cqto" || m == "cqo")
+	    emit(0x48), emit(0x99);
+	else if (m == "cltq" || m == "cdqe")
+	    emit(0x48), emit(0x98);
+	else if (m == "cwtl")
+	    emit(0x98);
+	else if (m == "nop")
+	    emit(0x90);
+	else if (m == "ud2")
+	    emit(0x0f), emit(0x0b);
+	else if (m == "vzeroupper")
+	    emit(0xc5), emit(0xf8), emit(0x77);
+	else
+	    error("unknown instruction");
+
+	return;
+    }
+
+
+    /* Branches and calls. */
+
+    if (m == "jmp" || m == "jmpq" || m == "call" || m == "callq") {
+	bool call = m[0] == 'c';
+
+	if (ops[0].indirect) {
+	    Operand rm = ops[0];
+
+	    if (rm.kind == REG)
+		rm.size = 8;
+
+	    encode(0, {0xff}, call ? 2 : 4, 0, rm);
+
+	} else {
+	    emit(call ? 0xe8 : 0xe9);
+	    branch(ops[0], RELOC_PLT32);
+	}
+
+	return;
+    }
+
+    if (m[0] == 'j' && (cc = condition(m.substr(1))) >= 0) {
+	emit(0x0f);
+	emit(0x80 | cc);
+	branch(ops[0], RELOC_PC32);
+	return;
+    }
+
+    if (m.compare(0, 3, "set") == 0 && (cc = condition(m.substr(3))) >= 0) {
+	encode(0, {0x0f, 0x90 | cc}, 0, 0, ops[0]);
+	return;
+    }
+
+
+    /* Sign and zero extensions, which have two suffixes. */
+
+    if (m.size() == 6 && (m.compare(0, 4, "movs") == 0 ||
+		m.compare(0, 4, "movz") == 0)) {
+	bool sign = m[3] == 's';
+	char from = m[4], to = m[5];
+
+	size = to == 'q' ? 8 : to == 'l' ? 4 : 2;
+
+	if (from == 'b')
+	    encode(size, {0x0f, sign ? 0xbe : 0xb6}, ops[1].reg, size, ops[0]);
+	else if (from == 'w')
+	    encode(size, {0x0f, sign ? 0xbf : 0xb7}, ops[1].reg, size, ops[0]);
+	else if (from == 'l' && sign && to == 'q')
+	    encode(size, {0x63}, ops[1].reg, size, ops[0]);
+	else
+	    error("unknown extension");
+
+	return;
+    }
+
+
+    /* The vector instructions. */
+
+    if (simd(insn))
+	return;
+
+
+    /* Everything else has an optional size suffix. */
+
+    if (lookup(arithmetic, m) < 0 && lookup(shifts, m) < 0 &&
+	    lookup(unaries, m) < 0 && m != "mov" && m != "test" &&
+	    m != "imul" && m != "lea" && m != "push" && m != "pop" &&
+	    m != "inc" && m != "dec") {
+	char c = m[m.size() - 1];
+
+	suffix = c == 'b' ? 1 : c == 'w' ? 2 : c == 'l' ? 4 : c == 'q' ? 8 : 0;
+
+	if (suffix == 0)
+	    error("unknown instruction");
+
+	base = m.substr(0, m.size() - 1);
+    }
+
+    if (base == "push" || base == "pop") {
+	bool push = base == "push";
+
+	if (ops[0].kind == REG) {
+	    if (ops[0].reg >= 8)
+		emit(0x41);
+
+	    emit((push ? 0x50 : 0x58) + (ops[0].reg & 7));
+
+	} else if (ops[0].kind == IMM && push) {
+	    if (fitsByte(ops[0]))
+		emit(0x6a), emit(ops[0].value, 1);
+	    else
+		emit(0x68), immediate(ops[0], 4, 8);
+
+	} else
+	    encode(0, {push ? 0xff : 0x8f}, push ? 6 : 0, 0, ops[0]);
+
+	return;
+    }
+
+    size = operandSize(insn, suffix);
+
+    if (base == "mov" && n == 2) {
+	const Operand &src = ops[0], &dst = ops[1];
+
+	if (src.kind == REG)
+	    encode(size, {size == 1 ? 0x88 : 0x89}, src.reg, size, dst);
+
+	else if (src.kind == MEM)
+	    encode(size, {size == 1 ? 0x8a : 0x8b}, dst.reg, size, src);
+
+	else if (dst.kind == MEM)
+	    encode(size, {size == 1 ? 0xc6 : 0xc7}, 0, 0, dst, &src,
+		    size == 8 ? 4 : size);
+
+	else if (size == 8 && fitsLong(src))
+	    encode(size, {0xc7}, 0, 0, dst, &src, 4);
+
+	else {
+	    int rex = (size == 8 ? 0x08 : 0) | (dst.reg >= 8 ? 0x01 : 0);
+
+	    if (size == 2)
+		emit(0x66);
+
+	    if (rex != 0 || needsRex(dst.reg, size))
+		emit(0x40 | rex);
+
+	    emit((size == 1 ? 0xb0 : 0xb8) + (dst.reg & 7));
+
+	    if (size == 4)
+		immediate(src, 4, 4);
+	    else
+		emit(src.value, size);
+	}
+
+	return;
+    }
+
+    if ((digit = lookup(arithmetic, base)) >= 0 && n == 2) {
+	const Operand &src = ops[0], &dst = ops[1];
+
+	if (src.kind == IMM) {
+	    if (size == 1)
+		encode(size, {0x80}, digit, 0, dst, &src, 1);
+	    else if (fitsByte(src))
+		encode(size, {0x83}, digit, 0, dst, &src, 1);
+	    else
+		encode(size, {0x81}, digit, 0, dst, &src, size == 2 ? 2 : 4);
+
+	} else if (src.kind == REG)
+	    encode(size, {digit << 3 | (size == 1 ? 0 : 1)}, src.reg, size, dst);
+
+	else
+	    encode(size, {digit << 3 | (size == 1 ? 2 : 3)}, dst.reg, size, src);
+
+	return;
+    }
+
+    if (base == "test" && n == 2) {
+	const Operand &src = ops[0], &dst = ops[1];
+
+	if (src.kind == IMM)
+	    encode(size, {size == 1 ? 0xf6 : 0xf7}, 0, 0, dst, &src,
+		    size == 8 ? 4 : size);
+	else if (src.kind == REG)
+	    encode(size, {size == 1 ? 0x84 : 0x85}, src.reg, size, dst);
+	else
+	    encode(size, {size == 1 ? 0x84 : 0x85}, dst.reg, size, src);
+
+	return;
+    }
+
+    if (base == "imul" && n >= 2) {
+	const Operand &dst = ops[n - 1];
+	const Operand &rm = ops[n - 2].kind == IMM ? dst : ops[n - 2];
+
+	if (n == 3 || ops[0].kind == IMM) {
+	    const Operand &src = n == 3 ? ops[1] : dst;
+
+	    if (fitsByte(ops[0]))
+		encode(size, {0x6b}, dst.reg, size, src, &ops[0], 1);
+	    else
+		encode(size, {0x69}, dst.reg, size, src, &ops[0],
+			size == 2 ? 2 : 4);
+	} else
+	    encode(size, {0x0f, 0xaf}, dst.reg, size, rm);
+
+	return;
+    }
+
+    if (((digit = lookup(unaries, base)) >= 0 || base == "imul") && n == 1) {
+	if (base == "imul")
+	    digit = 5;
+
+	encode(size, {size == 1 ? 0xf6 : 0xf7}, digit, 0, ops[0]);
+	return;
+    }
+
+    if ((base == "inc" || base == "dec") && n == 1) {
+	encode(size, {size == 1 ? 0xfe : 0xff}, base == "dec", 0, ops[0]);
+	return;
+    }
+
+    if ((digit = lookup(shifts, base)) >= 0) {
+	const Operand &dst = ops[n - 1];
+
+	if (n == 1 || (ops[0].kind == IMM && ops[0].value == 1))
+	    encode(size, {size == 1 ? 0xd0 : 0xd1}, digit, 0, dst);
+	else if (ops[0].kind == IMM)
+	    encode(size, {size == 1 ? 0xc0 : 0xc1}, digit, 0, dst, &ops[0], 1);
+	else
+	    encode(size, {size == 1 ? 0xd2 : 0xd3}, digit, 0, dst);
+
+	return;
+    }
+
+    if (base == "lea" && n == 2) {
+	encode(size, {0x8d}, ops[1].reg, size, ops[0]);
+	return;
+    }
+
+    error("unknown instruction");
+}
+
+
+/*
+ * Function:	align (private)
+ *
+ * Description:	Align the current section to the given power of two.
+ *		Code is padded with the recommended multi-byte nops so the
+ *		padding costs as few decoded instructions as possible.
+ */
+
+static void align(unsigned long alignment)
+{
+    static const unsigned char nops[][9] = {
+	{0x90},
+	{0x66, 0x90},
+	{0x0f, 0x1f, 0x00},
+	{0x0f, 0x1f, 0x40, 0x00},
+	{0x0f, 0x1f, 0x44, 0x00, 0x00},
+	{0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00},
+	{0x0f, 0x1f, 0x80, 0x00, 0x00, 0x00, 0x00},
+	{0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x66, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    };
+
+    Section &s = object->sections[current];
+    unsigned long padding = (alignment - s.size % alignment) % alignment;
+
+
+    if (alignment > s.align)
+	s.align = alignment;
+
+    while (padding > 0) {
+	unsigned long count = padding > 9 ? 9 : padding;
+
+	if (s.nobits)
+	    s.size += count;
+	else if (s.exec)
+	    for (unsigned i = 0; i < count; i ++)
+		emit(nops[count - 1][i]);
+	else
+	    emit(0, count);
+
+	padding -= count;
+    }
+}
+
+
+/*
+ * Function:	quoted (private)
+ *
+ * Description:	Emit the contents of a quoted string literal, including
+ *		the standard C escape sequences.
+ */
+
+static void quoted(const string &s, bool terminate)
+{
+    unsigned i = 1;
+
+
+    if (s.empty() || s[0] != '"')
+	error("expected string");
+
+    while (i < s.size() && s[i] != '"') {
+	if (s[i] != '\\') {
+	    emit((unsigned char) s[i ++]);
+	    continue;
+	}
+
+	switch (s[++ i]) {
+	case 'n': emit('\n'); i ++; break;
+	case 't': emit('\t'); i ++; break;
+	case 'r': emit('\r'); i ++; break;
+	case 'b': emit('\b'); i ++; break;
+	case 'f': emit('\f'); i ++; break;
+	case 'v': emit('\v'); i ++; break;
+	case 'a': emit('\a'); i ++; break;
+
+	case 'x': {
+	    unsigned value = 0;
+
+	    while (isxdigit(s[++ i]))
+		value = value * 16 + (isdigit(s[i]) ? s[i] - '0' :
+			tolower(s[i]) - 'a' + 10);
+
+	    emit(value);
+	    break;
+	}
+
+	default:
+	    if (s[i] >= '0' && s[i] <= '7') {
+		unsigned value = 0;
+
+		for (unsigned j = 0; j < 3 && s[i] >= '0' && s[i] <= '7'; j ++)
+		    value = value * 8 + s[i ++] - '0';
+
+		emit(value);
+	    } else
+		emit((unsigned char) s[i ++]);
+	}
+    }
+
+    if (terminate)
+	emit(0);
+}
+
+
+/*
+ * Function:	common (private)
+ *
+ * Description:	Allocate space for a symbol in the .bss section.
+ */
+
+static void common(const string &name, unsigned long size, unsigned long alignment)
+{
+    int saved = current;
+
+
+    current = object->section(".bss");
+    align(alignment);
+
+    ObjectSymbol &symbol = object->symbol(name);
+    symbol.section = current;
+    symbol.value = here();
+    symbol.size = size;
+
+    object->sections[current].size += size;
+    current = saved;
+}
+
+
+/*
+ * Function:	cfi (private)
+ *
+ * Description:	Record a directive describing the call frame of the
+ *		current function, which takes effect at the current offset.
+ */
+
+static void cfi(const string &name, const vector<string> &args)
+{
+    Rule rule;
+    int size;
+
+
+    if (name == ".cfi_startproc") {
+	Frame frame;
+
+	if (!frames.empty() && frames.back().open)
+	    error("nested .cfi_startproc");
+
+	frame.section = current;
+	frame.start = here();
+	frame.open = true;
+	frames.push_back(frame);
+	return;
+    }
+
+    if (frames.empty() || !frames.back().open)
+	error("missing .cfi_startproc");
+
+    Frame &frame = frames.back();
+
+    if (name == ".cfi_endproc") {
+	frame.end = here();
+	frame.open = false;
+	return;
+    }
+
+    rule.offset = here();
+    rule.reg = 0;
+    rule.value = 0;
+
+    if (name == ".cfi_def_cfa" || name == ".cfi_def_cfa_register" ||
+	    name == ".cfi_offset") {
+	if (args.empty() || args[0][0] != '%' ||
+		!registerNumber(args[0].substr(1), rule.reg, size) || size != 8)
+	    error("invalid register");
+
+	rule.reg = dwarf[rule.reg];
+    }
+
+    if (name == ".cfi_def_cfa" || name == ".cfi_offset") {
+	if (args.size() != 2)
+	    error("missing offset");
+
+	rule.value = strtol(args[1].c_str(), 0, 0);
+    }
+
+    if (name == ".cfi_def_cfa_offset") {
+	if (args.size() != 1)
+	    error("missing offset");
+
+	rule.value = strtol(args[0].c_str(), 0, 0);
+    }
+
+    if (name == ".cfi_def_cfa")
+	rule.opcode = DW_CFA_def_cfa;
+    else if (name == ".cfi_def_cfa_register")
+	rule.opcode = DW_CFA_def_cfa_register;
+    else if (name == ".cfi_def_cfa_offset")
+	rule.opcode = DW_CFA_def_cfa_offset;
+    else if (name == ".cfi_offset")
+	rule.opcode = DW_CFA_offset;
+    else if (name == ".cfi_remember_state")
+	rule.opcode = DW_CFA_remember_state;
+    else if (name == ".cfi_restore_state")
+	rule.opcode = DW_CFA_restore_state;
+    else
+	error("unknown directive");
+
+    frame.rules.push_back(rule);
+}
+
+
+/*
+ * Function:	directive (private)
+ *
+ * Description:	Handle an assembler directive.  The source lines given
+ *		by .file and .loc, and the call frame information given by
+ *		the .cfi directives, are only recorded here, and written
+ *		as their own sections once all the code is assembled.
+ */
+
+static void directive(const string &name, const string &rest)
+{
+    vector<string> args = split(rest);
+    string symbol;
+    long value;
+
+
+    if (name == ".text" || name == ".data" || name == ".bss")
+	current = object->section(name);
+
+    else if (name == ".section") {
+	if (args.empty())
+	    error("missing section name");
+
+	if (args[0] == ".note.GNU-stack")
+	    return;
+
+	current = object->section(args[0]);
+	Section &s = object->sections[current];
+
+	if (args.size() > 1 && args[1].size() > 1) {
+	    s.write = args[1].find('w') != string::npos;
+	    s.exec = args[1].find('x') != string::npos;
+	}
+
+	if (args.size() > 2 && args[2] == "@nobits")
+	    s.nobits = true;
+
+    } else if (name == ".globl" || name == ".global") {
+	for (unsigned i = 0; i < args.size(); i ++)
+	    object->symbol(args[i]).global = true;
+
+    } else if (name == ".local") {
+	for (unsigned i = 0; i < args.size(); i ++)
+	    locals.push_back(args[i]);
+
+    } else if (name == ".type") {
+	if (args.size() > 1 && args[1] == "@function")
+	    object->symbol(args[0]).function = true;
+
+    } else if (name == ".size") {
+	if (args.size() > 1 && isdigit(args[1][0]))
+	    object->symbol(args[0]).size = strtoul(args[1].c_str(), 0, 0);
+	else if (args.size() > 1 && args[1] == ".-" + args[0] && object->defined(args[0]))
+	    object->symbol(args[0]).size = here() - object->symbol(args[0]).value;
+
+    } else if (name == ".set" || name == ".equ") {
+	if (args.size() != 2)
+	    error("invalid assignment");
+
+	expression(args[1], value, symbol);
+
+	if (!symbol.empty())
+	    error("symbolic assignment is not supported");
+
+	ObjectSymbol &s = object->symbol(args[0]);
+	s.section = SYM_ABSOLUTE;
+	s.value = value;
+
+    } else if (name == ".comm" || name == ".lcomm") {
+	unsigned long size, alignment = 1;
+	bool local = name == ".lcomm";
+
+	if (args.size() < 2)
+	    error("invalid common symbol");
+
+	size = strtoul(args[1].c_str(), 0, 0);
+
+	if (args.size() > 2)
+	    alignment = strtoul(args[2].c_str(), 0, 0);
+	else
+	    while (alignment < 16 && alignment * 2 <= size)
+		alignment *= 2;
+
+	for (unsigned i = 0; i < locals.size(); i ++)
+	    if (locals[i] == args[0])
+		local = true;
+
+	if (local)
+	    common(args[0], size, alignment);
+
+	else {
+	    ObjectSymbol &s = object->symbol(args[0]);
+	    s.section = SYM_COMMON;
+	    s.value = alignment;
+	    s.size = size;
+	    s.global = true;
+	}
+
+    } else if (name == ".asciz" || name == ".string" || name == ".ascii") {
+	for (unsigned i = 0; i < args.size(); i ++)
+	    quoted(args[i], name != ".ascii");
+
+    } else if (name == ".byte" || name == ".short" || name == ".value" ||
+	    name == ".long" || name == ".int" || name == ".quad") {
+	unsigned size = name == ".byte" ? 1 : name == ".quad" ? 8 :
+	    (name == ".long" || name == ".int") ? 4 : 2;
+
+	for (unsigned i = 0; i < args.size(); i ++) {
+	    expression(args[i], value, symbol);
+
+	    if (symbol.empty())
+		emit(value, size);
+	    else if (size == 8)
+		fixup(RELOC_64, symbol, value);
+	    else if (size == 4)
+		fixup(RELOC_32, symbol, value);
+	    else
+		error("symbolic data must be 4 or 8 bytes");
+	}
+
+    } else if (name == ".zero" || name == ".skip" || name == ".space") {
+	unsigned long count = args.empty() ? 0 : strtoul(args[0].c_str(), 0, 0);
+
+	if (object->sections[current].nobits)
+	    object->sections[current].size += count;
+	else
+	    while (count -- > 0)
+		emit(0);
+
+    } else if (name == ".p2align" || name == ".balign" || name == ".align") {
+	unsigned long n = args.empty() ? 0 : strtoul(args[0].c_str(), 0, 0);
+	align(name == ".p2align" ? 1UL << n : n);
+
+    } else if (name == ".file") {
+	istringstream in(rest);
+	unsigned number;
+	string file;
+
+	if (!(in >> number) || number == 0)
+	    return;
+
+	getline(in, file);
+	file = trim(file);
+
+	if (file.size() < 2 || file[0] != '"' || file[file.size() - 1] != '"')
+	    error("expected string");
+
+	if (files.size() < number)
+	    files.resize(number);
+
+	files[number - 1] = file;
+
+    } else if (name == ".loc") {
+	istringstream in(rest);
+	Row row;
+
+	if (!(in >> row.file >> row.line) || row.file == 0 || row.file > files.size())
+	    error("invalid line");
+
+	row.section = current;
+	row.offset = here();
+	rows.push_back(row);
+
+    } else if (name.compare(0, 5, ".cfi_") == 0)
+	cfi(name, args);
+
+    else if (name != ".ident")
+	error("unknown directive");
+}
+
+
+/*
+ * Function:	statement (private)
+ *
+ * Description:	Assemble a single line of input, which may contain a
+ *		label, a directive, or an instruction.
+ */
+
+static void statement(string s)
+{
+    bool quoted = false;
+    size_t i;
+
+
+    /* Remove any comment, being careful of strings. */
+
+    for (i = 0; i < s.size(); i ++)
+	if (s[i] == '"' && (i == 0 || s[i - 1] != '\\'))
+	    quoted = !quoted;
+	else if (s[i] == '#' && !quoted)
+	    break;
+
+    s = trim(s.substr(0, i));
+
+
+    /* Define any labels. */
+
+    while ((i = s.find_first_of(": \t\"")) != string::npos && s[i] == ':') {
+	ObjectSymbol &symbol = object->symbol(s.substr(0, i));
+
+	if (symbol.section != SYM_UNDEFINED)
+	    error("symbol already defined");
+
+	symbol.section = current;
+	symbol.value = here();
+	s = trim(s.substr(i + 1));
+    }
+
+    if (s.empty())
+	return;
+
+
+    /* Handle the directive or instruction. */
+
+    i = s.find_first_of(" \t");
+    string name = s.substr(0, i);
+    string rest = i == string::npos ? "" : trim(s.substr(i));
+
+    if (name[0] == '.')
+	directive(name, rest);
+
+    else {
+	Instruction insn;
+	vector<string> args = split(rest);
+
+	insn.mnemonic = name;
+
+	for (unsigned j = 0; j < args.size(); j ++)
+	    insn.operands.push_back(operand(args[j]));
+
+	instruction(insn);
+    }
+}
+
+
+/*
+ * Function:	resolve (private)
+ *
+ * Description:	Patch all fixups whose symbols are now known.  A
+ *		PC-relative reference to a symbol in the same section is
+ *		resolved directly, as is any reference to an absolute
+ *		symbol.  Everything else becomes a relocation.
+ */
+
+static void resolve()
+{
+    for (unsigned i = 0; i < fixups.size(); i ++) {
+	const Fixup &f = fixups[i];
+	Section &s = object->sections[f.section];
+	ObjectSymbol &symbol = object->symbol(f.symbol);
+	bool pcrel = f.type == RELOC_PC32 || f.type == RELOC_PLT32;
+	unsigned size = f.type == RELOC_64 ? 8 : 4;
+	long value;
+
+
+	if (pcrel && symbol.section == f.section)
+	    value = symbol.value + f.addend - f.offset;
+
+	else if (symbol.section == SYM_ABSOLUTE)
+	    value = symbol.value + f.addend - (pcrel ? f.offset : 0);
+
+	else {
+	    Relocation r;
+
+	    r.offset = f.offset;
+	    r.type = f.type;
+	    r.symbol = f.symbol;
+	    r.addend = f.addend;
+	    s.relocs.push_back(r);
+	    continue;
+	}
+
+	if (size == 4 && (value < -2147483648L || value > 4294967295L)) {
+	    line = f.symbol;
+	    error("value out of range");
+	}
+
+	for (unsigned j = 0; j < size; j ++)
+	    s.bytes[f.offset + j] = (value >> (8 * j)) & 0xff;
+    }
+}
+
+
+/*
+ * Function:	lines (private)
+ *
+ * Description:	Write the line table for the rows recorded from the .loc
+ *		directives, along with a compilation unit referring to it,
+ *		without which a debugger would not find the table.  Only
+ *		the rows for the section of the first are written.
+ */
+
+static void lines()
+{
+    static const unsigned char lengths[] = {0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1};
+
+    /* A compilation unit without children, with the attributes of
+       its statement list, low and high addresses, name, and language,
+       and their forms. */
+
+    static const unsigned char abbreviation[] = {
+	1, 0x11, 0, 0x10, 0x06, 0x11, 0x01, 0x12, 0x01, 0x03, 0x08,
+	0x13, 0x05, 0, 0, 0,
+    };
+
+    int text = rows[0].section;
+    unsigned long offset = 0, unit, header;
+    unsigned file = 1, line = 1;
+    string start, end, table, abbrev;
+
+
+    start = label(text, 0);
+    end = label(text, object->sections[text].size);
+
+
+    /* The header of the line number program, in version 3. */
+
+    current = object->section(".debug_line");
+    table = label(current, here());
+    unit = here();
+    emit(0, 4);
+    emit(3, 2);
+    header = here();
+    emit(0, 4);
+
+    emit(1);
+    emit(1);
+    emit(-5);
+    emit(14);
+    emit(sizeof(lengths) + 1);
+
+    for (unsigned i = 0; i < sizeof(lengths); i ++)
+	emit(lengths[i]);
+
+    emit(0);
+
+    for (unsigned i = 0; i < files.size(); i ++) {
+	quoted(files[i], true);
+	emit(0, 3);
+    }
+
+    emit(0);
+    patch(header, here() - header - 4, 4);
+
+
+    /* The program, as a single sequence beginning at the section. */
+
+    emit(0);
+    leb128(9);
+    emit(DW_LNE_set_address);
+    fixup(RELOC_64, start, 0);
+
+    for (unsigned i = 0; i < rows.size(); i ++) {
+	if (rows[i].section != text)
+	    continue;
+
+	if (rows[i].file != file) {
+	    emit(DW_LNS_set_file);
+	    leb128(file = rows[i].file);
+	}
+
+	if (rows[i].line != line) {
+	    emit(DW_LNS_advance_line);
+	    leb128((long) rows[i].line - line, true);
+	    line = rows[i].line;
+	}
+
+	if (rows[i].offset != offset) {
+	    emit(DW_LNS_advance_pc);
+	    leb128(rows[i].offset - offset);
+	    offset = rows[i].offset;
+	}
+
+	emit(DW_LNS_copy);
+    }
+
+    emit(DW_LNS_advance_pc);
+    leb128(object->sections[text].size - offset);
+    emit(0);
+    leb128(1);
+    emit(DW_LNE_end_sequence);
+    patch(unit, here() - unit - 4, 4);
+
+
+    /* The abbreviation of the compilation unit. */
+
+    current = object->section(".debug_abbrev");
+    abbrev = label(current, here());
+
+    for (unsigned i = 0; i < sizeof(abbreviation); i ++)
+	emit(abbreviation[i]);
+
+
+    /* The compilation unit itself. */
+
+    current = object->section(".debug_info");
+    unit = here();
+    emit(0, 4);
+    emit(3, 2);
+    fixup(RELOC_32, abbrev, 0);
+    emit(8);
+
+    emit(1);
+    fixup(RELOC_32, table, 0);
+    fixup(RELOC_64, start, 0);
+    fixup(RELOC_64, end, 0);
+
+    quoted(files[rows[0].file - 1], true);
+    emit(1, 2);
+    patch(unit, here() - unit - 4, 4);
+}
+
+
+/*
+ * Function:	unwind (private)
+ *
+ * Description:	Write the call frame information recorded from the .cfi
+ *		directives as a common entry followed by an entry for each
+ *		function, in the format of .eh_frame.
+ */
+
+static void unwind()
+{
+    unsigned long cie, fde, last;
+
+
+    /* The common entry: on entry to a function, the frame address is
+       just above the return address at the top of the stack. */
+
+    current = object->section(".eh_frame");
+    align(8);
+    cie = here();
+    emit(0, 4);
+    emit(0, 4);
+    emit(1);
+    quoted("\"zR\"", true);
+    leb128(1);
+    leb128(DW_DATA_ALIGNMENT, true);
+    leb128(DW_RETURN_ADDRESS);
+    leb128(1);
+    emit(0x1b);
+
+    emit(DW_CFA_def_cfa);
+    leb128(dwarf[4]);
+    leb128(8);
+    emit(DW_CFA_offset | DW_RETURN_ADDRESS);
+    leb128(1);
+
+    align(8);
+    patch(cie, here() - cie - 4, 4);
+
+
+    /* An entry for each function, with a PC-relative start address. */
+
+    for (unsigned i = 0; i < frames.size(); i ++) {
+	const Frame &frame = frames[i];
+
+	if (frame.open)
+	    error("missing .cfi_endproc");
+
+	fde = here();
+	emit(0, 4);
+	emit(here() - cie, 4);
+	fixup(RELOC_PC32, label(frame.section, frame.start), 0);
+	emit(frame.end - frame.start, 4);
+	leb128(0);
+	last = frame.start;
+
+	for (unsigned j = 0; j < frame.rules.size(); j ++) {
+	    const Rule &rule = frame.rules[j];
+	    unsigned long delta = rule.offset - last;
+
+	    if (delta >= 0x10000) {
+		emit(DW_CFA_advance_loc4);
+		emit(delta, 4);
+	    } else if (delta >= 0x100) {
+		emit(DW_CFA_advance_loc2);
+		emit(delta, 2);
+	    } else if (delta >= 0x40) {
+		emit(DW_CFA_advance_loc1);
+		emit(delta);
+	    } else if (delta > 0)
+		emit(DW_CFA_advance_loc | delta);
+
+	    last = rule.offset;
+
+	    if (rule.opcode == DW_CFA_offset) {
+		emit(DW_CFA_offset | rule.reg);
+		leb128(rule.value / DW_DATA_ALIGNMENT);
+
+	    } else {
+		emit(rule.opcode);
+
+		if (rule.opcode == DW_CFA_def_cfa || rule.opcode == DW_CFA_def_cfa_register)
+		    leb128(rule.reg);
+
+		if (rule.opcode == DW_CFA_def_cfa || rule.opcode == DW_CFA_def_cfa_offset)
+		    leb128(rule.value);
+	    }
+	}
+
+	align(8);
+	patch(fde, here() - fde - 4, 4);
+    }
+}
+
+
+/*
+ * Function:	assemble
+ *
+ * Description:	Assemble the given input stream into the given object.
+ */
+
+void assemble(istream &in, Object &obj)
+{
+    object = &obj;
+    fixups.clear();
+    locals.clear();
+    files.clear();
+    rows.clear();
+    frames.clear();
+
+    object->section(".text");
+    object->section(".data");
+    object->section(".bss");
+    current = object->section(".text");
+
+    while (getline(in, line))
+	statement(line);
+
+    if (!rows.empty())
+	lines();
+
+    if (!frames.empty())
+	unwind();
+
+    resolve();
+}
@@ -0,0 +1,84 @@
+/*
+ * File:	assembler.h
+ *
+ * Description:	This file contains the class definitions and function
+ *		declarations for the assembler for Simple C.  Rather than
+ *		running the system assembler on the code written by the
+ *		generator, we parse each line of the generator's output
+ *		into an instruction and encode it as x86-64 machine code.
+ *		The result is an object in memory consisting of sections,
+ *		symbols, and relocations, which can either be written as
+ *		an ELF relocatable file or loaded and run directly.
+ *
+ *		Only the instructions and directives that the generator
+ *		actually emits are supported.
+ */
+
+# ifndef ASSEMBLER_H
+# define ASSEMBLER_H
+# include <map>
+# include <string>
+# include <vector>
+# include <istream>
+# include <ostream>
+
+
+/* The kinds of relocations we ever need.  PC-relative references are
+   used for RIP-relative operands and branches, and absolute references
+   for the occasional immediate or data word containing an address. */
+
+enum { RELOC_PC32, RELOC_PLT32, RELOC_32, RELOC_32S, RELOC_64 };
+
+struct Relocation {
+    unsigned long offset;
+    int type;
+    std::string symbol;
+    long addend;
+};
+
+
+/* A section of the object.  A section without contents (i.e., .bss)
+   only has a size, and a debugging section is not loaded. */
+
+struct Section {
+    std::string name;
+    std::vector<unsigned char> bytes;
+    std::vector<Relocation> relocs;
+    unsigned long size, align;
+    bool write, exec, nobits, debug;
+};
+
+
+/* A symbol of the object.  A symbol is either defined in a section,
+   undefined, common, or absolute. */
+
+enum { SYM_UNDEFINED = -1, SYM_COMMON = -2, SYM_ABSOLUTE = -3 };
+
+struct ObjectSymbol {
+    std::string name;
+    int section;
+    unsigned long value, size;
+    bool global, function;
+};
+
+
+/* An assembled object, with the symbols kept in order of first
+   reference. */
+
+class Object {
+    typedef std::string string;
+
+public:
+    std::vector<Section> sections;
+    std::vector<ObjectSymbol> symbols;
+    std::map<string, unsigned> table;
+
+    int section(const string &name);
+    ObjectSymbol &symbol(const string &name);
+    bool defined(const string &name) const;
+};
+
+void assemble(std::istream &in, Object &object);
+void writeObject(const Object &object, std::ostream &out);
+
+# endif /* ASSEMBLER_H */
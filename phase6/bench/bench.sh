@@ -0,0 +1,207 @@
+#!/bin/bash
+#
+# File:		bench.sh
+#
+# Description:	Measure the speed of the code generated by scc for each
+#		example and each benchmark kernel, with large inputs,
+#		against the code generated by gcc -O0 and -O2 for the
+#		same source.  Each program is run several times under
+#		perf stat, if available, or otherwise just timed, and the
+#		best of each measurement is kept.  The results are written
+#		as a table, and appended to a history with one JSON object
+#		per line, so that each change to the code generator can be
+#		compared with those before it.
+#
+# Usage:	bench/bench.sh [scc options]
+#
+#		The options default to -O2.  RUNS sets the number of runs
+#		of each program, and PROGRAMS the names of those to run.
+#		HISTORY sets the file to which the results are appended,
+#		by default bench/results/history.json, which is ignored
+#		by git.
+#
+
+cd "$(dirname "$0")/.." || exit 1
+
+FLAGS=${*:--O2}
+RUNS=${RUNS:-3}
+HISTORY=${HISTORY:-bench/results/history.json}
+EXAMPLES="acid calc divide fib global hello int matrix mixed qsort tree vector"
+KERNELS="mmul sort build scan"
+PROGRAMS=${PROGRAMS:-"$EXAMPLES $KERNELS"}
+WORK=$(mktemp -d)
+COMMIT=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+DATE=$(date -u +%Y-%m-%dT%H:%M:%SZ)
+PERF=
+
+trap 'rm -rf "$WORK"' EXIT
+mkdir -p "$(dirname "$HISTORY")" || exit 1
+
+if perf stat -x, -e cycles true 2>/dev/null >/dev/null; then
+    PERF=yes
+fi
+
+
+# Write the input for a program, which for a kernel or an example whose
+# work grows with its input is generated to be large.
+
+input() {
+    case $1 in
+    fib)	echo 35 ;;
+    matrix)	echo 400 ;;
+    mmul)	echo 500 ;;
+    build)	echo 1000000 ;;
+
+    calc)
+	awk 'BEGIN {
+	    srand(1)
+	    for (i = 0; i < 200000; i ++) {
+		if (i > 0) printf(rand() < 0.5 ? " + " : " - ")
+		if (rand() < 0.1)
+		    printf("(%d - %d)", int(rand() * 10), int(rand() * 10))
+		else
+		    printf("%d * %d", int(rand() * 10), int(rand() * 10))
+	    }
+	    printf("\n")
+	}' ;;
+
+    sort)
+	awk 'BEGIN {
+	    srand(2)
+	    n = 1000000
+	    print n
+	    for (i = 0; i < n; i ++) print int(rand() * 1000000000)
+	}' ;;
+
+    scan)
+	awk 'BEGIN {
+	    srand(3)
+	    split("the and of a to in is that for it as was with be by on not " \
+		"he this are or his from at which but have an they you were " \
+		"attention nation station motion", words)
+	    for (i = 0; i < 200000; i ++) {
+		n = 5 + int(rand() * 10)
+		for (j = 0; j < n; j ++)
+		    printf("%s%s", j > 0 ? " " : "", words[1 + int(rand() * 36)])
+		printf(".\n")
+	    }
+	}' ;;
+
+    *)	cat examples/$1.in ;;
+    esac
+}
+
+
+# Print the path of the source of a program.
+
+path() {
+    if [ -f bench/$1.c ]; then
+	echo bench/$1.c
+    else
+	echo examples/$1.c
+    fi
+}
+
+
+# Print the smaller of two counts, either of which may be missing.
+
+smaller() {
+    if [ -z "$1" ] || [ "$1" = null ]; then
+	echo $2
+    elif [ "$2" = null ] || [ "$2" -ge "$1" ]; then
+	echo $1
+    else
+	echo $2
+    fi
+}
+
+
+# Run a program on its input and print the best wall time in seconds,
+# cycles, instructions, and branch misses, using null for any that
+# cannot be measured.
+
+measure() {
+    local best="" cycles="" instructions="" misses="" start end t c i m
+
+    for ((run = 0; run < RUNS; run ++)); do
+	start=$(date +%s%N)
+
+	if [ -n "$PERF" ]; then
+	    perf stat -x, -o "$WORK/perf" -e cycles,instructions,branch-misses \
+		"$1" < "$2" > /dev/null 2>&1
+	else
+	    "$1" < "$2" > /dev/null 2>&1
+	fi
+
+	end=$(date +%s%N)
+	t=$((end - start))
+
+	if [ -z "$best" ] || [ $t -lt $best ]; then
+	    best=$t
+	fi
+
+	if [ -n "$PERF" ]; then
+	    read -r c i m < <(awk -F, '
+		$3 ~ /^cycles/ { c = $1 }
+		$3 ~ /^instructions/ { i = $1 }
+		$3 ~ /^branch-misses/ { m = $1 }
+		END { print (c ~ /^[0-9]+$/ ? c : "null"), (i ~ /^[0-9]+$/ ? i : "null"), (m ~ /^[0-9]+$/ ? m : "null") }' "$WORK/perf")
+
+	    cycles=$(smaller "$cycles" $c)
+	    instructions=$(smaller "$instructions" $i)
+	    misses=$(smaller "$misses" $m)
+	fi
+    done
+
+    echo "$(awk "BEGIN { printf(\"%.6f\", $best / 1e9) }") ${cycles:-null} ${instructions:-null} ${misses:-null}"
+}
+
+
+# Append a result to the history.
+
+record() {
+    echo "{\"date\": \"$DATE\", \"commit\": \"$COMMIT\", \"program\": \"$1\"," \
+	"\"compiler\": \"$2\", \"seconds\": $3, \"cycles\": $4," \
+	"\"instructions\": $5, \"branch_misses\": $6, \"correct\": $7}" >> "$HISTORY"
+}
+
+
+printf "%-8s %12s %12s %12s %9s %9s\n" program "scc $FLAGS" "gcc -O0" "gcc -O2" "/gcc-O0" "/gcc-O2"
+
+for name in $PROGRAMS; do
+    src=$(path $name)
+    input $name > "$WORK/$name.in"
+
+    ./scc $FLAGS < $src > "$WORK/$name.s" &&
+	gcc -o "$WORK/$name.scc" "$WORK/$name.s" 2>/dev/null &&
+	gcc -w -O0 -o "$WORK/$name.gcc-O0" $src &&
+	gcc -w -O2 -o "$WORK/$name.gcc-O2" $src || {
+	    echo "$name: cannot build" >&2
+	    continue
+	}
+
+    "$WORK/$name.gcc-O0" < "$WORK/$name.in" > "$WORK/$name.expected" 2>&1
+    times=()
+
+    for compiler in scc gcc-O0 gcc-O2; do
+	"$WORK/$name.$compiler" < "$WORK/$name.in" > "$WORK/$name.actual" 2>&1
+
+	if cmp -s "$WORK/$name.expected" "$WORK/$name.actual"; then
+	    correct=true
+	else
+	    correct=false
+	    echo "$name: output of $compiler differs from gcc -O0" >&2
+	fi
+
+	read -r seconds cycles instructions misses < <(measure "$WORK/$name.$compiler" "$WORK/$name.in")
+	times+=($seconds)
+
+	[ $compiler = scc ] && label="scc $FLAGS" || label="gcc ${compiler#gcc}"
+	record $name "$label" $seconds $cycles $instructions $misses $correct
+    done
+
+    awk -v n=$name -v a=${times[0]} -v b=${times[1]} -v c=${times[2]} 'BEGIN {
+	printf("%-8s %12.3f %12.3f %12.3f %9.2f %9.2f\n", n, a, b, c,
+	    b > 0 ? a / b : 0, c > 0 ? a / c : 0)
+    }'
+done
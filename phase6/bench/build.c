@@ -0,0 +1,100 @@
+/* build.c */
+
+int printf(), scanf(), *malloc();
+
+int *keys, *left, *right;
+long seed;
+
+
+/*
+ * return the next pseudo-random key
+ */
+
+int next(void)
+{
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    return seed;
+}
+
+
+/*
+ * insert the given node into the binary search tree rooted at node 0
+ */
+
+int insert(int node)
+{
+    int p;
+
+    p = 0;
+
+    while (1) {
+	if (keys[node] < keys[p]) {
+	    if (left[p] == 0) {
+		left[p] = node;
+		return 0;
+	    }
+
+	    p = left[p];
+
+	} else {
+	    if (right[p] == 0) {
+		right[p] = node;
+		return 0;
+	    }
+
+	    p = right[p];
+	}
+    }
+}
+
+
+int height(int node)
+{
+    int l, r;
+
+    if (node == 0)
+	return 0;
+
+    l = height(left[node]);
+    r = height(right[node]);
+
+    if (l > r)
+	return l + 1;
+
+    return r + 1;
+}
+
+
+long total(int node, int depth)
+{
+    if (node == 0)
+	return 0;
+
+    return keys[node] % 1000 * depth + total(left[node], depth + 1) +
+	total(right[node], depth + 1);
+}
+
+
+int main(void)
+{
+    int i, n;
+
+    scanf("%d", &n);
+    keys = malloc(n * sizeof keys[0]);
+    left = malloc(n * sizeof left[0]);
+    right = malloc(n * sizeof right[0]);
+    i = 0;
+
+    while (i < n) {
+	keys[i] = next();
+	left[i] = 0;
+	right[i] = 0;
+
+	if (i > 0)
+	    insert(i);
+
+	i = i + 1;
+    }
+
+    printf("%d %d %ld\n", n, height(left[0]) + 1, total(left[0], 1) + total(right[0], 1));
+}
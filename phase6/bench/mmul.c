@@ -0,0 +1,68 @@
+/* mmul.c */
+
+int printf(), scanf(), *malloc();
+
+long seed;
+
+
+/*
+ * return the next pseudo-random number between 0 and 99
+ */
+
+int next(void)
+{
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    return seed / 65536 % 100;
+}
+
+
+int main(void)
+{
+    int *a, *b, *c;
+    int i, j, k, n;
+    long sum;
+
+    scanf("%d", &n);
+    a = malloc(n * n * sizeof a[0]);
+    b = malloc(n * n * sizeof b[0]);
+    c = malloc(n * n * sizeof c[0]);
+
+    i = 0;
+
+    while (i < n * n) {
+	a[i] = next();
+	b[i] = next();
+	i = i + 1;
+    }
+
+    i = 0;
+
+    while (i < n) {
+	j = 0;
+
+	while (j < n) {
+	    sum = 0;
+	    k = 0;
+
+	    while (k < n) {
+		sum = sum + a[i * n + k] * b[k * n + j];
+		k = k + 1;
+	    }
+
+	    c[i * n + j] = sum;
+	    j = j + 1;
+	}
+
+	i = i + 1;
+    }
+
+    sum = 0;
+    i = 0;
+
+    while (i < n * n) {
+	sum = sum + c[i] % 1000;
+	i = i + 1;
+    }
+
+    printf("%ld\n", sum);
+}
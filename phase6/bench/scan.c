@@ -0,0 +1,90 @@
+/* scan.c */
+
+int printf(), getchar();
+char *malloc();
+
+char *text;
+long length;
+
+
+/*
+ * count the occurrences of the pattern in the text
+ */
+
+long count(char *pattern)
+{
+    long i, j, found;
+
+    i = 0;
+    found = 0;
+
+    while (i < length) {
+	j = 0;
+
+	while (pattern[j] != 0 && text[i + j] == pattern[j])
+	    j = j + 1;
+
+	if (pattern[j] == 0)
+	    found = found + 1;
+
+	i = i + 1;
+    }
+
+    return found;
+}
+
+
+int isletter(int c)
+{
+    return (c >= 97 && c <= 122) || (c >= 65 && c <= 90);
+}
+
+
+int main(void)
+{
+    long size, lines, words, i;
+    int c;
+    char *bigger;
+
+    size = 4096;
+    text = malloc(size);
+    length = 0;
+    c = getchar();
+
+    while (c != -1) {
+	if (length + 1 == size) {
+	    bigger = malloc(size * 2);
+	    i = 0;
+
+	    while (i < length) {
+		bigger[i] = text[i];
+		i = i + 1;
+	    }
+
+	    text = bigger;
+	    size = size * 2;
+	}
+
+	text[length] = c;
+	length = length + 1;
+	c = getchar();
+    }
+
+    text[length] = 0;
+    lines = 0;
+    words = 0;
+    i = 0;
+
+    while (i < length) {
+	if (text[i] == 10)
+	    lines = lines + 1;
+
+	if (isletter(text[i]) && (i == 0 || !isletter(text[i - 1])))
+	    words = words + 1;
+
+	i = i + 1;
+    }
+
+    printf("%ld %ld %ld\n", length, lines, words);
+    printf("%ld %ld %ld\n", count("the"), count("and"), count("tion"));
+}
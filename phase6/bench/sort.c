@@ -0,0 +1,85 @@
+/* sort.c */
+
+int printf(), scanf(), *malloc();
+
+
+/*
+ * merge the sorted runs a[lo..mid) and a[mid..hi) into b[lo..hi)
+ */
+
+int merge(int *a, int *b, int lo, int mid, int hi)
+{
+    int i, j, k;
+
+    i = lo;
+    j = mid;
+    k = lo;
+
+    while (k < hi) {
+	if (j >= hi || (i < mid && a[i] <= a[j])) {
+	    b[k] = a[i];
+	    i = i + 1;
+	} else {
+	    b[k] = a[j];
+	    j = j + 1;
+	}
+
+	k = k + 1;
+    }
+}
+
+
+int main(void)
+{
+    int *a, *b, *t;
+    int i, n, width, lo, mid, hi;
+    long sum;
+
+    scanf("%d", &n);
+    a = malloc(n * sizeof a[0]);
+    b = malloc(n * sizeof b[0]);
+    i = 0;
+
+    while (i < n) {
+	scanf("%d", &a[i]);
+	i = i + 1;
+    }
+
+    width = 1;
+
+    while (width < n) {
+	lo = 0;
+
+	while (lo < n) {
+	    mid = lo + width;
+	    hi = lo + 2 * width;
+
+	    if (mid > n)
+		mid = n;
+
+	    if (hi > n)
+		hi = n;
+
+	    merge(a, b, lo, mid, hi);
+	    lo = hi;
+	}
+
+	t = a;
+	a = b;
+	b = t;
+	width = 2 * width;
+    }
+
+    sum = 0;
+    i = 1;
+
+    while (i < n) {
+	if (a[i - 1] > a[i])
+	    printf("not sorted at %d\n", i);
+
+	sum = sum + (long) a[i] * (i % 7);
+	i = i + 1;
+    }
+
+    printf("%d %d %ld\n", a[0], a[n - 1], sum);
+}
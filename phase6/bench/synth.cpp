@@ -0,0 +1,405 @@
+/*
+ * File:	synth.cpp
+ *
+ * Description:	This file contains a generator of synthetic Simple C
+ *		programs, used to measure how the time and memory taken by
+ *		the compiler grow with the size of its input.
+ *
+ *		The program is a sequence of functions, each preceded by a
+ *		few global declarations.  Each function declares the same
+ *		few locals, and its body is a sequence of statements, which
+ *		may nest if and while statements up to a given depth.  The
+ *		expressions read the parameters, locals, and globals
+ *		declared so far, index the global arrays, and call the
+ *		functions defined so far.  Some statements print a string
+ *		literal.  The program is meant to be compiled, not run:
+ *		its loops need not terminate.
+ *
+ *		The same options and seed always give the same program.
+ *		With -b, functions are written until the program is at
+ *		least the given size, which may have a suffix of k, m, or
+ *		g, and otherwise the given number of functions is written.
+ */
+
+# include <string>
+# include <vector>
+# include <cstdlib>
+# include <sstream>
+# include <iostream>
+
+using namespace std;
+
+struct Global {
+    string name;
+    bool array;
+};
+
+static unsigned numStatements = 20, maxDepth = 3, numGlobals = 1;
+static unsigned exprSize = 4, numStrings = 1;
+static unsigned long seed = 1;
+
+static vector<Global> globals;
+static vector<unsigned> arities;
+static const char *locals[] = {"a", "b", "c", "i", "x", "y"};
+static const unsigned numLocals = sizeof(locals) / sizeof(locals[0]);
+static unsigned arity;
+
+static void statement(ostream &out, unsigned depth);
+
+
+/*
+ * Function:	pick (private)
+ *
+ * Description:	Return a pseudorandom number less than the given bound,
+ *		using a linear congruential generator so that the program
+ *		is the same on every host.
+ */
+
+static unsigned pick(unsigned bound)
+{
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    return (seed >> 33) % bound;
+}
+
+
+/*
+ * Function:	indent (private)
+ *
+ * Description:	Write the indentation for the given depth of nesting.
+ */
+
+static void indent(ostream &out, unsigned depth)
+{
+    for (unsigned i = 0; i <= depth; i ++)
+	out << "    ";
+}
+
+
+/*
+ * Function:	variable (private)
+ *
+ * Description:	Write the name of a scalar variable: a parameter, a
+ *		local, or a global.
+ */
+
+static void variable(ostream &out)
+{
+    unsigned n = pick(10);
+
+
+    if (n < 2 && arity > 0)
+	out << "p" << pick(arity);
+    else if (n < 4 && !globals.empty()) {
+	const Global &global = globals[pick(globals.size())];
+
+	if (global.array)
+	    out << global.name << "[" << pick(16) << "]";
+	else
+	    out << global.name;
+    } else
+	out << locals[pick(numLocals)];
+}
+
+
+/*
+ * Function:	call (private)
+ *
+ * Description:	Write a call to a function defined earlier, with simple
+ *		arguments.
+ */
+
+static void call(ostream &out)
+{
+    unsigned callee = pick(arities.size());
+
+
+    out << "f" << callee << "(";
+
+    for (unsigned i = 0; i < arities[callee]; i ++) {
+	if (i > 0)
+	    out << ", ";
+
+	if (pick(2))
+	    variable(out);
+	else
+	    out << pick(100);
+    }
+
+    out << ")";
+}
+
+
+/*
+ * Function:	operand (private)
+ *
+ * Description:	Write a primary expression: a variable, a literal, or a
+ *		call.
+ */
+
+static void operand(ostream &out)
+{
+    unsigned n = pick(10);
+
+
+    if (n < 5)
+	variable(out);
+    else if (n < 8 || arities.empty())
+	out << pick(1000);
+    else
+	call(out);
+}
+
+
+/*
+ * Function:	expression (private)
+ *
+ * Description:	Write an expression with the given number of binary
+ *		operators, most of them arithmetic.
+ */
+
+static void expression(ostream &out, unsigned size)
+{
+    static const char *operators[] = {
+	"+", "-", "*", "+", "-", "*", "/", "%", "<", "==", "&&", "||",
+    };
+
+    unsigned left, n;
+
+
+    if (size == 0) {
+	operand(out);
+	return;
+    }
+
+    left = pick(size);
+    n = pick(sizeof(operators) / sizeof(operators[0]));
+
+    out << "(";
+    expression(out, left);
+    out << " " << operators[n] << " ";
+
+    if (n == 6 || n == 7)
+	out << 1 + pick(9);
+    else
+	expression(out, size - 1 - left);
+
+    out << ")";
+}
+
+
+/*
+ * Function:	block (private)
+ *
+ * Description:	Write a compound statement of a few statements.
+ */
+
+static void block(ostream &out, unsigned depth)
+{
+    unsigned count = 1 + pick(3);
+
+
+    out << "{" << endl;
+
+    for (unsigned i = 0; i < count; i ++)
+	statement(out, depth + 1);
+
+    indent(out, depth);
+    out << "}";
+}
+
+
+/*
+ * Function:	statement (private)
+ *
+ * Description:	Write a statement at the given depth of nesting, which
+ *		is an if or while statement only below the maximum depth.
+ */
+
+static void statement(ostream &out, unsigned depth)
+{
+    unsigned n = pick(20);
+
+
+    indent(out, depth);
+
+    if (n < 3 && depth < maxDepth) {
+	out << "if (";
+	expression(out, exprSize / 2);
+	out << ") ";
+	block(out, depth);
+
+	if (pick(2)) {
+	    out << " else ";
+	    block(out, depth);
+	}
+
+	out << endl;
+
+    } else if (n < 4 && depth < maxDepth) {
+	out << "while (i < " << pick(100) << ") ";
+	out << "{" << endl;
+	statement(out, depth + 1);
+	indent(out, depth + 1);
+	out << "i = i + 1;" << endl;
+	indent(out, depth);
+	out << "}" << endl;
+
+    } else if (n < 5 && !arities.empty()) {
+	call(out);
+	out << ";" << endl;
+
+    } else {
+	variable(out);
+	out << " = ";
+	expression(out, exprSize);
+	out << ";" << endl;
+    }
+}
+
+
+/*
+ * Function:	function (private)
+ *
+ * Description:	Write the globals that precede a function, and then the
+ *		function itself.
+ */
+
+static void function(ostream &out)
+{
+    unsigned id = arities.size();
+
+
+    for (unsigned i = 0; i < numGlobals; i ++) {
+	Global global;
+
+	global.name = "g" + to_string(globals.size());
+	global.array = pick(4) == 0;
+	globals.push_back(global);
+
+	out << (pick(2) ? "int " : "long ") << global.name;
+	out << (global.array ? "[16];" : ";") << endl;
+    }
+
+    arity = pick(4);
+    out << endl << "int f" << id << "(";
+
+    for (unsigned i = 0; i < arity; i ++)
+	out << (i > 0 ? ", " : "") << "int p" << i;
+
+    out << (arity == 0 ? "void" : "") << ")" << endl << "{" << endl;
+    out << "    int a, b, c, i;" << endl;
+    out << "    long x, y;" << endl << endl << endl;
+
+    for (unsigned i = 0; i < numStatements; i ++) {
+	if (pick(numStatements) < numStrings) {
+	    indent(out, 0);
+	    out << "printf(\"f" << id << " step " << i << ": %d\\n\", ";
+	    expression(out, exprSize / 2);
+	    out << ");" << endl;
+	} else
+	    statement(out, 0);
+    }
+
+    out << endl << "    return ";
+    expression(out, exprSize);
+    out << ";" << endl << "}" << endl << endl;
+
+    arities.push_back(arity);
+}
+
+
+/*
+ * Function:	size (private)
+ *
+ * Description:	Convert a size with an optional suffix to a number of bytes.
+ */
+
+static unsigned long size(const string &arg)
+{
+    char *end;
+    unsigned long n;
+
+
+    n = strtoul(arg.c_str(), &end, 10);
+
+    if (*end == 'k' || *end == 'K')
+	n <<= 10;
+    else if (*end == 'm' || *end == 'M')
+	n <<= 20;
+    else if (*end == 'g' || *end == 'G')
+	n <<= 30;
+
+    return n;
+}
+
+
+/*
+ * Function:	usage (private)
+ *
+ * Description:	Report the command line usage and terminate.
+ */
+
+static void usage()
+{
+    cerr << "usage: synth [-f functions | -b bytes] [-s statements]";
+    cerr << " [-d depth]" << endl;
+    cerr << "             [-g globals] [-e operators] [-l strings]";
+    cerr << " [-r seed]" << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Write a program of the shape given on the command line to
+ *		the standard output.  By default, it has 100 functions,
+ *		each preceded by one global and having 20 statements
+ *		nested at most three deep, with four operators in each
+ *		expression and about one string literal.
+ */
+
+int main(int argc, char *argv[])
+{
+    unsigned numFunctions = 100;
+    unsigned long bytes = 0, written = 0;
+    ostringstream text;
+
+
+    for (int i = 1; i < argc; i ++) {
+	string arg = argv[i];
+
+	if (arg.size() != 2 || arg[0] != '-' || i + 1 == argc)
+	    usage();
+
+	arg = argv[++ i];
+
+	switch (argv[i - 1][1]) {
+	case 'f': numFunctions = stoul(arg); break;
+	case 'b': bytes = size(arg); break;
+	case 's': numStatements = stoul(arg); break;
+	case 'd': maxDepth = stoul(arg); break;
+	case 'g': numGlobals = stoul(arg); break;
+	case 'e': exprSize = stoul(arg); break;
+	case 'l': numStrings = stoul(arg); break;
+	case 'r': seed = stoul(arg); break;
+	default: usage();
+	}
+    }
+
+    if (numStatements == 0)
+	usage();
+
+    cout << "int printf();" << endl << endl;
+
+    while (bytes > 0 ? written < bytes : arities.size() < numFunctions) {
+	text.str("");
+	function(text);
+	cout << text.str();
+	written += text.str().size();
+    }
+
+    cout << "int main(void)" << endl << "{" << endl;
+    cout << "    return 0;" << endl << "}" << endl;
+    return 0;
+}
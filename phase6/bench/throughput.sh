@@ -0,0 +1,152 @@
+#!/bin/bash
+#
+# File:		throughput.sh
+#
+# Description:	Measure how the time and memory taken by scc itself grow
+#		with the size of its input.  Synthetic programs of sizes
+#		growing by a factor of four are written by bench/synth and
+#		compiled with -ftime-report, from which the time taken by
+#		each phase and the peak memory are taken.  Without
+#		optimization, code is written as it is generated, so the
+#		time to emit it is part of that to generate it.
+#
+#		For each phase, the exponent of its growth is fitted over
+#		the sizes at which it takes long enough to measure, and a
+#		phase whose time grows faster than linearly is flagged.
+#		Sizes whose compilation would take longer than the time
+#		limit or use more than the memory available, judging from
+#		the sizes before them, are skipped.
+#
+# Usage:	bench/throughput.sh [scc options]
+#
+#		The options default to -O0.  MIN and MAX set the smallest
+#		and largest sizes, which default to 1k and 4m and may be as
+#		large as 1g.  SHAPE sets the options given to bench/synth,
+#		and LIMIT the time limit in seconds, which defaults to 600.
+#
+
+cd "$(dirname "$0")/.." || exit 1
+
+FLAGS=${*:--O0}
+MIN=${MIN:-1k}
+MAX=${MAX:-4m}
+LIMIT=${LIMIT:-600}
+SHAPE=${SHAPE:-}
+WORK=$(mktemp -d)
+PHASES="lex parse/check allocate generate emit"
+
+trap 'rm -rf "$WORK"' EXIT
+
+make -s scc bench/synth || exit 1
+
+
+# Print a size with a suffix as a number of bytes.
+
+bytes() {
+    case $1 in
+    *[kK])	echo $((${1%?} << 10)) ;;
+    *[mM])	echo $((${1%?} << 20)) ;;
+    *[gG])	echo $((${1%?} << 30)) ;;
+    *)		echo $1 ;;
+    esac
+}
+
+
+# Print the wall-clock time of each phase, the total time, and the peak
+# memory from a time report.  Every pass other than emit is part of
+# generating, and writing the output is part of emitting.
+
+phases() {
+    awk '
+	/^pass/ { next }
+	/^lex / { lex = $2; next }
+	/^parse\/check / { parse = $2; next }
+	/^allocate / { allocate = $2; next }
+	/^emit / || /^output / { emit += $2; next }
+	/^assemble / { next }
+	/^total / { total = $2; next }
+	/^peak memory/ { memory = $4; next }
+	{ generate += $2 }
+	END { printf("%.3f %.3f %.3f %.3f %.3f %.3f %d\n", lex, parse,
+	    allocate, generate, emit, total, memory) }' "$1"
+}
+
+
+size=$(bytes $MIN)
+last=$(bytes $MAX)
+available=$(awk '/^MemAvailable:/ { print $2 }' /proc/meminfo 2>/dev/null)
+previous=
+
+printf "%10s %10s %12s %10s %10s %10s %10s %10s\n" bytes lex parse/check \
+    allocate generate emit total "peak KB"
+
+while [ $size -le $last ]; do
+    if [ -n "$previous" ]; then
+	read -r ptotal pmemory <<< "$previous"
+
+	if awk -v t=$ptotal -v l=$LIMIT 'BEGIN { exit !(t * 4 > l * 1000) }'; then
+	    echo "$size: skipped, since it would take longer than ${LIMIT}s" >&2
+	    break
+	fi
+
+	if [ -n "$available" ] && [ $((pmemory * 4)) -gt $available ]; then
+	    echo "$size: skipped, since it would use more than ${available} KB" >&2
+	    break
+	fi
+    fi
+
+    bench/synth -b $size $SHAPE > "$WORK/input.c"
+    actual=$(wc -c < "$WORK/input.c")
+
+    if ! ./scc $FLAGS -ftime-report -o /dev/null "$WORK/input.c" 2> "$WORK/report"; then
+	echo "$size: scc failed" >&2
+	cat "$WORK/report" >&2
+	exit 1
+    fi
+
+    read -r lex parse allocate generate emit total memory < <(phases "$WORK/report")
+    printf "%10d %10.1f %12.1f %10.1f %10.1f %10.1f %10.1f %10d\n" $actual \
+	$lex $parse $allocate $generate $emit $total $memory
+    echo "$actual $lex $parse $allocate $generate $emit $total $memory" >> "$WORK/results"
+
+    previous="$total $memory"
+    size=$((size * 4))
+done
+
+[ -f "$WORK/results" ] || exit 0
+
+
+# Fit the exponent of the growth of each phase by least squares on a
+# log-log scale, using only the times of at least 10 ms, which are well
+# above the resolution of the clock, and the peak memory beyond that of
+# the smallest program, once it is at least as much again.  An exponent
+# well above one means the phase is superlinear.
+
+echo
+awk -v phases="$PHASES total memory" '
+    BEGIN { n = split(phases, name, " ") }
+    NR == 1 { base = $NF }
+    {
+	for (i = 1; i <= n; i ++)
+	    if (name[i] == "memory" ? $NF >= 2 * base : $(i + 1) >= 10) {
+		x = log($1)
+		y = log(name[i] == "memory" ? $NF - base : $(i + 1))
+		count[i] ++
+		sx[i] += x
+		sy[i] += y
+		sxx[i] += x * x
+		sxy[i] += x * y
+	    }
+    }
+    END {
+	for (i = 1; i <= n; i ++) {
+	    if (count[i] < 2) {
+		printf("%-12s too small to measure\n", name[i])
+		continue
+	    }
+
+	    slope = (count[i] * sxy[i] - sx[i] * sy[i]) / (count[i] * sxx[i] - sx[i] * sx[i])
+	    printf("%-12s grows as size^%.2f%s\n", name[i], slope,
+		slope > 1.2 ? "  ** superlinear **" : "")
+	}
+    }' "$WORK/results"
@@ -0,0 +1,1013 @@
+/*
+ * File:	builder.cpp
+ *
+ * Description:	This file contains the member function definitions for
+ *		building the flow graph of a function from its abstract
+ *		syntax tree.  Like the code generator, the builder keeps
+ *		its state in a few private variables: the graph being built
+ *		and the current block, to which instructions are appended.
+ *
+ *		Every local scalar variable is at first accessed using get
+ *		and set instructions.  Once the function is built, those
+ *		variables whose address was taken are instead accessed
+ *		through memory, and all others are left to be put in SSA
+ *		form by the optimizer.
+ *
+ *		Tests are translated into branches to a true and a false
+ *		block, again using the true and false lists of Aho et al.
+ *		Unlike the code generator, neither list is ever empty,
+ *		since the layout of the blocks is decided much later.
+ */
+
+# include <set>
+# include <cstdlib>
+# include "machine.h"
+# include "profile.h"
+# include "Tree.h"
+# include "IR.h"
+
+using namespace std;
+
+static Graph *graph;
+static BasicBlock *block;
+static map<const Symbol *, unsigned> variables;
+static set<const Symbol *> taken;
+static const Counts *counts;
+static string function;
+static unsigned line;
+
+
+/*
+ * Function:	instruction (private)
+ *
+ * Description:	Create an instruction for the current line and append it to
+ *		the current block.
+ */
+
+static Instruction *instruction(int opcode, unsigned size,
+	const Instructions &operands = {}, long value = 0)
+{
+    Instruction *in = new Instruction(opcode, size, operands, value);
+
+    in->_line = line;
+    block->append(in);
+    return in;
+}
+
+
+/*
+ * Function:	constant (private)
+ *
+ * Description:	Build an integer constant of the given size.
+ */
+
+static Instruction *constant(long value, unsigned size)
+{
+    return instruction(OP_CONST, size, {}, normalize(value, size));
+}
+
+
+/*
+ * Function:	create (private)
+ *
+ * Description:	Create a new block in the graph.
+ */
+
+static BasicBlock *create()
+{
+    BasicBlock *block = new BasicBlock();
+
+    graph->_blocks.push_back(block);
+    return block;
+}
+
+
+/*
+ * Function:	terminate (private)
+ *
+ * Description:	End the current block with the given terminator and add
+ *		the edges to its successors.  Any code that follows, which
+ *		is only reachable if a later label is, goes into a new block
+ *		that is at least for now unreachable.
+ */
+
+static void terminate(Instruction *instruction, const BasicBlocks &targets = {})
+{
+    instruction->_line = line;
+    block->append(instruction);
+
+    for (unsigned i = 0; i < targets.size(); i ++) {
+	block->_successors.push_back(targets[i]);
+	targets[i]->_predecessors.push_back(block);
+    }
+
+    block = create();
+}
+
+
+/*
+ * Function:	jump (private)
+ *
+ * Description:	End the current block with an unconditional jump.
+ */
+
+static void jump(BasicBlock *target)
+{
+    terminate(new Instruction(OP_JUMP, 0), {target});
+}
+
+
+/*
+ * Function:	count (private)
+ *
+ * Description:	Build an increment of the given profile counter of the
+ *		function, if generating a profile.
+ */
+
+static void count(unsigned probe)
+{
+    Instruction *address, *value;
+
+
+    if (profileGenerate.empty())
+	return;
+
+    address = instruction(OP_GLOBAL, SIZEOF_PTR);
+    address->_name = counter(function, probe);
+    value = instruction(OP_LOAD, SIZEOF_LONG, {address});
+    value = instruction(OP_ADD, SIZEOF_LONG, {value, constant(1, SIZEOF_LONG)});
+    instruction(OP_STORE, SIZEOF_LONG, {address, value});
+}
+
+
+/*
+ * Function:	variable (private)
+ *
+ * Description:	Return the number of the variable for the given symbol, or
+ *		-1 if the symbol is not a local scalar variable.
+ */
+
+static int variable(const Symbol *symbol)
+{
+    map<const Symbol *, unsigned>::iterator it;
+
+
+    if (symbol->_offset == 0 || !symbol->type().isScalar())
+	return -1;
+
+    it = variables.find(symbol);
+
+    if (it != variables.end())
+	return it->second;
+
+    variables[symbol] = graph->_variables.size();
+    graph->_variables.push_back(symbol->type().size());
+    return graph->_variables.size() - 1;
+}
+
+
+/*
+ * Function:	Expression::address
+ *
+ * Description:	Build the address of an expression, which must be an
+ *		lvalue, so only identifiers and dereferences override this.
+ */
+
+Instruction *Expression::address()
+{
+    abort();
+}
+
+
+/*
+ * Function:	Expression::store
+ *
+ * Description:	Build a store of the given value to this expression.
+ */
+
+void Expression::store(Instruction *value)
+{
+    instruction(OP_STORE, _type.size(), {address(), value});
+}
+
+
+/*
+ * Function:	Expression::condition
+ *
+ * Description:	Build jumping code for an expression used as a test, which
+ *		by default compares the value of the expression to zero.
+ */
+
+void Expression::condition(BasicBlock *ifTrue, BasicBlock *ifFalse)
+{
+    Instruction *value = evaluate();
+
+    if (!value->isCompare())
+	value = instruction(OP_NE, SIZEOF_INT, {value, constant(0, value->_size)});
+
+    terminate(new Instruction(OP_BRANCH, 0, {value}), {ifTrue, ifFalse});
+}
+
+
+/*
+ * Function:	Expression::build
+ *
+ * Description:	Build an expression statement, whose value is discarded.
+ */
+
+void Expression::build()
+{
+    evaluate();
+}
+
+
+/*
+ * Function:	Number::evaluate
+ *
+ * Description:	Build an integer literal.
+ */
+
+Instruction *Number::evaluate()
+{
+    return constant(strtoul(_value.c_str(), nullptr, 0), _type.size());
+}
+
+
+/*
+ * Function:	Number::condition
+ *
+ * Description:	Build jumping code for an integer literal, whose value is
+ *		known, so the jump is unconditional.
+ */
+
+void Number::condition(BasicBlock *ifTrue, BasicBlock *ifFalse)
+{
+    jump(strtoul(_value.c_str(), nullptr, 0) != 0 ? ifTrue : ifFalse);
+}
+
+
+/*
+ * Function:	String::address
+ *
+ * Description:	Build the address of a string literal.  The code generator
+ *		already writes the literals at the end of the file, so we
+ *		use it to create one and then just take its address.
+ */
+
+Instruction *String::address()
+{
+    Instruction *value;
+
+    generate();
+    value = instruction(OP_GLOBAL, SIZEOF_PTR);
+    value->_name = _operand;
+    return value;
+}
+
+
+/*
+ * Function:	String::evaluate
+ *
+ * Description:	Build a string literal, which as an array is its address.
+ */
+
+Instruction *String::evaluate()
+{
+    return address();
+}
+
+
+/*
+ * Function:	Identifier::address
+ *
+ * Description:	Build the address of an identifier, which is either in the
+ *		stack frame or global.  A local scalar variable whose
+ *		address is taken must then always live in memory.
+ */
+
+Instruction *Identifier::address()
+{
+    Instruction *value;
+
+
+    if (_symbol->_offset != 0) {
+	if (_symbol->type().isScalar())
+	    taken.insert(_symbol);
+
+	return instruction(OP_FRAME, SIZEOF_PTR, {}, _symbol->_offset);
+    }
+
+    value = instruction(OP_GLOBAL, SIZEOF_PTR);
+    value->_name = global_prefix + _symbol->name() + global_suffix;
+    return value;
+}
+
+
+/*
+ * Function:	Identifier::evaluate
+ *
+ * Description:	Build the value of an identifier.
+ */
+
+Instruction *Identifier::evaluate()
+{
+    int var = variable(_symbol);
+
+    if (var >= 0)
+	return instruction(OP_GET, _type.size(), {}, var);
+
+    if (_type.isArray())
+	return address();
+
+    return instruction(OP_LOAD, _type.size(), {address()});
+}
+
+
+/*
+ * Function:	Identifier::store
+ *
+ * Description:	Build an assignment to an identifier.
+ */
+
+void Identifier::store(Instruction *value)
+{
+    int var = variable(_symbol);
+
+    if (var >= 0)
+	instruction(OP_SET, 0, {value}, var);
+    else
+	Expression::store(value);
+}
+
+
+/*
+ * Function:	Call::evaluate
+ *
+ * Description:	Build a function call.  Calling a function declared with
+ *		an unspecified parameter list is recorded as the value of
+ *		the call, since we must then set %eax.
+ */
+
+Instruction *Call::evaluate()
+{
+    Instructions args;
+    Instruction *call;
+
+
+    for (unsigned i = 0; i < _args.size(); i ++)
+	args.push_back(_args[i]->evaluate());
+
+    count(_probe);
+    call = instruction(OP_CALL, _type.size(), args,
+	    _id->type().parameters() == nullptr);
+    call->_name = global_prefix + _id->name();
+
+    if (counts != nullptr)
+	graph->_calls[call] = (*counts)[_probe];
+
+    return call;
+}
+
+
+/*
+ * Function:	Not::evaluate
+ *
+ * Description:	Build a logical negation as a comparison with zero.
+ */
+
+Instruction *Not::evaluate()
+{
+    Instruction *value = _expr->evaluate();
+
+    return instruction(OP_EQ, _type.size(), {value, constant(0, value->_size)});
+}
+
+
+/*
+ * Function:	Not::condition
+ *
+ * Description:	Build jumping code for a logical negation.
+ */
+
+void Not::condition(BasicBlock *ifTrue, BasicBlock *ifFalse)
+{
+    _expr->condition(ifFalse, ifTrue);
+}
+
+
+/*
+ * Function:	Negate::evaluate
+ *
+ * Description:	Build an arithmetic negation.
+ */
+
+Instruction *Negate::evaluate()
+{
+    return instruction(OP_NEG, _type.size(), {_expr->evaluate()});
+}
+
+
+/*
+ * Function:	Dereference::address
+ *
+ * Description:	Build the address of a dereference, which is simply the
+ *		value of the pointer.
+ */
+
+Instruction *Dereference::address()
+{
+    return _expr->evaluate();
+}
+
+
+/*
+ * Function:	Dereference::evaluate
+ *
+ * Description:	Build a dereference as a load.
+ */
+
+Instruction *Dereference::evaluate()
+{
+    return instruction(OP_LOAD, _type.size(), {_expr->evaluate()});
+}
+
+
+/*
+ * Function:	Address::evaluate
+ *
+ * Description:	Build an address expression.
+ */
+
+Instruction *Address::evaluate()
+{
+    return _expr->address();
+}
+
+
+/*
+ * Function:	Cast::evaluate
+ *
+ * Description:	Build a cast, which either sign extends or truncates its
+ *		operand, or does nothing at all.
+ */
+
+Instruction *Cast::evaluate()
+{
+    Instruction *value = _expr->evaluate();
+    unsigned size = _type.size();
+
+
+    if (size > value->_size)
+	return instruction(OP_EXT, size, {value});
+
+    if (size < value->_size)
+	return instruction(OP_TRUNC, size, {value});
+
+    return value;
+}
+
+
+/*
+ * Function:	binary (private)
+ *
+ * Description:	Build a binary operator.  An integer literal operand takes
+ *		on the size of the other operand.
+ */
+
+static Instruction *binary(int opcode, unsigned size, Expression *left,
+	Expression *right)
+{
+    Instruction *a = left->evaluate();
+    Instruction *b = right->evaluate();
+
+    if (a->_opcode == OP_CONST)
+	a->_size = b->_size;
+    else if (b->_opcode == OP_CONST)
+	b->_size = a->_size;
+
+    return instruction(opcode, size, {a, b});
+}
+
+
+/*
+ * Function:	Multiply::evaluate
+ *
+ * Description:	Build a multiplication.
+ */
+
+Instruction *Multiply::evaluate()
+{
+    return binary(OP_MUL, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	Divide::evaluate
+ *
+ * Description:	Build a division.
+ */
+
+Instruction *Divide::evaluate()
+{
+    return binary(OP_DIV, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	Remainder::evaluate
+ *
+ * Description:	Build a remainder.
+ */
+
+Instruction *Remainder::evaluate()
+{
+    return binary(OP_REM, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	Add::evaluate
+ *
+ * Description:	Build an addition.
+ */
+
+Instruction *Add::evaluate()
+{
+    return binary(OP_ADD, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	Subtract::evaluate
+ *
+ * Description:	Build a subtraction.
+ */
+
+Instruction *Subtract::evaluate()
+{
+    return binary(OP_SUB, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	LessThan::evaluate
+ *
+ * Description:	Build binary <.
+ */
+
+Instruction *LessThan::evaluate()
+{
+    return binary(OP_LT, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	GreaterThan::evaluate
+ *
+ * Description:	Build binary >.
+ */
+
+Instruction *GreaterThan::evaluate()
+{
+    return binary(OP_GT, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	LessOrEqual::evaluate
+ *
+ * Description:	Build binary <=.
+ */
+
+Instruction *LessOrEqual::evaluate()
+{
+    return binary(OP_LE, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	GreaterOrEqual::evaluate
+ *
+ * Description:	Build binary >=.
+ */
+
+Instruction *GreaterOrEqual::evaluate()
+{
+    return binary(OP_GE, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	Equal::evaluate
+ *
+ * Description:	Build binary ==.
+ */
+
+Instruction *Equal::evaluate()
+{
+    return binary(OP_EQ, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	NotEqual::evaluate
+ *
+ * Description:	Build binary !=.
+ */
+
+Instruction *NotEqual::evaluate()
+{
+    return binary(OP_NE, _type.size(), _left, _right);
+}
+
+
+/*
+ * Function:	logical (private)
+ *
+ * Description:	Build the value of a logical expression from its jumping
+ *		code, using a new variable that is set to one or zero on
+ *		each path.  The variable is later replaced by a phi
+ *		function.
+ */
+
+static Instruction *logical(Expression *expr)
+{
+    BasicBlock *yes = create(), *no = create(), *exit = create();
+    unsigned var = graph->_variables.size();
+
+
+    graph->_variables.push_back(SIZEOF_INT);
+    expr->condition(yes, no);
+
+    block = yes;
+    instruction(OP_SET, 0, {constant(1, SIZEOF_INT)}, var);
+    jump(exit);
+
+    block = no;
+    instruction(OP_SET, 0, {constant(0, SIZEOF_INT)}, var);
+    jump(exit);
+
+    block = exit;
+    return instruction(OP_GET, SIZEOF_INT, {}, var);
+}
+
+
+/*
+ * Function:	LogicalAnd::evaluate
+ *
+ * Description:	Build the value of binary &&.
+ */
+
+Instruction *LogicalAnd::evaluate()
+{
+    return logical(this);
+}
+
+
+/*
+ * Function:	LogicalAnd::condition
+ *
+ * Description:	Build short-circuit jumping code for binary &&.
+ */
+
+void LogicalAnd::condition(BasicBlock *ifTrue, BasicBlock *ifFalse)
+{
+    BasicBlock *next = create();
+
+    _left->condition(next, ifFalse);
+    block = next;
+    _right->condition(ifTrue, ifFalse);
+}
+
+
+/*
+ * Function:	LogicalOr::evaluate
+ *
+ * Description:	Build the value of binary ||.
+ */
+
+Instruction *LogicalOr::evaluate()
+{
+    return logical(this);
+}
+
+
+/*
+ * Function:	LogicalOr::condition
+ *
+ * Description:	Build short-circuit jumping code for binary ||.
+ */
+
+void LogicalOr::condition(BasicBlock *ifTrue, BasicBlock *ifFalse)
+{
+    BasicBlock *next = create();
+
+    _left->condition(ifTrue, next);
+    block = next;
+    _right->condition(ifTrue, ifFalse);
+}
+
+
+/*
+ * Function:	Assignment::build
+ *
+ * Description:	Build an assignment statement.  As in the code generator,
+ *		the pointer of a dereference is evaluated first.
+ */
+
+void Assignment::build()
+{
+    Expression *pointer = _left->getDereference();
+    Instruction *address;
+
+
+    if (pointer != nullptr) {
+	address = pointer->evaluate();
+	instruction(OP_STORE, _left->type().size(), {address, _right->evaluate()});
+    } else
+	_left->store(_right->evaluate());
+}
+
+
+/*
+ * Function:	Return::build
+ *
+ * Description:	Build a return statement.
+ */
+
+void Return::build()
+{
+    terminate(new Instruction(OP_RETURN, 0, {_expr->evaluate()}));
+}
+
+
+/*
+ * Function:	statement (private)
+ *
+ * Description:	Build a statement, whose instructions are marked with the
+ *		line on which it starts.
+ */
+
+static void statement(Statement *stmt)
+{
+    line = stmt->_line;
+    stmt->build();
+}
+
+
+/*
+ * Function:	Block::build
+ *
+ * Description:	Build each statement of a block.
+ */
+
+void Block::build()
+{
+    for (unsigned i = 0; i < _stmts.size(); i ++)
+	statement(_stmts[i]);
+}
+
+
+/*
+ * Function:	While::build
+ *
+ * Description:	Build a while loop, with the test at the bottom.  The test
+ *		is also copied to the top to skip the loop entirely, so
+ *		that the body is known to execute at least once whenever
+ *		the loop is entered.
+ */
+
+void While::build()
+{
+    BasicBlock *body = create(), *exit = create();
+
+    if (counts != nullptr) {
+	body->_count = (*counts)[_probe + 1];
+	exit->_count = (*counts)[_probe];
+    }
+
+    count(_probe);
+    _expr->condition(body, exit);
+
+    block = body;
+    count(_probe + 1);
+    statement(_stmt);
+    line = _line;
+    _expr->condition(body, exit);
+    block = exit;
+}
+
+
+/*
+ * Function:	If::build
+ *
+ * Description:	Build an if-then or if-then-else statement.  With a
+ *		profile, each branch records how often it was taken, so
+ *		that the more frequent one can later be laid out to follow
+ *		the test.  The code after the statement is executed as
+ *		often as the branches that do not return.
+ */
+
+void If::build()
+{
+    BasicBlock *thenBlock = create(), *elseBlock = create(), *exit = create();
+
+    if (counts != nullptr) {
+	thenBlock->_count = (*counts)[_probe + 1];
+	elseBlock->_count = (*counts)[_probe] - (*counts)[_probe + 1];
+	exit->_count = 0;
+    }
+
+    count(_probe);
+    _expr->condition(thenBlock, elseBlock);
+
+    block = thenBlock;
+    count(_probe + 1);
+    statement(_thenStmt);
+
+    if (counts != nullptr && !block->_predecessors.empty())
+	exit->_count += thenBlock->_count;
+
+    jump(exit);
+    block = elseBlock;
+
+    if (_elseStmt != nullptr)
+	statement(_elseStmt);
+
+    if (counts != nullptr && !block->_predecessors.empty())
+	exit->_count += elseBlock->_count;
+
+    jump(exit);
+    block = exit;
+}
+
+
+/*
+ * Function:	demote (private)
+ *
+ * Description:	Rewrite the accesses to any local scalar variable whose
+ *		address was taken as loads and stores of its stack slot.
+ */
+
+static void demote()
+{
+    map<const Symbol *, unsigned>::iterator it;
+    map<unsigned, int> offsets;
+
+
+    for (it = variables.begin(); it != variables.end(); ++ it)
+	if (taken.count(it->first) > 0)
+	    offsets[it->second] = it->first->_offset;
+
+    if (offsets.empty())
+	return;
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instruction *in = instructions[j];
+
+	    if ((in->_opcode == OP_GET || in->_opcode == OP_SET) &&
+		    offsets.count(in->_value) > 0) {
+		Instruction *frame = new Instruction(OP_FRAME, SIZEOF_PTR, {},
+			offsets[in->_value]);
+
+		graph->_blocks[i]->insert(frame, j ++);
+
+		if (in->_opcode == OP_GET) {
+		    in->_opcode = OP_LOAD;
+		    in->_operands = {frame};
+		} else {
+		    in->_opcode = OP_STORE;
+		    in->_size = graph->_variables[in->_value];
+		    in->_operands.insert(in->_operands.begin(), frame);
+		}
+
+		in->_value = 0;
+	    }
+	}
+    }
+}
+
+
+/*
+ * Function:	recurse (private)
+ *
+ * Description:	Turn each tail call of the function to itself into a
+ *		loop, by assigning the arguments to the parameters and
+ *		jumping back to the start of the body.  If any variable
+ *		lives in memory, then its address may be passed to the
+ *		call, so the stack frame cannot be reused and we do
+ *		nothing.
+ */
+
+static void recurse(const Symbols &params, BasicBlock *start)
+{
+    string name = global_prefix + graph->_id->name();
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++)
+	for (unsigned j = 0; j < graph->_blocks[i]->_instructions.size(); j ++)
+	    if (graph->_blocks[i]->_instructions[j]->_opcode == OP_FRAME)
+		return;
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+	unsigned n = instructions.size();
+	Instructions args;
+	Instruction *call;
+
+	if (n < 2 || !graph->_blocks[i]->isTail(n - 2))
+	    continue;
+
+	call = instructions[n - 2];
+
+	if (call->_name != name || call->_operands.size() != params.size())
+	    continue;
+
+	block = graph->_blocks[i];
+	instructions.resize(n - 2);
+
+	for (unsigned k = 0; k < block->_successors.size(); k ++)
+	    block->_successors[k]->disconnect(block);
+
+	block->_successors.clear();
+
+	for (unsigned k = 0; k < params.size(); k ++) {
+	    Instruction *arg = call->_operands[k];
+	    unsigned size = params[k]->type().size();
+
+	    if (size > arg->_size)
+		arg = instruction(OP_EXT, size, {arg});
+	    else if (size < arg->_size)
+		arg = instruction(OP_TRUNC, size, {arg});
+
+	    args.push_back(arg);
+	}
+
+	for (unsigned k = 0; k < params.size(); k ++)
+	    instruction(OP_SET, 0, {args[k]}, variable(params[k]));
+
+	block->append(new Instruction(OP_JUMP, 0));
+	block->_successors.push_back(start);
+	start->_predecessors.push_back(block);
+    }
+}
+
+
+/*
+ * Function:	Function::build
+ *
+ * Description:	Build the flow graph for this function, which is then kept
+ *		so that it can be integrated into its callers before it is
+ *		optimized and written as assembly code.  The parameters
+ *		passed in registers are copied to their variables on entry,
+ *		after which the body starts in a new block so that tail
+ *		recursion can jump back to it, and we return if control
+ *		reaches the end of the function.
+ */
+
+void Function::build()
+{
+    const Symbols &symbols = _body->declarations()->symbols();
+    unsigned numParams = _id->type().parameters()->size();
+    BasicBlock *start;
+    int offset = 0;
+
+
+    allocate(offset);
+
+    graph = new Graph(_id);
+    graph->_offset = offset;
+    graph->_line = _line;
+    block = graph->_entry;
+    variables.clear();
+    taken.clear();
+    function = _id->name();
+    counts = profile(this);
+    line = _line;
+
+    if (counts != nullptr)
+	graph->_count = (*counts)[0];
+
+    for (unsigned i = 0; i < numParams; i ++) {
+	Identifier param(symbols[i]);
+	param.store(instruction(OP_PARAM, symbols[i]->type().size(), {}, i));
+    }
+
+    start = create();
+    jump(start);
+    block = start;
+
+    if (counts != nullptr)
+	graph->_entry->_count = start->_count = (*counts)[0];
+
+    count(0);
+    _body->build();
+    terminate(new Instruction(OP_RETURN, 0));
+    recurse(Symbols(symbols.begin(), symbols.begin() + numParams), start);
+    demote();
+
+    _graph = graph;
+}
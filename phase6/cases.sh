@@ -97,3 +97,23 @@ echo Tree: Passed✅
 else
 echo Tree: Failed❌
 fi
+
+./scc < examples/vector.c > examples/vector.s
+gcc -o vector examples/vector.s
+./vector > examples/vector-mine.out
+
+if diff examples/vector.out examples/vector-mine.out; then
+echo Vector: Passed✅
+else
+echo Vector: Failed❌
+fi
+
+./scc < examples/divide.c > examples/divide.s
+gcc -o divide examples/divide.s
+./divide > examples/divide-mine.out
+
+if diff examples/divide.out examples/divide-mine.out; then
+echo Divide: Passed✅
+else
+echo Divide: Failed❌
+fi
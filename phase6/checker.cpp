@@ -8,8 +8,20 @@
  *		- inserting an undeclared symbol with the error type
  *		- scaling the operands and results of pointer arithmetic
  *		- explicit type conversions and promotions
+ *		- folding of operations on literals and identities
+ *
+ *		An operation whose operands are literals is folded into a
+ *		literal as the tree is constructed, with int arithmetic
+ *		wrapping at 32 bits and long arithmetic at 64 bits, as the
+ *		generated code would.  Division by zero and the overflow
+ *		of a division, which trap at run time, are left alone, as
+ *		is a result too large for an immediate operand.  Adding
+ *		zero, multiplying or dividing by one, and scaling by the
+ *		size of a character are dropped, so that indexing with a
+ *		literal or by a sizeof expression is just an offset.
  */
 
+# include <climits>
 # include <iostream>
 # include "lexer.h"
 # include "checker.h"
@@ -50,6 +62,83 @@ static void debug(const string &str, const Type &t1, const Type &t2)
 }
 
 
+/*
+ * Function:	truncate (private)
+ *
+ * Description:	Return the given value truncated to the size of the given
+ *		numeric type and sign extended, as the machine would leave
+ *		it in a register.
+ */
+
+static long truncate(long value, const Type &type)
+{
+    if (type.size() == 1)
+	return (signed char) value;
+
+    if (type.size() == 4)
+	return (int) value;
+
+    return value;
+}
+
+
+/*
+ * Function:	literal (private)
+ *
+ * Description:	Return whether the given expression is an integer literal,
+ *		and if so, its value as an object of its type.
+ */
+
+static bool literal(Expression *expr, long &value)
+{
+    if (!expr->isLiteral(value))
+	return false;
+
+    value = truncate(value, expr->type());
+    return true;
+}
+
+
+/*
+ * Function:	number (private)
+ *
+ * Description:	Return a literal of the given numeric type with the given
+ *		value truncated to that type, or null if the value does
+ *		not fit in an immediate operand, which has only 32 bits.
+ */
+
+static Expression *number(long value, const Type &type)
+{
+    value = truncate(value, type);
+
+    if (value < INT_MIN || value > INT_MAX)
+	return nullptr;
+
+    return new Number(value, type);
+}
+
+
+/*
+ * Function:	cast (private)
+ *
+ * Description:	Return the given expression converted to the given type,
+ *		converting a literal at compile time if possible.
+ */
+
+static Expression *cast(const Type &type, Expression *expr)
+{
+    Expression *result;
+    long value;
+
+
+    if (type.isNumeric() && literal(expr, value))
+	if ((result = number(value, type)) != nullptr)
+	    return result;
+
+    return new Cast(type, expr);
+}
+
+
 /*
  * Function:	promote
  *
@@ -67,7 +156,7 @@ static Type promote(Expression *&expr)
 
     } else if (expr->type() == character) {
 	debug("promoting", character, integer);
-	expr = new Cast(integer, expr);
+	expr = cast(integer, expr);
     }
 
     return expr->type();
@@ -88,7 +177,7 @@ static Type convert(Expression *&expr, Type type)
 
     if (expr->type() != type && expr->type().isNumeric() && type.isNumeric()) {
 	debug("assigning", expr->type(), type);
-	expr = new Cast(type, expr);
+	expr = cast(type, expr);
     }
 
     return expr->type();
@@ -108,13 +197,121 @@ static Type extend(Expression *&expr, Type type)
     if (expr->type() != type && expr->type().isNumeric() && type.isNumeric())
 	if (expr->type() == character || type == longInt) {
 	    debug("extending", expr->type(), type);
-	    expr = new Cast(type, expr);
+	    expr = cast(type, expr);
 	}
 
     return promote(expr);
 }
 
 
+/*
+ * Function:	fold (private)
+ *
+ * Description:	Return the literal that results from the given binary
+ *		operation of the given type on two literals, or null if
+ *		the operation cannot be folded.  The arithmetic is done
+ *		unsigned, so that it wraps rather than overflows.
+ */
+
+static Expression *
+fold(int op, Expression *left, Expression *right, const Type &type)
+{
+    unsigned long x, y, value;
+    long a, b;
+
+
+    if (type == error || !literal(left, a) || !literal(right, b))
+	return nullptr;
+
+    x = a;
+    y = b;
+
+    switch (op) {
+    case PLUS: value = x + y; break;
+    case MINUS: value = x - y; break;
+    case STAR: value = x * y; break;
+    case LTN: value = a < b; break;
+    case GTN: value = a > b; break;
+    case LEQ: value = a <= b; break;
+    case GEQ: value = a >= b; break;
+    case EQL: value = a == b; break;
+    case NEQ: value = a != b; break;
+    case AND: value = a && b; break;
+    case OR: value = a || b; break;
+
+    case DIV:
+    case REM:
+	if (b == 0 || (b == -1 && a != 0 && truncate(-x, type) == a))
+	    return nullptr;
+
+	value = op == DIV ? a / b : a % b;
+	break;
+
+    default:
+	return nullptr;
+    }
+
+    return number(value, type);
+}
+
+
+/*
+ * Function:	simplify (private)
+ *
+ * Description:	Return the simplest expression equivalent to the given
+ *		binary operation of the given type: a literal if it can be
+ *		folded, or one of its operands if the other is an identity
+ *		for the operation, or the left operand of a logical
+ *		operation if it alone decides the result.  Otherwise,
+ *		return null.
+ */
+
+static Expression *
+simplify(int op, Expression *left, Expression *right, const Type &type)
+{
+    Expression *expr;
+    long a, b;
+
+
+    if ((expr = fold(op, left, right, type)) != nullptr || type == error)
+	return expr;
+
+    if (literal(left, a)) {
+	if ((op == PLUS && a == 0) || (op == STAR && a == 1))
+	    expr = right;
+	else if ((op == AND && a == 0) || (op == OR && a != 0))
+	    return number(op == OR, type);
+
+    } else if (literal(right, b)) {
+	if ((op == PLUS || op == MINUS) && b == 0)
+	    expr = left;
+	else if ((op == STAR || op == DIV) && b == 1)
+	    expr = left;
+    }
+
+    if (expr != nullptr && expr->type() != type)
+	return nullptr;
+
+    return expr;
+}
+
+
+/*
+ * Function:	scale (private)
+ *
+ * Description:	Return the given index of type long scaled by the given
+ *		size, for use in pointer arithmetic.
+ */
+
+static Expression *scale(Expression *expr, unsigned size)
+{
+    Expression *factor = new Number(size);
+    Expression *result = simplify(STAR, expr, factor, longInt);
+
+    return result != nullptr ? result : new Multiply(expr, factor, longInt);
+}
+
+
 /*
  * Function:	openScope
  *
@@ -312,8 +509,11 @@ Expression *checkArray(Expression *left, Expression *right)
     const Type &t2 = extend(right, longInt);
     Type result = error;
 
-    right = new Multiply(right, new Number(t1.deref().size()), longInt);
-    Expression *expr = new Add(left, right, t1);
+    right = scale(right, t1.deref().size());
+    Expression *expr = simplify(PLUS, left, right, t1);
+
+    if (expr == nullptr)
+	expr = new Add(left, right, t1);
 
     if (t1 != error && t2 != error) {
 	if (t1.isPointer() && t2 == longInt)
@@ -337,6 +537,8 @@ Expression *checkNot(Expression *expr)
 {
     const Type &t = promote(expr);
     Type result = error;
+    Expression *folded;
+    long value;
 
 
     if (t != error) {
@@ -346,6 +548,10 @@ Expression *checkNot(Expression *expr)
 	    report(invalid_operand, "!");
     }
 
+    if (result != error && literal(expr, value))
+	if ((folded = number(!value, result)) != nullptr)
+	    return folded;
+
     return new Not(expr, result);
 }
 
@@ -361,6 +567,8 @@ Expression *checkNegate(Expression *expr)
 {
     const Type &t = promote(expr);
     Type result = error;
+    Expression *folded;
+    long value;
 
 
     if (t != error) {
@@ -370,6 +578,10 @@ Expression *checkNegate(Expression *expr)
 	    report(invalid_operand, "-");
     }
 
+    if (result != error && literal(expr, value))
+	if ((folded = number(-(unsigned long) value, result)) != nullptr)
+	    return folded;
+
     return new Negate(expr, result);
 }
 
@@ -479,7 +691,7 @@ Expression *checkCast(const Type &type, Expression *expr)
 	*/
 
 	if (result != error && result != type)
-	    expr = new Cast(type, expr);
+	    expr = cast(type, expr);
     }
 
     return expr;
@@ -521,7 +733,12 @@ static Type checkMult(Expression *&left, Expression *&right, const string &op)
 Expression *checkMultiply(Expression *left, Expression *right)
 {
     Type t = checkMult(left, right, "*");
-    return new Multiply(left, right, t);
+    Expression *expr = simplify(STAR, left, right, t);
+
+    if (expr == nullptr || expr->lvalue())
+	expr = new Multiply(left, right, t);
+
+    return expr;
 }
 
 
@@ -534,7 +751,12 @@ Expression *checkMultiply(Expression *left, Expression *right)
 Expression *checkDivide(Expression *left, Expression *right)
 {
     Type t = checkMult(left, right, "/");
-    return new Divide(left, right, t);
+    Expression *expr = simplify(DIV, left, right, t);
+
+    if (expr == nullptr || expr->lvalue())
+	expr = new Divide(left, right, t);
+
+    return expr;
 }
 
 /*
@@ -546,7 +768,9 @@ Expression *checkDivide(Expression *left, Expression *right)
 Expression *checkRemainder(Expression *left, Expression *right)
 {
     Type t = checkMult(left, right, "%");
-    return new Remainder(left, right, t);
+    Expression *expr = simplify(REM, left, right, t);
+
+    return expr != nullptr ? expr : new Remainder(left, right, t);
 }
 
 
@@ -562,6 +786,7 @@ Expression *checkRemainder(Expression *left, Expression *right)
 
 Expression *checkAdd(Expression *left, Expression *right)
 {
+    Expression *tree;
     Type t1 = left->type();
     Type t2 = right->type();
     Type result = error;
@@ -576,20 +801,25 @@ Expression *checkAdd(Expression *left, Expression *right)
 	} else if (t1.isPointer() && t2.isNumeric()) {
 	    t1 = promote(left);
 	    t2 = extend(right, longInt);
-	    right = new Multiply(right, new Number(t1.deref().size()), longInt);
+	    right = scale(right, t1.deref().size());
 	    result = t1;
 
 	} else if (t1.isNumeric() && t2.isPointer()) {
 	    t1 = extend(left, longInt);
 	    t2 = promote(right);
-	    left = new Multiply(left, new Number(t2.deref().size()), longInt);
+	    left = scale(left, t2.deref().size());
 	    result = t2;
 
 	} else
 	    report(invalid_operands, "+");
     }
 
-    return new Add(left, right, result);
+    tree = simplify(PLUS, left, right, result);
+
+    if (tree == nullptr || tree->lvalue())
+	tree = new Add(left, right, result);
+
+    return tree;
 }
 
 
@@ -627,16 +857,19 @@ Expression *checkSubtract(Expression *left, Expression *right)
 	} else if (t1.isPointer() && t2.isNumeric()) {
 	    t1 = promote(left);
 	    t2 = extend(right, longInt);
-	    right = new Multiply(right, new Number(t1.deref().size()), longInt);
+	    right = scale(right, t1.deref().size());
 	    result = t1;
 
 	} else
 	    report(invalid_operands, "-");
     }
 
-    tree = new Subtract(left, right, result);
+    tree = simplify(MINUS, left, right, result);
 
-    if (t1.isPointer() && t1 == t2)
+    if (tree == nullptr || tree->lvalue())
+	tree = new Subtract(left, right, result);
+
+    if (t1.isPointer() && t1 == t2 && t1.deref().size() != 1)
 	tree = new Divide(tree, new Number(t1.deref().size()), longInt);
 
     return tree;
@@ -679,7 +912,9 @@ Type checkCompare(Expression *&left, Expression *&right, const string &op)
 Expression *checkEqual(Expression *left, Expression *right)
 {
     Type t = checkCompare(left, right, "==");
-    return new Equal(left, right, t);
+    Expression *expr = simplify(EQL, left, right, t);
+
+    return expr != nullptr ? expr : new Equal(left, right, t);
 }
 
 
@@ -692,7 +927,9 @@ Expression *checkEqual(Expression *left, Expression *right)
 Expression *checkNotEqual(Expression *left, Expression *right)
 {
     Type t = checkCompare(left, right, "!=");
-    return new NotEqual(left, right, t);
+    Expression *expr = simplify(NEQ, left, right, t);
+
+    return expr != nullptr ? expr : new NotEqual(left, right, t);
 }
 
 
@@ -705,7 +942,9 @@ Expression *checkNotEqual(Expression *left, Expression *right)
 Expression *checkLessThan(Expression *left, Expression *right)
 {
     Type t = checkCompare(left, right, "<");
-    return new LessThan(left, right, t);
+    Expression *expr = simplify(LTN, left, right, t);
+
+    return expr != nullptr ? expr : new LessThan(left, right, t);
 }
 
 
@@ -718,7 +957,9 @@ Expression *checkLessThan(Expression *left, Expression *right)
 Expression *checkGreaterThan(Expression *left, Expression *right)
 {
     Type t = checkCompare(left, right, ">");
-    return new GreaterThan(left, right, t);
+    Expression *expr = simplify(GTN, left, right, t);
+
+    return expr != nullptr ? expr : new GreaterThan(left, right, t);
 }
 
 
@@ -731,7 +972,9 @@ Expression *checkGreaterThan(Expression *left, Expression *right)
 Expression *checkLessOrEqual(Expression *left, Expression *right)
 {
     Type t = checkCompare(left, right, "<=");
-    return new LessOrEqual(left, right, t);
+    Expression *expr = simplify(LEQ, left, right, t);
+
+    return expr != nullptr ? expr : new LessOrEqual(left, right, t);
 }
 
 
@@ -744,7 +987,9 @@ Expression *checkLessOrEqual(Expression *left, Expression *right)
 Expression *checkGreaterOrEqual(Expression *left, Expression *right)
 {
     Type t = checkCompare(left, right, ">=");
-    return new GreaterOrEqual(left, right, t);
+    Expression *expr = simplify(GEQ, left, right, t);
+
+    return expr != nullptr ? expr : new GreaterOrEqual(left, right, t);
 }
 
 
@@ -784,7 +1029,9 @@ Type checkLogical(Expression *&left, Expression *&right, const string &op)
 Expression *checkLogicalAnd(Expression *left, Expression *right)
 {
     Type t = checkLogical(left, right, "&&");
-    return new LogicalAnd(left, right, t);
+    Expression *expr = simplify(AND, left, right, t);
+
+    return expr != nullptr ? expr : new LogicalAnd(left, right, t);
 }
 
 
@@ -797,7 +1044,9 @@ Expression *checkLogicalAnd(Expression *left, Expression *right)
 Expression *checkLogicalOr(Expression *left, Expression *right)
 {
     Type t = checkLogical(left, right, "||");
-    return new LogicalOr(left, right, t);
+    Expression *expr = simplify(OR, left, right, t);
+
+    return expr != nullptr ? expr : new LogicalOr(left, right, t);
 }
 
 
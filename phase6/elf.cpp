@@ -0,0 +1,280 @@
+/*
+ * File:	elf.cpp
+ *
+ * Description:	This file contains the function definitions for writing
+ *		an assembled object as an ELF64 relocatable object file for
+ *		x86-64, which can then be linked by the system linker.
+ *
+ *		The file is laid out as the header, the contents of each
+ *		section, the symbol and string tables, the relocation
+ *		sections, and finally the section header table.  Local
+ *		labels are not written to the symbol table.  Instead,
+ *		relocations against them are made relative to the symbol
+ *		for their section, as the system assembler does.
+ */
+
+# include <elf.h>
+# include <cstring>
+# include "assembler.h"
+
+using namespace std;
+
+
+/*
+ * Function:	strtab (private)
+ *
+ * Description:	Add a string to a string table and return its offset.
+ */
+
+static unsigned strtab(string &table, const string &s)
+{
+    unsigned offset = table.size();
+
+    table += s;
+    table += '\0';
+    return offset;
+}
+
+
+/*
+ * Function:	pad (private)
+ *
+ * Description:	Pad the file contents to the given alignment.
+ */
+
+static void pad(string &file, unsigned long alignment)
+{
+    while (file.size() % alignment != 0)
+	file += '\0';
+}
+
+
+/*
+ * Function:	append (private)
+ *
+ * Description:	Append raw bytes to the file contents.
+ */
+
+static void append(string &file, const void *data, unsigned long size)
+{
+    file.append((const char *) data, size);
+}
+
+
+/*
+ * Function:	writeObject
+ *
+ * Description:	Write the given object as an ELF relocatable file.
+ */
+
+void writeObject(const Object &object, ostream &out)
+{
+    const vector<Section> &sections = object.sections;
+    vector<Elf64_Shdr> headers;
+    vector<Elf64_Sym> symbols;
+    vector<unsigned> indices(object.symbols.size(), 0);
+    string file, names, shnames;
+    unsigned firstGlobal, symtab;
+    Elf64_Ehdr ehdr;
+    Elf64_Shdr shdr;
+    Elf64_Sym sym;
+
+
+    /* The section header table begins with a null entry. */
+
+    memset(&shdr, 0, sizeof(shdr));
+    headers.push_back(shdr);
+    strtab(shnames, "");
+    strtab(names, "");
+
+
+    /* The contents of each section, directly after the file header. */
+
+    file.assign(sizeof(Elf64_Ehdr), '\0');
+
+    for (unsigned i = 0; i < sections.size(); i ++) {
+	const Section &s = sections[i];
+
+	memset(&shdr, 0, sizeof(shdr));
+	shdr.sh_name = strtab(shnames, s.name);
+	shdr.sh_type = s.nobits ? SHT_NOBITS : SHT_PROGBITS;
+	shdr.sh_flags = (s.debug ? 0 : SHF_ALLOC) | (s.write ? SHF_WRITE : 0) |
+	    (s.exec ? SHF_EXECINSTR : 0);
+	shdr.sh_addralign = s.align;
+	shdr.sh_size = s.size;
+
+	pad(file, s.align);
+	shdr.sh_offset = file.size();
+
+	if (!s.nobits)
+	    append(file, s.bytes.data(), s.bytes.size());
+
+	headers.push_back(shdr);
+    }
+
+
+    /* The symbol table: the null symbol, a symbol for each section,
+       the other local symbols, and then the global symbols. */
+
+    memset(&sym, 0, sizeof(sym));
+    symbols.push_back(sym);
+
+    for (unsigned i = 0; i < sections.size(); i ++) {
+	memset(&sym, 0, sizeof(sym));
+	sym.st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+	sym.st_shndx = i + 1;
+	symbols.push_back(sym);
+    }
+
+    for (int pass = 0; pass < 2; pass ++) {
+	firstGlobal = pass == 1 ? symbols.size() : 0;
+
+	for (unsigned i = 0; i < object.symbols.size(); i ++) {
+	    const ObjectSymbol &s = object.symbols[i];
+	    bool global = s.global || s.section == SYM_UNDEFINED ||
+		s.section == SYM_COMMON;
+	    int type = STT_NOTYPE;
+
+	    if (global != (pass == 1))
+		continue;
+
+	    if (!global && (s.section == SYM_ABSOLUTE ||
+			s.name.compare(0, 2, ".L") == 0))
+		continue;
+
+	    if (s.section == SYM_COMMON)
+		type = STT_OBJECT;
+	    else if (s.section >= 0)
+		type = s.function || sections[s.section].exec ? STT_FUNC :
+		    STT_OBJECT;
+
+	    memset(&sym, 0, sizeof(sym));
+	    sym.st_name = strtab(names, s.name);
+	    sym.st_info = ELF64_ST_INFO(global ? STB_GLOBAL : STB_LOCAL, type);
+	    sym.st_value = s.value;
+	    sym.st_size = s.size;
+
+	    if (s.section == SYM_UNDEFINED)
+		sym.st_shndx = SHN_UNDEF;
+	    else if (s.section == SYM_COMMON)
+		sym.st_shndx = SHN_COMMON;
+	    else if (s.section == SYM_ABSOLUTE)
+		sym.st_shndx = SHN_ABS;
+	    else
+		sym.st_shndx = s.section + 1;
+
+	    indices[i] = symbols.size();
+	    symbols.push_back(sym);
+	}
+    }
+
+    symtab = headers.size();
+    pad(file, 8);
+    memset(&shdr, 0, sizeof(shdr));
+    shdr.sh_name = strtab(shnames, ".symtab");
+    shdr.sh_type = SHT_SYMTAB;
+    shdr.sh_offset = file.size();
+    shdr.sh_size = symbols.size() * sizeof(Elf64_Sym);
+    shdr.sh_link = symtab + 1;
+    shdr.sh_info = firstGlobal;
+    shdr.sh_addralign = 8;
+    shdr.sh_entsize = sizeof(Elf64_Sym);
+    append(file, symbols.data(), shdr.sh_size);
+    headers.push_back(shdr);
+
+    memset(&shdr, 0, sizeof(shdr));
+    shdr.sh_name = strtab(shnames, ".strtab");
+    shdr.sh_type = SHT_STRTAB;
+    shdr.sh_offset = file.size();
+    shdr.sh_size = names.size();
+    shdr.sh_addralign = 1;
+    append(file, names.data(), names.size());
+    headers.push_back(shdr);
+
+
+    /* The relocations for each section that has any. */
+
+    for (unsigned i = 0; i < sections.size(); i ++) {
+	const vector<Relocation> &relocs = sections[i].relocs;
+	static const unsigned types[] = {
+	    R_X86_64_PC32, R_X86_64_PLT32, R_X86_64_32, R_X86_64_32S,
+	    R_X86_64_64,
+	};
+
+	if (relocs.empty())
+	    continue;
+
+	pad(file, 8);
+	memset(&shdr, 0, sizeof(shdr));
+	shdr.sh_name = strtab(shnames, ".rela" + sections[i].name);
+	shdr.sh_type = SHT_RELA;
+	shdr.sh_flags = SHF_INFO_LINK;
+	shdr.sh_offset = file.size();
+	shdr.sh_link = symtab;
+	shdr.sh_info = i + 1;
+	shdr.sh_addralign = 8;
+	shdr.sh_entsize = sizeof(Elf64_Rela);
+
+	for (unsigned j = 0; j < relocs.size(); j ++) {
+	    unsigned k = object.table.find(relocs[j].symbol)->second;
+	    const ObjectSymbol &s = object.symbols[k];
+	    Elf64_Rela rela;
+
+	    rela.r_offset = relocs[j].offset;
+	    rela.r_addend = relocs[j].addend;
+
+	    if (indices[k] == 0 && s.section >= 0) {
+		rela.r_info = ELF64_R_INFO(s.section + 1, types[relocs[j].type]);
+		rela.r_addend += s.value;
+	    } else
+		rela.r_info = ELF64_R_INFO(indices[k], types[relocs[j].type]);
+
+	    append(file, &rela, sizeof(rela));
+	}
+
+	shdr.sh_size = relocs.size() * sizeof(Elf64_Rela);
+	headers.push_back(shdr);
+    }
+
+
+    /* An empty note marks the stack as non-executable. */
+
+    memset(&shdr, 0, sizeof(shdr));
+    shdr.sh_name = strtab(shnames, ".note.GNU-stack");
+    shdr.sh_type = SHT_PROGBITS;
+    shdr.sh_offset = file.size();
+    shdr.sh_addralign = 1;
+    headers.push_back(shdr);
+
+    memset(&shdr, 0, sizeof(shdr));
+    shdr.sh_name = strtab(shnames, ".shstrtab");
+    shdr.sh_type = SHT_STRTAB;
+    shdr.sh_offset = file.size();
+    shdr.sh_size = shnames.size();
+    shdr.sh_addralign = 1;
+    append(file, shnames.data(), shnames.size());
+    headers.push_back(shdr);
+
+
+    /* The section header table, and finally the file header. */
+
+    pad(file, 8);
+    memset(&ehdr, 0, sizeof(ehdr));
+    memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    ehdr.e_type = ET_REL;
+    ehdr.e_machine = EM_X86_64;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_shoff = file.size();
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = headers.size();
+    ehdr.e_shstrndx = headers.size() - 1;
+
+    append(file, headers.data(), headers.size() * sizeof(Elf64_Shdr));
+    memcpy(&file[0], &ehdr, sizeof(ehdr));
+    out.write(file.data(), file.size());
+}
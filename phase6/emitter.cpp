@@ -0,0 +1,1803 @@
+/*
+ * File:	emitter.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for writing an optimized flow graph as assembly
+ *		code, in the same form written by the code generator.
+ *
+ *		The graph is first translated out of SSA form using the
+ *		first method of Sreedhar et al.: each phi function becomes
+ *		a variable of its own, which is assigned by a move at the
+ *		end of each predecessor, and then copied at the start of
+ *		its block.  The moves never interfere with one another, so
+ *		no parallel copies or critical edge splitting are needed,
+ *		and most of the copies are removed by register allocation.
+ *
+ *		Registers are allocated using the linear scan algorithm of
+ *		Poletto and Sarkar over the blocks in reverse postorder,
+ *		with the live interval of each value computed from the live
+ *		variables of each block.  Values live across a call are
+ *		given a callee-saved register.  A value for which there is
+ *		no register lives in its own slot in the stack frame.
+ *
+ *		The registers %rax, %rdx, and %r11 are never allocated, and
+ *		are used as scratch registers within an instruction.
+ *		Vectors are allocated the registers %xmm0 to %xmm12, or the
+ *		corresponding %ymm registers, leaving the last three as
+ *		scratch registers.  Since every vector register is caller
+ *		saved, a vector live across a call always lives in memory.
+ *		Constants and the addresses of globals and locals are never
+ *		held in registers, but are instead folded into the
+ *		instructions that use them.
+ *
+ *		A call whose value is immediately returned is made by
+ *		jumping to the function after removing our stack frame, so
+ *		that it returns directly to our caller.  Any arguments
+ *		passed on the stack replace our own, so there must be no
+ *		more of them than we were passed.  No stack frame can be
+ *		removed while a local variable in memory may be in use.
+ *
+ *		A function that makes no calls and whose frame fits in the
+ *		red zone leaves the stack pointer alone.  Without a frame
+ *		pointer, the frame is addressed relative to the stack
+ *		pointer instead, allowing for any arguments pushed for a
+ *		call.
+ *
+ *		The blocks are written in reverse postorder, except that a
+ *		block the profile shows to be rarely executed is moved
+ *		after the epilogue.
+ */
+
+# include <set>
+# include <cstdlib>
+# include <sstream>
+# include <iostream>
+# include <algorithm>
+# include "machine.h"
+# include "Register.h"
+# include "Label.h"
+# include "IR.h"
+# include "generator.h"
+# include "statistics.h"
+# include "profile.h"
+
+using namespace std;
+
+static Register *rax = new Register("%rax", "%eax", "%al");
+static Register *rbx = new Register("%rbx", "%ebx", "%bl");
+static Register *rcx = new Register("%rcx", "%ecx", "%cl");
+static Register *rdx = new Register("%rdx", "%edx", "%dl");
+static Register *rsi = new Register("%rsi", "%esi", "%sil");
+static Register *rdi = new Register("%rdi", "%edi", "%dil");
+static Register *r8 = new Register("%r8", "%r8d", "%r8b");
+static Register *r9 = new Register("%r9", "%r9d", "%r9b");
+static Register *r10 = new Register("%r10", "%r10d", "%r10b");
+static Register *r11 = new Register("%r11", "%r11d", "%r11b");
+static Register *r12 = new Register("%r12", "%r12d", "%r12b");
+static Register *r13 = new Register("%r13", "%r13d", "%r13b");
+static Register *r14 = new Register("%r14", "%r14d", "%r14b");
+static Register *r15 = new Register("%r15", "%r15d", "%r15b");
+
+static Register *xmm0 = new Register("%xmm0", "%xmm0", "%xmm0");
+static Register *xmm1 = new Register("%xmm1", "%xmm1", "%xmm1");
+static Register *xmm2 = new Register("%xmm2", "%xmm2", "%xmm2");
+static Register *xmm3 = new Register("%xmm3", "%xmm3", "%xmm3");
+static Register *xmm4 = new Register("%xmm4", "%xmm4", "%xmm4");
+static Register *xmm5 = new Register("%xmm5", "%xmm5", "%xmm5");
+static Register *xmm6 = new Register("%xmm6", "%xmm6", "%xmm6");
+static Register *xmm7 = new Register("%xmm7", "%xmm7", "%xmm7");
+static Register *xmm8 = new Register("%xmm8", "%xmm8", "%xmm8");
+static Register *xmm9 = new Register("%xmm9", "%xmm9", "%xmm9");
+static Register *xmm10 = new Register("%xmm10", "%xmm10", "%xmm10");
+static Register *xmm11 = new Register("%xmm11", "%xmm11", "%xmm11");
+static Register *xmm12 = new Register("%xmm12", "%xmm12", "%xmm12");
+static Register *xmm13 = new Register("%xmm13", "%xmm13", "%xmm13");
+static Register *xmm14 = new Register("%xmm14", "%xmm14", "%xmm14");
+static Register *xmm15 = new Register("%xmm15", "%xmm15", "%xmm15");
+
+static Register *parameters[] = {rdi, rsi, rdx, rcx, r8, r9};
+static vector<Register *> callerSaved = {rcx, rsi, rdi, r8, r9, r10};
+static vector<Register *> calleeSaved = {rbx, r12, r13, r14, r15};
+
+static vector<Register *> vectors = {
+    xmm0, xmm1, xmm2, xmm3, xmm4, xmm5, xmm6,
+    xmm7, xmm8, xmm9, xmm10, xmm11, xmm12,
+};
+
+static map<Instruction *, Register *> assigned;
+static map<Instruction *, int> slots;
+static map<Instruction *, unsigned> uses;
+static map<Instruction *, string> fused;
+static vector<pair<Label, Instruction *>> iotas;
+static bool upper, cfi;
+static int offset, incoming, framesize, pushed;
+static unsigned line;
+
+
+/* A live interval, as a sorted list of disjoint ranges of positions,
+   along with its first and last positions. */
+
+struct Interval {
+    Instruction *value;
+    vector<pair<int, int>> ranges;
+    int start, end;
+    bool crosses;
+};
+
+
+/*
+ * Function:	suffix (private)
+ *
+ * Description:	Return the suffix for an opcode based on the given size.
+ */
+
+static string suffix(unsigned size)
+{
+    return size == 1 ? "b\t" : (size == 4 ? "l\t" : "q\t");
+}
+
+
+/*
+ * Function:	isFolded (private)
+ *
+ * Description:	Return whether a value is folded into its uses rather than
+ *		being held in a register or a stack slot.
+ */
+
+static bool isFolded(const Instruction *in)
+{
+    return in->_opcode == OP_CONST || in->_opcode == OP_FRAME ||
+	in->_opcode == OP_GLOBAL;
+}
+
+
+/*
+ * Function:	isValue (private)
+ *
+ * Description:	Return whether an instruction defines a value that must be
+ *		held in a register or a stack slot.  A move defines the phi
+ *		function that is its first operand.
+ */
+
+static bool isValue(const Instruction *in)
+{
+    return in->_size > 0 && in->_opcode != OP_MOVE &&
+	in->_opcode != OP_STORE && !isFolded(in);
+}
+
+
+/*
+ * Function:	fitsLong (private)
+ *
+ * Description:	Return whether a constant fits in a 32-bit immediate.
+ */
+
+static bool fitsLong(long value)
+{
+    return value == (int) value;
+}
+
+
+/*
+ * Function:	frame (private)
+ *
+ * Description:	Return the memory operand for the given offset from the
+ *		frame pointer.  Without a frame pointer, the locals lie
+ *		just below the return address, where the saved frame
+ *		pointer would have been, and are addressed relative to the
+ *		stack pointer.
+ */
+
+static string frame(int offset)
+{
+    stringstream ss;
+
+    if (framePointer)
+	ss << offset << "(%rbp)";
+    else {
+	if (offset > 0)
+	    offset -= SIZEOF_PTR;
+
+	ss << offset + framesize + pushed << "(%rsp)";
+    }
+
+    return ss.str();
+}
+
+
+/*
+ * Function:	location (private)
+ *
+ * Description:	Return the register or stack slot of a value.
+ */
+
+static string location(Instruction *in, unsigned size)
+{
+    if (assigned[in] != nullptr)
+	return assigned[in]->name(size);
+
+    return frame(slots[in]);
+}
+
+
+/*
+ * Function:	immediate (private)
+ *
+ * Description:	Return the immediate operand for a constant.
+ */
+
+static string immediate(Instruction *in)
+{
+    stringstream ss;
+
+    ss << "$" << in->_value;
+    return ss.str();
+}
+
+
+/*
+ * Function:	memory (private)
+ *
+ * Description:	Return the memory operand for a local or global address.
+ */
+
+static string memory(Instruction *in)
+{
+    if (in->_opcode == OP_GLOBAL)
+	return in->_name;
+
+    return frame(in->_value);
+}
+
+
+/*
+ * Function:	load (private)
+ *
+ * Description:	Load a value into the given register.
+ */
+
+static void load(Instruction *in, Register *reg, unsigned size)
+{
+    if (in->_opcode == OP_CONST) {
+	if (size < 4 || (size == 8 && in->_value >= 0 && fitsLong(in->_value)))
+	    size = 4;
+
+	cout << "\tmov" << suffix(size) << immediate(in) << ", " << reg->name(size) << endl;
+
+    } else if (in->_opcode == OP_FRAME || in->_opcode == OP_GLOBAL)
+	cout << "\tleaq\t" << memory(in) << ", " << reg->name() << endl;
+
+    else if (assigned[in] != reg)
+	cout << "\tmov" << suffix(size) << location(in, size) << ", " << reg->name(size) << endl;
+}
+
+
+/*
+ * Function:	source (private)
+ *
+ * Description:	Return an operand for a value used as the source operand of
+ *		an instruction, which may be a register, a stack slot, or a
+ *		32-bit immediate.  Any other value is first loaded into the
+ *		given scratch register.
+ */
+
+static string source(Instruction *in, unsigned size, Register *scratch)
+{
+    if (in->_opcode == OP_CONST && fitsLong(in->_value))
+	return immediate(in);
+
+    if (isFolded(in)) {
+	load(in, scratch, size);
+	return scratch->name(size);
+    }
+
+    return location(in, size);
+}
+
+
+/*
+ * Function:	reg (private)
+ *
+ * Description:	Return the register holding a value, first loading it into
+ *		the given scratch register if necessary.
+ */
+
+static string reg(Instruction *in, unsigned size, Register *scratch)
+{
+    if (!isFolded(in) && assigned[in] != nullptr)
+	return assigned[in]->name(size);
+
+    load(in, scratch, size);
+    return scratch->name(size);
+}
+
+
+/*
+ * Function:	address (private)
+ *
+ * Description:	Return a memory operand for the location pointed to by a
+ *		value, first loading the pointer into the given scratch
+ *		register if necessary.
+ */
+
+static string address(Instruction *in, Register *scratch)
+{
+    if (in->_opcode == OP_FRAME || in->_opcode == OP_GLOBAL)
+	return memory(in);
+
+    return "(" + reg(in, SIZEOF_PTR, scratch) + ")";
+}
+
+
+/*
+ * Function:	target (private)
+ *
+ * Description:	Return the register in which to compute a value: its own
+ *		register if it has one, and otherwise %rax.
+ */
+
+static Register *target(Instruction *in)
+{
+    return assigned[in] != nullptr ? assigned[in] : rax;
+}
+
+
+/*
+ * Function:	store (private)
+ *
+ * Description:	Store a value computed in the given register into its
+ *		location if it is not already there.
+ */
+
+static void store(Instruction *in, Register *reg)
+{
+    if (assigned[in] != reg)
+	cout << "\tmovq\t" << reg->name() << ", " << location(in, 8) << endl;
+}
+
+
+/*
+ * Function:	move (private)
+ *
+ * Description:	Copy a value to the location of another.  All registers
+ *		and stack slots hold eight bytes, so we always copy eight.
+ */
+
+static void move(Instruction *dst, Instruction *src)
+{
+    if (assigned[dst] != nullptr)
+	load(src, assigned[dst], SIZEOF_PTR);
+
+    else if (src->_opcode == OP_CONST && fitsLong(src->_value))
+	cout << "\tmovq\t" << immediate(src) << ", " << location(dst, 8) << endl;
+
+    else if (isFolded(src) || assigned[src] == nullptr) {
+	if (isFolded(src) || slots[src] != slots[dst]) {
+	    load(src, r11, SIZEOF_PTR);
+	    store(dst, r11);
+	}
+
+    } else
+	store(dst, assigned[src]);
+}
+
+
+/*
+ * Function:	shuffle (private)
+ *
+ * Description:	Perform a set of moves between registers as if in parallel.
+ *		A move is done once no other move still needs its
+ *		destination.  If none can be done, then the moves form a
+ *		cycle, which we break by moving a source to %rax.
+ */
+
+static void shuffle(vector<pair<Register *, Register *>> moves)
+{
+    while (!moves.empty()) {
+	unsigned i, j;
+
+	for (i = 0; i < moves.size(); i ++) {
+	    for (j = 0; j < moves.size(); j ++)
+		if (j != i && moves[j].first == moves[i].second)
+		    break;
+
+	    if (j == moves.size())
+		break;
+	}
+
+	if (i == moves.size()) {
+	    Register *from = moves[0].first;
+
+	    cout << "\tmovq\t" << from << ", %rax" << endl;
+
+	    for (j = 0; j < moves.size(); j ++)
+		if (moves[j].first == from)
+		    moves[j].first = rax;
+
+	    continue;
+	}
+
+	if (moves[i].first != moves[i].second)
+	    cout << "\tmovq\t" << moves[i].first << ", " << moves[i].second << endl;
+
+	moves.erase(moves.begin() + i);
+    }
+}
+
+
+/*
+ * Function:	xmm (private)
+ *
+ * Description:	Return the name of a vector register for the given size,
+ *		which for a 32-byte vector is the %ymm register.
+ */
+
+static string xmm(Register *reg, unsigned size)
+{
+    if (size == 32)
+	return "%y" + reg->name().substr(2);
+
+    return reg->name();
+}
+
+
+/*
+ * Function:	vreg (private)
+ *
+ * Description:	Return the register holding a vector, first loading it into
+ *		the given scratch register if it lives in memory.
+ */
+
+static Register *vreg(Instruction *in, Register *scratch)
+{
+    string v = in->_size == 32 ? "v" : "";
+
+    if (assigned[in] != nullptr)
+	return assigned[in];
+
+    cout << "\t" << v << "movdqu\t" << frame(slots[in]) << ", ";
+    cout << xmm(scratch, in->_size) << endl;
+    return scratch;
+}
+
+
+/*
+ * Function:	vstore (private)
+ *
+ * Description:	Store a vector computed in the given register into its
+ *		location if it is not already there.
+ */
+
+static void vstore(Instruction *in, Register *reg)
+{
+    string v = in->_size == 32 ? "v" : "";
+
+    if (assigned[in] == nullptr)
+	cout << "\t" << v << "movdqu\t" << xmm(reg, in->_size) << ", "
+	    << frame(slots[in]) << endl;
+
+    else if (assigned[in] != reg)
+	cout << "\t" << v << "movdqa\t" << xmm(reg, in->_size) << ", "
+	    << xmm(assigned[in], in->_size) << endl;
+}
+
+
+/*
+ * Function:	simd (private)
+ *
+ * Description:	Emit a vector instruction.  With AVX2, the arithmetic
+ *		instructions have three operands.  With SSE2, they have two
+ *		as usual, and since there is no multiplication of 32-bit
+ *		lanes, we multiply the even and odd lanes into 64-bit
+ *		products separately and then interleave the low halves.
+ */
+
+static void simd(Instruction *in)
+{
+    static const char *opcodes[] = {"padd", "psub"};
+
+    unsigned size = in->_size;
+    string v = size == 32 ? "v" : "", lane, operand;
+    Instruction *a, *b;
+    Register *dst, *ra, *rb;
+
+
+    lane = in->_value == SIZEOF_INT ? "d\t" : "q\t";
+    dst = assigned[in] != nullptr ? assigned[in] : xmm15;
+
+    switch (in->_opcode) {
+    case OP_LOAD:
+	operand = address(in->_operands[0], r11);
+	cout << "\t" << v << "movdqu\t" << operand << ", " << xmm(dst, size) << endl;
+	vstore(in, dst);
+	break;
+
+    case OP_STORE:
+	ra = vreg(in->_operands[1], xmm15);
+	operand = address(in->_operands[0], r11);
+	cout << "\t" << v << "movdqu\t" << xmm(ra, size) << ", " << operand << endl;
+	break;
+
+    case OP_SPLAT:
+	operand = reg(in->_operands[0], in->_value, r11);
+	cout << "\t" << v << "mov" << lane << operand << ", " << dst << endl;
+
+	if (size == 32)
+	    cout << "\tvpbroadcast" << lane << dst << ", " << xmm(dst, size) << endl;
+	else if (in->_value == SIZEOF_INT)
+	    cout << "\tpshufd\t$0, " << dst << ", " << dst << endl;
+	else
+	    cout << "\tpunpcklqdq\t" << dst << ", " << dst << endl;
+
+	vstore(in, dst);
+	break;
+
+    case OP_IOTA:
+	iotas.push_back(make_pair(Label(), in));
+	cout << "\t" << v << "movdqu\t" << iotas.back().first << global_suffix;
+	cout << ", " << xmm(dst, size) << endl;
+	vstore(in, dst);
+	break;
+
+    case OP_ADD: case OP_SUB: case OP_MUL:
+	a = in->_operands[0];
+	b = in->_operands[1];
+
+	if (size == 32) {
+	    ra = vreg(a, xmm14);
+	    rb = vreg(b, xmm15);
+
+	    if (in->_opcode == OP_MUL)
+		cout << "\tvpmulld\t";
+	    else
+		cout << "\tv" << opcodes[in->_opcode - OP_ADD] << lane;
+
+	    cout << xmm(rb, size) << ", " << xmm(ra, size) << ", " << xmm(dst, size) << endl;
+	    vstore(in, dst);
+
+	} else if (in->_opcode == OP_MUL) {
+	    ra = vreg(a, xmm13);
+	    cout << "\tpshufd\t$245, " << ra << ", %xmm14" << endl;
+
+	    if (ra != xmm13)
+		cout << "\tmovdqa\t" << ra << ", %xmm13" << endl;
+
+	    rb = vreg(b, xmm15);
+
+	    if (rb != xmm15)
+		cout << "\tmovdqa\t" << rb << ", %xmm15" << endl;
+
+	    cout << "\tpmuludq\t%xmm15, %xmm13" << endl;
+	    cout << "\tpshufd\t$245, %xmm15, %xmm15" << endl;
+	    cout << "\tpmuludq\t%xmm15, %xmm14" << endl;
+	    cout << "\tpshufd\t$8, %xmm13, %xmm13" << endl;
+	    cout << "\tpshufd\t$8, %xmm14, %xmm14" << endl;
+	    cout << "\tpunpckldq\t%xmm14, %xmm13" << endl;
+	    vstore(in, xmm13);
+
+	} else {
+	    if (in->_opcode == OP_ADD && assigned[b] == dst)
+		swap(a, b);
+
+	    if (a != b && assigned[b] == dst)
+		dst = xmm15;
+
+	    rb = vreg(b, xmm14);
+	    ra = vreg(a, dst);
+
+	    if (ra != dst)
+		cout << "\tmovdqa\t" << ra << ", " << dst << endl;
+
+	    cout << "\t" << opcodes[in->_opcode - OP_ADD] << lane << rb << ", " << dst << endl;
+	    vstore(in, dst);
+	}
+
+	break;
+
+    case OP_COPY:
+	if (uses[in] > 0)
+	    vstore(in, vreg(in->_operands[0], xmm15));
+
+	break;
+
+    case OP_MOVE:
+	vstore(in->_operands[0], vreg(in->_operands[1], xmm15));
+	break;
+    }
+}
+
+
+/*
+ * Function:	compare (private)
+ *
+ * Description:	Emit a comparison and return the condition code that holds
+ *		if the comparison is true.  The left operand must be in a
+ *		register or memory, so a constant on the left is swapped to
+ *		the right, and the condition mirrored.
+ */
+
+static string compare(Instruction *in)
+{
+    static const char *codes[] = {"l", "g", "le", "ge", "e", "ne"};
+    static const char *mirror[] = {"g", "l", "ge", "le", "e", "ne"};
+
+    Instruction *a = in->_operands[0], *b = in->_operands[1];
+    string cc = codes[in->_opcode - OP_LT], lhs, rhs;
+    unsigned size = a->_size;
+
+
+    if (isFolded(a) && !isFolded(b)) {
+	swap(a, b);
+	cc = mirror[in->_opcode - OP_LT];
+    }
+
+    rhs = source(b, size, r11);
+
+    if (isFolded(a) || (assigned[a] == nullptr && rhs[0] != '$' && rhs[0] != '%'))
+	lhs = reg(a, size, rax);
+    else
+	lhs = location(a, size);
+
+    cout << "\tcmp" << suffix(size) << rhs << ", " << lhs << endl;
+    return cc;
+}
+
+
+/*
+ * Function:	inverse (private)
+ *
+ * Description:	Return the inverse of a condition code.
+ */
+
+static string inverse(const string &cc)
+{
+    if (cc == "e") return "ne";
+    if (cc == "ne") return "e";
+    if (cc == "l") return "ge";
+    if (cc == "ge") return "l";
+    if (cc == "g") return "le";
+    return "g";
+}
+
+
+/*
+ * Function:	arithmetic (private)
+ *
+ * Description:	Emit a two-address arithmetic instruction.  The result is
+ *		computed in its own register unless that register holds the
+ *		right operand, in which case we either swap the operands or
+ *		compute the result in %rax.
+ */
+
+static void arithmetic(const string &opcode, Instruction *in, bool commutative)
+{
+    Instruction *a = in->_operands[0], *b = in->_operands[1];
+    Register *dst = target(in);
+    unsigned size = in->_size;
+    string operand;
+
+
+    if (commutative && !isFolded(b) && assigned[b] == dst && dst != rax)
+	swap(a, b);
+
+    if (!isFolded(b) && assigned[b] == dst)
+	dst = rax;
+
+    load(a, dst, size);
+    operand = source(b, size, r11);
+    cout << "\t" << opcode << suffix(size) << operand << ", " << dst->name(size) << endl;
+    store(in, dst);
+}
+
+
+/*
+ * Function:	multiply (private)
+ *
+ * Description:	Emit a multiplication, using a shift or an address
+ *		computation instead if one operand is a suitable constant.
+ */
+
+static void multiply(Instruction *in)
+{
+    Instruction *a = in->_operands[0], *b = in->_operands[1];
+    Register *dst = target(in);
+    unsigned size = in->_size;
+    string operand;
+
+
+    if (a->_opcode == OP_CONST)
+	swap(a, b);
+
+    if (b->_opcode != OP_CONST) {
+	arithmetic("imul", in, true);
+	return;
+    }
+
+    load(a, dst, size);
+
+    if (!multiplyConstant(dst, size, b->_value)) {
+	operand = source(b, size, r11);
+	cout << "\timul" << suffix(size) << operand << ", ";
+	cout << dst->name(size) << endl;
+    }
+
+    store(in, dst);
+}
+
+
+/*
+ * Function:	divide (private)
+ *
+ * Description:	Emit a division, leaving the quotient in %rax and the
+ *		remainder in %rdx.  A constant divisor avoids the division
+ *		if possible.  Otherwise, the divisor cannot be an
+ *		immediate.
+ */
+
+static void divide(Instruction *in)
+{
+    Instruction *a = in->_operands[0], *b = in->_operands[1];
+    unsigned size = in->_size;
+    string divisor;
+
+
+    load(a, rax, size);
+
+    if (b->_opcode == OP_CONST &&
+	    divideConstant(r11, size, b->_value, in->_opcode == OP_REM))
+	return;
+    divisor = isFolded(b) ? reg(b, size, r11) : location(b, size);
+    cout << (size == 8 ? "\tcqto" : "\tcltd") << endl;
+    cout << "\tidiv" << suffix(size) << divisor << endl;
+}
+
+
+/*
+ * Function:	arguments (private)
+ *
+ * Description:	Move the arguments passed in registers into those
+ *		registers: those in registers first, as a parallel move,
+ *		and then those in memory or constants.
+ */
+
+static void arguments(Instruction *in)
+{
+    Instructions &args = in->_operands;
+    vector<pair<Register *, Register *>> moves;
+
+
+    for (unsigned i = 0; i < args.size() && i < NUM_ARGS_IN_REGS; i ++)
+	if (!isFolded(args[i]) && assigned[args[i]] != nullptr)
+	    moves.push_back(make_pair(assigned[args[i]], parameters[i]));
+
+    shuffle(moves);
+
+    for (unsigned i = 0; i < args.size() && i < NUM_ARGS_IN_REGS; i ++)
+	if (isFolded(args[i]) || assigned[args[i]] == nullptr)
+	    load(args[i], parameters[i], SIZEOF_PTR);
+
+    if (in->_value != 0)
+	cout << "\tmovl\t$0, %eax" << endl;
+}
+
+
+/*
+ * Function:	call (private)
+ *
+ * Description:	Emit a function call.  Arguments beyond the sixth are
+ *		pushed on the stack from right to left, padding the stack
+ *		first to keep it aligned, before the remaining arguments
+ *		are moved into their registers.
+ */
+
+static void call(Instruction *in)
+{
+    Instructions &args = in->_operands;
+
+
+    if (args.size() > NUM_ARGS_IN_REGS) {
+	pushed = (args.size() - NUM_ARGS_IN_REGS) * SIZEOF_ARG;
+
+	if (pushed % STACK_ALIGNMENT != 0) {
+	    cout << "\tsubq\t$" << STACK_ALIGNMENT - pushed % STACK_ALIGNMENT;
+	    cout << ", %rsp" << endl;
+	    pushed = STACK_ALIGNMENT - pushed % STACK_ALIGNMENT;
+	} else
+	    pushed = 0;
+
+	for (unsigned i = args.size() - 1; i >= NUM_ARGS_IN_REGS; i --) {
+	    string operand = source(args[i], 8, r11);
+	    cout << "\tpushq\t" << operand << endl;
+	    pushed += SIZEOF_ARG;
+	}
+    }
+
+    arguments(in);
+
+    if (upper)
+	cout << "\tvzeroupper" << endl;
+
+    cout << "\tcall\t" << in->_name << endl;
+
+    if (pushed > 0)
+	cout << "\taddq\t$" << pushed << ", %rsp" << endl;
+
+    pushed = 0;
+
+    if (in->_size > 0 && uses[in] > 0)
+	store(in, rax);
+}
+
+
+/*
+ * Function:	leave (private)
+ *
+ * Description:	Restore the callee-saved registers and remove the stack
+ *		frame, before either returning or making a tail call.  The
+ *		description of the frame is saved, so that it can be
+ *		restored for any code that follows.
+ */
+
+static void leave(const map<Register *, int> &saves)
+{
+    if (cfi)
+	cout << "\t.cfi_remember_state" << endl;
+
+    for (map<Register *, int>::const_iterator it = saves.begin(); it != saves.end(); ++ it)
+	cout << "\tmovq\t" << frame(it->second) << ", " << it->first << endl;
+
+    if (upper)
+	cout << "\tvzeroupper" << endl;
+
+    if (!framePointer) {
+	if (framesize > 0)
+	    cout << "\taddq\t$" << framesize << ", %rsp" << endl;
+    } else {
+	if (framesize > 0)
+	    cout << "\tmovq\t%rbp, %rsp" << endl;
+
+	cout << "\tpopq\t%rbp" << endl;
+
+	if (cfi)
+	    cout << "\t.cfi_def_cfa\t%rsp, " << SIZEOF_PTR << endl;
+    }
+}
+
+
+/*
+ * Function:	epilogue (private)
+ *
+ * Description:	Write the epilogue of a function, at the given label.
+ */
+
+static void epilogue(const Label &exit, const map<Register *, int> &saves)
+{
+    cout << exit << ":" << endl;
+    leave(saves);
+    cout << "\tret" << endl;
+
+    if (cfi)
+	cout << "\t.cfi_restore_state" << endl;
+
+    cout << endl;
+}
+
+
+/*
+ * Function:	isReusable (private)
+ *
+ * Description:	Return whether our stack frame can be removed to make the
+ *		given tail call: no local variable may be in memory, and
+ *		the arguments on the stack must fit in place of our own.
+ */
+
+static bool isReusable(const Instruction *in)
+{
+    int stacked = (int) in->_operands.size() - NUM_ARGS_IN_REGS;
+
+    return incoming >= 0 && stacked <= incoming;
+}
+
+
+/*
+ * Function:	tail (private)
+ *
+ * Description:	Emit a tail call.  Arguments beyond the sixth are written
+ *		over our own, which have already been copied to their
+ *		locations, and the others are moved into their registers.
+ *		The stack frame is then removed, leaving our return address
+ *		on top of the stack, and we jump to the function.
+ */
+
+static void tail(Instruction *in, const map<Register *, int> &saves)
+{
+    Instructions &args = in->_operands;
+
+
+    for (unsigned i = NUM_ARGS_IN_REGS; i < args.size(); i ++) {
+	string operand = reg(args[i], SIZEOF_PTR, r11);
+	cout << "\tmovq\t" << operand << ", " << frame(INIT_ARG_OFFSET +
+	    SIZEOF_ARG * (i - NUM_ARGS_IN_REGS)) << endl;
+    }
+
+    arguments(in);
+    leave(saves);
+    cout << "\tjmp\t" << in->_name << endl;
+
+    if (cfi)
+	cout << "\t.cfi_restore_state" << endl;
+}
+
+
+/*
+ * Function:	destruct (private)
+ *
+ * Description:	Translate the graph out of SSA form.  Before doing so, the
+ *		comparison for each branch is moved to just before it, if
+ *		the branch is its only use, so that it can be fused with
+ *		the conditional jump.  The moves for the phi functions are
+ *		then placed between the two, since moves leave the flags
+ *		unchanged.
+ */
+
+static void destruct(Graph *graph)
+{
+    map<Instruction *, Instruction *> values;
+    Instructions phis;
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++)
+	    for (unsigned k = 0; k < instructions[j]->_operands.size(); k ++)
+		uses[instructions[j]->_operands[k]] ++;
+    }
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+	Instruction *last = block->terminator(), *cond;
+	Instructions &instructions = block->_instructions;
+
+	if (last->_opcode != OP_BRANCH)
+	    continue;
+
+	cond = last->_operands[0];
+
+	if (cond->isCompare() && cond->_block == block && uses[cond] == 1) {
+	    instructions.erase(find(instructions.begin(), instructions.end(), cond));
+	    instructions.insert(instructions.end() - 1, cond);
+	    fused[cond] = "";
+	}
+    }
+
+
+    /* Replace each phi function by a copy, and then add the moves. */
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+	unsigned count = 0;
+
+	while (count < block->_instructions.size() &&
+		block->_instructions[count]->_opcode == OP_PHI)
+	    count ++;
+
+	for (unsigned j = 0; j < count; j ++) {
+	    Instruction *phi = block->_instructions[j];
+	    Instruction *copy = new Instruction(OP_COPY, phi->_size);
+
+	    block->insert(copy, count + j);
+	    values[phi] = copy;
+	    phis.push_back(phi);
+	}
+    }
+
+    graph->replace(values);
+
+    for (unsigned i = 0; i < phis.size(); i ++) {
+	Instruction *phi = phis[i], *copy = values[phi];
+	BasicBlock *block = phi->_block;
+
+	for (unsigned k = 0; k < block->_predecessors.size(); k ++) {
+	    BasicBlock *pred = block->_predecessors[k];
+
+	    pred->insert(new Instruction(OP_MOVE, phi->_size,
+			{phi, phi->_operands[k]}), pred->_instructions.size() - 1);
+	}
+
+	phi->_operands.clear();
+	copy->_operands.push_back(phi);
+	uses[copy] = uses[phi];
+	uses[phi] = 1;
+    }
+}
+
+
+/*
+ * Function:	defined (private)
+ *
+ * Description:	Return the value defined by an instruction, if any.  A
+ *		move defines the phi function that is its first operand,
+ *		and a phi function itself is then just a placeholder.
+ */
+
+static Instruction *defined(Instruction *in)
+{
+    if (in->_opcode == OP_MOVE)
+	return in->_operands[0];
+
+    return isValue(in) && in->_opcode != OP_PHI ? in : nullptr;
+}
+
+
+/*
+ * Function:	intervals (private)
+ *
+ * Description:	Compute the live interval of each value.  Each instruction
+ *		is numbered so that its operands are used at an even
+ *		position and its result is defined at the following odd
+ *		one.  The live variables at the start and end of each block
+ *		are computed by the usual backward data-flow analysis, and
+ *		then each block is walked backward to find the ranges of
+ *		positions within it at which each value is live.  An
+ *		interval is the list of these ranges, so that it may have
+ *		holes in which its register can be used by another value.
+ */
+
+static vector<Interval> intervals(Graph *graph, vector<int> &calls)
+{
+    BasicBlocks &blocks = graph->_blocks;
+    map<Instruction *, unsigned> index;
+    vector<set<unsigned>> defs(blocks.size()), used(blocks.size());
+    vector<set<unsigned>> in(blocks.size()), out(blocks.size());
+    vector<Interval> result;
+    vector<int> first(blocks.size());
+    bool changed = true;
+    int position = 0;
+
+
+    /* Number the values and the instructions, and find the
+       upward-exposed uses and the definitions of each block. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++) {
+	Instructions &instructions = blocks[i]->_instructions;
+
+	first[i] = position;
+
+	for (unsigned j = 0; j < instructions.size(); j ++, position += 2) {
+	    Instruction *in = instructions[j], *def = defined(in);
+
+	    if (in->_opcode == OP_CALL)
+		calls.push_back(position);
+
+	    for (unsigned k = in->_opcode == OP_MOVE; k < in->_operands.size(); k ++)
+		if (isValue(in->_operands[k]) && defs[i].count(index[in->_operands[k]]) == 0)
+		    used[i].insert(index[in->_operands[k]]);
+
+	    if (def != nullptr) {
+		if (index.count(def) == 0) {
+		    index[def] = result.size();
+		    result.push_back({def, {}, 0, 0, false});
+		}
+
+		defs[i].insert(index[def]);
+	    }
+	}
+    }
+
+
+    /* Solve for the live variables. */
+
+    while (changed) {
+	changed = false;
+
+	for (int i = blocks.size() - 1; i >= 0; i --) {
+	    set<unsigned> live;
+
+	    for (unsigned j = 0; j < blocks[i]->_successors.size(); j ++) {
+		set<unsigned> &next = in[blocks[i]->_successors[j]->_number];
+		live.insert(next.begin(), next.end());
+	    }
+
+	    out[i] = live;
+
+	    for (set<unsigned>::iterator it = defs[i].begin(); it != defs[i].end(); ++ it)
+		live.erase(*it);
+
+	    live.insert(used[i].begin(), used[i].end());
+
+	    if (live != in[i]) {
+		in[i] = live;
+		changed = true;
+	    }
+	}
+    }
+
+
+    /* Find the ranges within each block. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++) {
+	Instructions &instructions = blocks[i]->_instructions;
+	map<unsigned, int> open;
+	int pos = first[i] + 2 * instructions.size();
+
+	for (set<unsigned>::iterator it = out[i].begin(); it != out[i].end(); ++ it)
+	    open[*it] = pos - 1;
+
+	for (int j = instructions.size() - 1; j >= 0; j --) {
+	    Instruction *in = instructions[j], *def = defined(in);
+
+	    pos -= 2;
+
+	    if (def != nullptr) {
+		unsigned v = index[def];
+
+		if (open.count(v) > 0) {
+		    result[v].ranges.push_back(make_pair(pos + 1, open[v]));
+		    open.erase(v);
+		} else
+		    result[v].ranges.push_back(make_pair(pos + 1, pos + 1));
+	    }
+
+	    for (unsigned k = in->_opcode == OP_MOVE; k < in->_operands.size(); k ++)
+		if (isValue(in->_operands[k]) && open.count(index[in->_operands[k]]) == 0)
+		    open[index[in->_operands[k]]] = pos;
+	}
+
+	for (map<unsigned, int>::iterator it = open.begin(); it != open.end(); ++ it)
+	    result[it->first].ranges.push_back(make_pair(first[i], it->second));
+    }
+
+
+    /* Sort and merge the ranges of each interval. */
+
+    for (unsigned i = 0; i < result.size(); i ++) {
+	vector<pair<int, int>> &ranges = result[i].ranges, merged;
+
+	sort(ranges.begin(), ranges.end());
+
+	for (unsigned j = 0; j < ranges.size(); j ++)
+	    if (!merged.empty() && ranges[j].first <= merged.back().second + 1)
+		merged.back().second = max(merged.back().second, ranges[j].second);
+	    else
+		merged.push_back(ranges[j]);
+
+	ranges = merged;
+	result[i].start = ranges.front().first;
+	result[i].end = ranges.back().second;
+
+	for (unsigned j = 0; j < ranges.size(); j ++)
+	    for (unsigned k = 0; k < calls.size(); k ++)
+		if (ranges[j].first <= calls[k] && ranges[j].second > calls[k] + 1)
+		    result[i].crosses = true;
+    }
+
+    return result;
+}
+
+
+/*
+ * Function:	overlaps (private)
+ *
+ * Description:	Return whether two live intervals overlap.
+ */
+
+static bool overlaps(const Interval *a, const Interval *b)
+{
+    unsigned i = 0, j = 0;
+
+    if (a->end < b->start || b->end < a->start)
+	return false;
+
+    while (i < a->ranges.size() && j < b->ranges.size()) {
+	if (a->ranges[i].second < b->ranges[j].first)
+	    i ++;
+	else if (b->ranges[j].second < a->ranges[i].first)
+	    j ++;
+	else
+	    return true;
+    }
+
+    return false;
+}
+
+
+/*
+ * Function:	spill (private)
+ *
+ * Description:	Give a value its own slot in the stack frame.
+ */
+
+static void spill(Instruction *in)
+{
+    if (memReport || timeTrace) {
+	tallies[SPILLS] ++;
+	frameSpills ++;
+    }
+
+    assigned[in] = nullptr;
+    offset -= in->isVector() ? in->_size : SIZEOF_PTR;
+    slots[in] = offset;
+}
+
+
+/*
+ * Function:	allocate (private)
+ *
+ * Description:	Allocate registers using linear scan.  The intervals are
+ *		visited in order of their start, and each is given a
+ *		register that is not held by any overlapping interval,
+ *		preferring the register of a value it is copied from or to,
+ *		or of its first operand, so that the copy disappears.  If
+ *		no register is free, then either the current interval or
+ *		the intervals holding the register that are live the
+ *		longest are spilled to the stack.
+ */
+
+static void allocate(Graph *graph, vector<Interval> &intervals, set<Register *> &saved)
+{
+    map<Register *, vector<Interval *>> owners;
+    map<Instruction *, Instructions> related;
+
+
+    sort(intervals.begin(), intervals.end(),
+	    [](const Interval &a, const Interval &b) { return a.start < b.start; });
+
+
+    /* Find the related values for each value. */
+
+    for (unsigned i = 0; i < intervals.size(); i ++) {
+	Instruction *in = intervals[i].value;
+
+	if (in->_opcode == OP_COPY || in->_opcode == OP_EXT || in->_opcode == OP_TRUNC ||
+		in->_opcode == OP_NEG || in->_opcode == OP_ADD ||
+		in->_opcode == OP_SUB || in->_opcode == OP_MUL)
+	    related[in].push_back(in->_operands[0]);
+
+	if (in->_opcode == OP_ADD || in->_opcode == OP_MUL)
+	    related[in].push_back(in->_operands[1]);
+    }
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++)
+	    if (instructions[j]->_opcode == OP_MOVE) {
+		Instruction *phi = instructions[j]->_operands[0];
+		Instruction *value = instructions[j]->_operands[1];
+
+		related[phi].push_back(value);
+		related[value].push_back(phi);
+	    }
+    }
+
+    for (unsigned i = 0; i < intervals.size(); i ++) {
+	Interval *current = &intervals[i];
+	Instruction *in = current->value;
+	Instructions &hints = related[in];
+	vector<Register *> choices;
+	Register *chosen = nullptr;
+
+	auto available = [&](Register *reg) {
+	    vector<Interval *> &others = owners[reg];
+
+	    if (find(choices.begin(), choices.end(), reg) == choices.end())
+		return false;
+
+	    for (unsigned j = 0; j < others.size(); j ++)
+		if (overlaps(others[j], current))
+		    return false;
+
+	    return true;
+	};
+
+
+	/* Choose a register, preferring that of a related value. */
+
+	if (in->isVector()) {
+	    if (!current->crosses)
+		choices = vectors;
+
+	} else {
+	    if (!current->crosses)
+		choices = callerSaved;
+
+	    choices.insert(choices.end(), calleeSaved.begin(), calleeSaved.end());
+	}
+
+	for (unsigned j = 0; chosen == nullptr && j < hints.size(); j ++)
+	    if (!isFolded(hints[j]) && assigned[hints[j]] != nullptr &&
+		    available(assigned[hints[j]]))
+		chosen = assigned[hints[j]];
+
+	if (chosen == nullptr && in->_opcode == OP_PARAM &&
+		in->_value < NUM_ARGS_IN_REGS && available(parameters[in->_value]))
+	    chosen = parameters[in->_value];
+
+	for (unsigned j = 0; chosen == nullptr && j < choices.size(); j ++)
+	    if (available(choices[j]))
+		chosen = choices[j];
+
+
+	/* If none is free, spill whichever intervals end last. */
+
+	if (chosen == nullptr) {
+	    int latest = current->end;
+
+	    for (unsigned j = 0; j < choices.size(); j ++) {
+		vector<Interval *> &others = owners[choices[j]];
+		int end = INT32_MAX;
+
+		for (unsigned k = 0; k < others.size(); k ++)
+		    if (overlaps(others[k], current))
+			end = min(end, others[k]->end);
+
+		if (end > latest) {
+		    latest = end;
+		    chosen = choices[j];
+		}
+	    }
+
+	    if (chosen != nullptr) {
+		vector<Interval *> &others = owners[chosen];
+
+		for (unsigned k = 0; k < others.size(); k ++)
+		    if (overlaps(others[k], current)) {
+			spill(others[k]->value);
+			others.erase(others.begin() + k --);
+		    }
+
+	    } else {
+		spill(in);
+		continue;
+	    }
+	}
+
+	assigned[in] = chosen;
+	owners[chosen].push_back(current);
+
+	if (find(calleeSaved.begin(), calleeSaved.end(), chosen) != calleeSaved.end())
+	    saved.insert(chosen);
+    }
+}
+
+
+/*
+ * Function:	isSmallLoop (private)
+ *
+ * Description:	Return whether the given block heads a small loop, that
+ *		is, whether it is the target of a branch from a later block
+ *		with few enough instructions between the two.
+ */
+
+static bool isSmallLoop(const Graph *graph, const BasicBlock *header)
+{
+    unsigned latch = header->_number, count = 0;
+
+
+    for (unsigned i = 0; i < header->_predecessors.size(); i ++)
+	latch = max(latch, header->_predecessors[i]->_number);
+
+    if (latch == header->_number && find(header->_predecessors.begin(),
+	    header->_predecessors.end(), header) == header->_predecessors.end())
+	return false;
+
+    for (unsigned i = header->_number; i <= latch; i ++)
+	count += graph->_blocks[i]->_instructions.size();
+
+    return count <= SMALL_LOOP;
+}
+
+
+/*
+ * Function:	isCold (private)
+ *
+ * Description:	Return whether the profile shows that the branch that is
+ *		the only predecessor of a block rarely goes to it, in which
+ *		case the block is placed after the epilogue, out of the way
+ *		of the code usually executed.  Leaving a loop is never
+ *		considered rare, as that would take an extra jump to get
+ *		back to the code after the loop.
+ */
+
+static bool isCold(const BasicBlock *block)
+{
+    const BasicBlock *branch, *other;
+
+
+    if (block->_predecessors.size() != 1)
+	return false;
+
+    branch = block->_predecessors[0];
+
+    if (branch->_successors.size() != 2 || branch->taken(block) < 0)
+	return false;
+
+    other = branch->_successors[branch->_successors[0] == block ? 1 : 0];
+    return other->_number > branch->_number && branch->taken(other) >= 0 &&
+	isRare(branch->taken(block), branch->taken(block) + branch->taken(other));
+}
+
+
+/*
+ * Function:	locate (private)
+ *
+ * Description:	With debugging information, mark the code that follows as
+ *		coming from the given line of the source file, unless the
+ *		line is unknown or unchanged.
+ */
+
+static void locate(unsigned source)
+{
+    if (debugInfo && source > 0 && source != line) {
+	cout << "\t.loc\t1 " << source << endl;
+	line = source;
+    }
+}
+
+
+/*
+ * Function:	prologue (private)
+ *
+ * Description:	Move the parameters to their locations.  Those going to
+ *		the stack are moved first, then those going from one
+ *		register to another as a parallel move, and finally those
+ *		passed on the stack.
+ */
+
+static void prologue(Graph *graph)
+{
+    vector<pair<Register *, Register *>> moves;
+    Instructions params;
+
+
+    for (unsigned i = 0; i < graph->_entry->_instructions.size(); i ++)
+	if (graph->_entry->_instructions[i]->_opcode == OP_PARAM)
+	    params.push_back(graph->_entry->_instructions[i]);
+
+    for (unsigned i = 0; i < params.size(); i ++)
+	if (params[i]->_value < NUM_ARGS_IN_REGS && assigned[params[i]] == nullptr)
+	    store(params[i], parameters[params[i]->_value]);
+
+    for (unsigned i = 0; i < params.size(); i ++)
+	if (params[i]->_value < NUM_ARGS_IN_REGS && assigned[params[i]] != nullptr)
+	    moves.push_back(make_pair(parameters[params[i]->_value], assigned[params[i]]));
+
+    shuffle(moves);
+
+    for (unsigned i = 0; i < params.size(); i ++)
+	if (params[i]->_value >= NUM_ARGS_IN_REGS) {
+	    Register *reg = target(params[i]);
+
+	    cout << "\tmovq\t" << frame(INIT_ARG_OFFSET + SIZEOF_ARG *
+		(params[i]->_value - NUM_ARGS_IN_REGS)) << ", " << reg << endl;
+	    store(params[i], reg);
+	}
+}
+
+
+/*
+ * Function:	emit
+ *
+ * Description:	Write the flow graph for a function as assembly code.
+ */
+
+void emit(Graph *graph)
+{
+    BasicBlocks &blocks = graph->_blocks;
+    const string &name = graph->_id->name();
+    vector<Label> labels(blocks.size());
+    vector<Interval> live;
+    vector<int> calls;
+    set<Register *> saved;
+    map<Register *, int> saves;
+    BasicBlocks layout;
+    bool leaf = true;
+    unsigned hot;
+    Label exit;
+    Instant start;
+
+
+    assigned.clear();
+    slots.clear();
+    uses.clear();
+    fused.clear();
+    iotas.clear();
+    upper = false;
+
+    incoming = graph->_id->type().parameters()->size();
+    incoming = max(incoming - NUM_ARGS_IN_REGS, 0);
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	for (unsigned j = 0; j < blocks[i]->_instructions.size(); j ++) {
+	    if (blocks[i]->_instructions[j]->_size == 32)
+		upper = true;
+
+	    if (blocks[i]->_instructions[j]->_opcode == OP_FRAME)
+		incoming = -1;
+
+	    if (blocks[i]->_instructions[j]->_opcode == OP_CALL)
+		leaf = false;
+	}
+
+    if (timeReport || timeTrace)
+	start = now();
+
+    destruct(graph);
+    live = intervals(graph, calls);
+    offset = graph->_offset - (SIZEOF_PTR + graph->_offset % SIZEOF_PTR) % SIZEOF_PTR;
+    allocate(graph, live, saved);
+
+    if (timeReport)
+	charge(ALLOCATING, start);
+
+    if (timeTrace)
+	trace("allocate", start, name);
+
+    for (set<Register *>::iterator it = saved.begin(); it != saved.end(); ++ it) {
+	offset -= SIZEOF_PTR;
+	saves[*it] = offset;
+    }
+
+    /* Without a frame pointer, only the return address is on the stack,
+       so the frame size must be eight bytes from a multiple of sixteen. */
+
+    frameSize = -offset;
+    framesize = -offset + (framePointer ? 0 : SIZEOF_PTR);
+
+    if (framesize % STACK_ALIGNMENT != 0)
+	framesize += STACK_ALIGNMENT - framesize % STACK_ALIGNMENT;
+
+    if (!framePointer)
+	framesize -= SIZEOF_PTR;
+
+    if (leaf && -offset <= RED_ZONE)
+	framesize = 0;
+
+    pushed = 0;
+    line = 0;
+    cfi = debugInfo && framePointer;
+
+
+    /* The prologue, which with debugging information describes a frame
+       with a frame pointer so that the stack can be unwound. */
+
+    if (debugInfo && typed_symbols)
+	cout << "\t.type\t" << global_prefix << name << ", @function" << endl;
+
+    cout << global_prefix << name << ":" << endl;
+
+    if (cfi)
+	cout << "\t.cfi_startproc" << endl;
+
+    locate(graph->_line);
+
+    if (framePointer) {
+	cout << "\tpushq\t%rbp" << endl;
+
+	if (cfi) {
+	    cout << "\t.cfi_def_cfa_offset\t" << INIT_ARG_OFFSET << endl;
+	    cout << "\t.cfi_offset\t%rbp, " << -INIT_ARG_OFFSET << endl;
+	}
+
+	cout << "\tmovq\t%rsp, %rbp" << endl;
+
+	if (cfi)
+	    cout << "\t.cfi_def_cfa_register\t%rbp" << endl;
+    }
+
+    if (framesize > 0)
+	cout << "\tsubq\t$" << framesize << ", %rsp" << endl;
+
+    for (map<Register *, int>::iterator it = saves.begin(); it != saves.end(); ++ it) {
+	cout << "\tmovq\t" << it->first << ", " << frame(it->second) << endl;
+
+	if (cfi) {
+	    cout << "\t.cfi_offset\t" << it->first << ", ";
+	    cout << it->second - INIT_ARG_OFFSET << endl;
+	}
+    }
+
+    prologue(graph);
+
+
+    /* The body, with any rarely executed blocks after the epilogue. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	if (!isCold(blocks[i]))
+	    layout.push_back(blocks[i]);
+
+    hot = layout.size();
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	if (isCold(blocks[i]))
+	    layout.push_back(blocks[i]);
+
+    for (unsigned i = 0; i < layout.size(); i ++) {
+	BasicBlock *block = layout[i], *next;
+	Instructions &instructions = block->_instructions;
+
+	next = i + 1 < layout.size() && i + 1 != hot ? layout[i + 1] : nullptr;
+
+	if (i == hot)
+	    epilogue(exit, saves);
+
+	if (i > 0 && isSmallLoop(graph, block))
+	    cout << "\t.p2align\t" << LOOP_ALIGNMENT << endl;
+
+	if (i > 0)
+	    cout << labels[block->_number] << ":" << endl;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instruction *in = instructions[j];
+	    unsigned size = in->_size;
+	    Register *dst = target(in);
+	    BasicBlock *taken;
+	    string cc, operand;
+
+	    locate(in->_line);
+
+	    if (in->isVector()) {
+		simd(in);
+		continue;
+	    }
+
+	    switch (in->_opcode) {
+	    case OP_ADD:
+		arithmetic("add", in, true);
+		break;
+
+	    case OP_SUB:
+		arithmetic("sub", in, false);
+		break;
+
+	    case OP_MUL:
+		multiply(in);
+		break;
+
+	    case OP_DIV: case OP_REM:
+		divide(in);
+		store(in, in->_opcode == OP_DIV ? rax : rdx);
+		break;
+
+	    case OP_NEG:
+		load(in->_operands[0], dst, size);
+		cout << "\tneg" << suffix(size) << dst->name(size) << endl;
+		store(in, dst);
+		break;
+
+	    case OP_LT: case OP_GT: case OP_LE: case OP_GE: case OP_EQ: case OP_NE:
+		cc = compare(in);
+
+		if (fused.count(in) > 0)
+		    fused[in] = cc;
+		else {
+		    cout << "\tset" << cc << "\t" << dst->name(1) << endl;
+		    cout << "\tmovzbl\t" << dst->name(1) << ", " << dst->name(4) << endl;
+		    store(in, dst);
+		}
+
+		break;
+
+	    case OP_EXT:
+		operand = reg(in->_operands[0], in->_operands[0]->_size, r11);
+		cout << "\tmovs" << suffix(in->_operands[0]->_size)[0];
+		cout << suffix(size) << operand << ", " << dst->name(size) << endl;
+		store(in, dst);
+		break;
+
+	    case OP_TRUNC: case OP_COPY:
+		if (uses[in] > 0)
+		    move(in, in->_operands[0]);
+
+		break;
+
+	    case OP_MOVE:
+		move(in->_operands[0], in->_operands[1]);
+		break;
+
+	    case OP_LOAD:
+		operand = address(in->_operands[0], r11);
+		cout << "\tmov" << suffix(size) << operand << ", " << dst->name(size) << endl;
+		store(in, dst);
+		break;
+
+	    case OP_STORE:
+		cc = in->_operands[1]->_opcode == OP_CONST &&
+		    fitsLong(in->_operands[1]->_value) ? immediate(in->_operands[1]) :
+		    reg(in->_operands[1], size, rax);
+		operand = address(in->_operands[0], r11);
+		cout << "\tmov" << suffix(size) << cc << ", " << operand << endl;
+		break;
+
+	    case OP_CALL:
+		if (block->isTail(j) && isReusable(in)) {
+		    tail(in, saves);
+		    j ++;
+		} else
+		    call(in);
+
+		break;
+
+	    case OP_RETURN:
+		if (!in->_operands.empty())
+		    load(in->_operands[0], rax, SIZEOF_PTR);
+
+		if (i + 1 != hot)
+		    cout << "\tjmp\t" << exit << endl;
+
+		break;
+
+	    case OP_JUMP:
+		if (block->_successors[0] != next)
+		    cout << "\tjmp\t" << labels[block->_successors[0]->_number] << endl;
+
+		break;
+
+	    case OP_BRANCH:
+		if (in->_operands[0]->_opcode == OP_CONST) {
+		    taken = block->_successors[in->_operands[0]->_value == 0];
+
+		    if (taken != next)
+			cout << "\tjmp\t" << labels[taken->_number] << endl;
+
+		    break;
+		}
+
+		if (fused.count(in->_operands[0]) > 0)
+		    cc = fused[in->_operands[0]];
+		else {
+		    Instruction *cond = in->_operands[0];
+
+		    if (assigned[cond] != nullptr)
+			cout << "\ttest" << suffix(cond->_size) << location(cond, cond->_size)
+			    << ", " << location(cond, cond->_size) << endl;
+		    else
+			cout << "\tcmp" << suffix(cond->_size) << "$0, "
+			    << location(cond, cond->_size) << endl;
+
+		    cc = "ne";
+		}
+
+		if (block->_successors[1] == next)
+		    cout << "\tj" << cc << "\t" << labels[block->_successors[0]->_number] << endl;
+		else if (block->_successors[0] == next)
+		    cout << "\tj" << inverse(cc) << "\t" << labels[block->_successors[1]->_number] << endl;
+		else {
+		    cout << "\tj" << cc << "\t" << labels[block->_successors[0]->_number] << endl;
+		    cout << "\tjmp\t" << labels[block->_successors[1]->_number] << endl;
+		}
+
+		break;
+	    }
+	}
+    }
+
+
+    if (hot == layout.size())
+	epilogue(exit, saves);
+
+    if (cfi)
+	cout << "\t.cfi_endproc" << endl;
+
+    if (debugInfo && typed_symbols)
+	cout << "\t.size\t" << global_prefix << name << ", .-" << global_prefix << name << endl;
+
+
+    /* The lane numbers for each iota. */
+
+    for (unsigned i = 0; i < iotas.size(); i ++) {
+	Instruction *in = iotas[i].second;
+
+	cout << "\t.p2align\t" << (in->_size == 32 ? 5 : 4) << endl;
+	cout << iotas[i].first << ":";
+
+	for (unsigned j = 0; j < in->_size / in->_value; j ++)
+	    cout << (in->_value == SIZEOF_INT ? "\t.long\t" : "\t.quad\t") << j << endl;
+    }
+
+    if (!iotas.empty())
+	cout << endl;
+
+    cout << "\t.globl\t" << global_prefix << name << endl << endl;
+}
@@ -0,0 +1,1005 @@
+g:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$g.size, %eax
+	subq	%rax, %rsp
+	movl	%edi, -4(%rbp)
+#REMAINDER
+	movl	-4(%rbp), %edi
+	movl	$0, %eax
+	call	abs
+#ADD
+	mov	%eax, -8(%rbp)	# spill
+	movl	$0, %eax
+	call	rand
+	mov	%eax, -12(%rbp)	# spill
+	movl	-12(%rbp), %edi
+	movl	$0, %eax
+	call	abs
+	add	$1, %eax
+	mov	%eax, -20(%rbp)	# spill
+	mov	-8(%rbp), %eax
+	cltd
+	idivl	-20(%rbp)
+	mov	%edx, %eax
+	jmp	.L0
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	g.size, 32
+	.globl	g
+
+f:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$f.size, %eax
+	subq	%rax, %rsp
+	movl	%edi, -4(%rbp)
+	movl	%esi, -8(%rbp)
+#REMAINDER
+	mov	-4(%rbp), %eax
+	mov	$100000, %ecx
+	cltd
+	idivl	%ecx
+	movl	%edx, -4(%rbp)
+#REMAINDER
+	mov	-8(%rbp), %eax
+	mov	$100000, %ecx
+	cltd
+	idivl	%ecx
+	movl	%edx, -8(%rbp)
+#IF
+#SUBTRACT
+#ADD
+#ADDRESS
+	leaq	s(%rip), %rax
+#MULTIPLY
+	mov	$100, %rdi
+	imul	$1, %rdi
+	add	%rdi, %rax
+#MULTIPLY
+#CAST
+	mov	$1, %edi
+	movslq	%edi, %rdi
+	imul	$1, %rdi
+	sub	%rdi, %rax
+	mov	s3(%rip), %rdi
+	cmpq	%rax, %rdi
+	jge	.L2
+#CAST
+	mov	$102, %eax
+	movb	%al,  %al
+	mov	s3(%rip), %rdi
+	movb	%al, (%rdi)
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$1, %rax
+	mov	s3(%rip), %rdi
+	add	%rax, %rdi
+	movq	%rdi, s3(%rip)
+.L2:
+#IF
+#MULTIPLY
+	mov	-8(%rbp), %eax
+	imul	$2, %eax
+	mov	-4(%rbp), %edi
+	cmpl	%eax, %edi
+	jl	.L4
+#SUBTRACT
+#MULTIPLY
+	mov	-8(%rbp), %eax
+	imul	$3, %eax
+	mov	-4(%rbp), %edi
+	sub	%eax, %edi
+	mov	%edi, %eax
+	jmp	.L1
+	jmp	.L5
+.L4:
+#IF
+#REMAINDER
+	mov	-4(%rbp), %eax
+	mov	$2, %ecx
+	cltd
+	idivl	%ecx
+	cmpl	$0, %edx
+	jne	.L6
+#ADD
+#MULTIPLY
+	mov	-4(%rbp), %eax
+	imul	$4, %eax
+#DIVIDE
+	mov	%eax, -76(%rbp)	# spill
+	mov	-8(%rbp), %eax
+	mov	$3, %ecx
+	cltd
+	idivl	%ecx
+	mov	%eax, -80(%rbp)	# spill
+	movl	-80(%rbp), %esi
+	movl	-76(%rbp), %edi
+	call	f
+#ADD
+	mov	-4(%rbp), %edi
+	add	$100, %edi
+#SUBTRACT
+	mov	-8(%rbp), %esi
+	sub	$4, %esi
+	mov	%eax, -92(%rbp)	# spill
+	mov	%edi, -96(%rbp)	# spill
+	mov	%esi, -100(%rbp)	# spill
+	movl	-100(%rbp), %esi
+	movl	-96(%rbp), %edi
+	call	f
+	mov	-92(%rbp), %edi
+	add	%eax, %edi
+	mov	%edi, %eax
+	jmp	.L1
+	jmp	.L7
+.L6:
+#ADD
+#MULTIPLY
+	mov	-4(%rbp), %eax
+	imul	$2, %eax
+#DIVIDE
+	mov	%eax, -112(%rbp)	# spill
+	mov	-8(%rbp), %eax
+	mov	$3, %ecx
+	cltd
+	idivl	%ecx
+	mov	%eax, -116(%rbp)	# spill
+	movl	-116(%rbp), %esi
+	movl	-112(%rbp), %edi
+	call	f
+#ADD
+	mov	%eax, -120(%rbp)	# spill
+	movl	-4(%rbp), %edi
+	call	g
+	mov	%eax, -124(%rbp)	# spill
+	movl	-124(%rbp), %edi
+	call	g
+	mov	-4(%rbp), %edi
+	add	%eax, %edi
+#SUBTRACT
+	mov	-8(%rbp), %eax
+	sub	$10, %eax
+	mov	%eax, -136(%rbp)	# spill
+	mov	%edi, -140(%rbp)	# spill
+	movl	-136(%rbp), %esi
+	movl	-140(%rbp), %edi
+	call	f
+	mov	-120(%rbp), %edi
+	add	%eax, %edi
+	mov	%edi, %eax
+	jmp	.L1
+.L7:
+.L5:
+.L1:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	f.size, 144
+	.globl	f
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+	mov	$500, %eax
+	movl	%eax, -49(%rbp)
+#ADDRESS
+	leaq	-4(%rbp), %rax
+	movq	%rax, p1(%rip)
+#ADDRESS
+	leaq	i1(%rip), %rax
+	movq	%rax, -12(%rbp)
+#ADDRESS
+	leaq	-20(%rbp), %rax
+	movq	%rax, q1(%rip)
+#ADDRESS
+	leaq	l1(%rip), %rax
+	movq	%rax, -28(%rbp)
+#ADDRESS
+	leaq	-29(%rbp), %rax
+	movq	%rax, s1(%rip)
+#ADDRESS
+	leaq	c1(%rip), %rax
+	movq	%rax, -37(%rbp)
+#WHILE
+.L9:
+	mov	-49(%rbp), %eax
+	cmpl	$0, %eax
+	jle	.L10
+#SUBTRACT
+	mov	-49(%rbp), %eax
+	sub	$1, %eax
+	movl	%eax, -49(%rbp)
+#ADD
+#ADD
+#ADD
+#ADD
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$10, %ecx
+	cltd
+	idivl	%ecx
+	mov	$65, %eax
+	add	%edx, %eax
+	mov	%eax, -61(%rbp)	# spill
+	movl	-61(%rbp), %edi
+	movl	$0, %eax
+	call	putchar
+	add	$1, %eax
+	mov	%eax, -69(%rbp)	# spill
+	movl	-69(%rbp), %edi
+	movl	$0, %eax
+	call	putchar
+	add	$2, %eax
+	mov	%eax, -77(%rbp)	# spill
+	movl	-77(%rbp), %edi
+	movl	$0, %eax
+	call	putchar
+	add	$3, %eax
+	mov	%eax, -85(%rbp)	# spill
+	movl	-85(%rbp), %edi
+	movl	$0, %eax
+	call	putchar
+	add	$4, %eax
+	mov	%eax, -93(%rbp)	# spill
+	movl	-93(%rbp), %edi
+	movl	$0, %eax
+	call	putchar
+	movl	$32, %edi
+	movl	$0, %eax
+	call	putchar
+#ADDRESS
+	leaq	s(%rip), %rax
+	movq	%rax, s3(%rip)
+#ADDRESS
+	leaq	t(%rip), %rax
+	movq	%rax, -45(%rbp)
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$100, %ecx
+	cltd
+	idivl	%ecx
+	add	$1, %edx
+	movl	%edx, i1(%rip)
+#CAST
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$1000, %ecx
+	cltd
+	idivl	%ecx
+	add	$1, %edx
+	mov	%edx, %eax
+	movslq	%eax, %rax
+	movq	%rax, l1(%rip)
+#CAST
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$10, %ecx
+	cltd
+	idivl	%ecx
+	add	$1, %edx
+	mov	%edx, %eax
+	movb	%al,  %al
+	movb	%al, c1(%rip)
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$30, %ecx
+	cltd
+	idivl	%ecx
+	add	$1, %edx
+	movl	%edx, -4(%rbp)
+#CAST
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$300, %ecx
+	cltd
+	idivl	%ecx
+	add	$1, %edx
+	mov	%edx, %eax
+	movslq	%eax, %rax
+	movq	%rax, -20(%rbp)
+#CAST
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$3, %ecx
+	cltd
+	idivl	%ecx
+	add	$1, %edx
+	mov	%edx, %eax
+	movb	%al,  %al
+	movb	%al, -29(%rbp)
+#ADDRESS
+	leaq	.L11(%rip), %rax
+	mov	%rax, -125(%rbp)	# spill
+	movl	-4(%rbp), %edx
+	movl	i1(%rip), %esi
+	movq	-125(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#WHILE
+.L12:
+#REMAINDER
+	mov	i1(%rip), %eax
+	mov	$3, %ecx
+	cltd
+	idivl	%ecx
+	cmpl	$0, %edx
+	je	.L13
+#ADDRESS
+	leaq	.L14(%rip), %rax
+#SUBTRACT
+#CAST
+#ADD
+#MULTIPLY
+#DEREFERENCE
+	mov	p1(%rip), %rdi
+	movl	(%rdi), %edi
+	mov	-4(%rbp), %esi
+	imul	%edi, %esi
+#CAST
+	mov	-29(%rbp), %dil
+	movsbl	%dil, %edi
+	add	%edi, %esi
+	mov	%esi, %edi
+	movslq	%edi, %rdi
+#REMAINDER
+#DEREFERENCE
+	mov	q1(%rip), %rsi
+	movq	(%rsi), %rsi
+#CAST
+#ADD
+#CAST
+#DEREFERENCE
+	mov	-37(%rbp), %rdx
+	movb	(%rdx), %dl
+	mov	%dl, %cl
+	movsbl	%cl, %ecx
+	mov	%rax, -141(%rbp)	# spill
+	mov	%rdi, -149(%rbp)	# spill
+	mov	%rsi, -157(%rbp)	# spill
+	mov	%ecx, -161(%rbp)	# spill
+	movl	-161(%rbp), %edi
+	movl	$0, %eax
+	call	abs
+	add	$1, %eax
+	mov	%eax, %edi
+	movslq	%edi, %rdi
+	mov	-157(%rbp), %rax
+	cqto
+	idivq	%rdi
+	mov	-149(%rbp), %rax
+	sub	%rdx, %rax
+	mov	%rax, -181(%rbp)	# spill
+	movq	-181(%rbp), %rsi
+	movq	-141(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L15(%rip), %rax
+	mov	%rax, -189(%rbp)	# spill
+	movl	-4(%rbp), %esi
+	movl	i1(%rip), %edi
+	call	f
+	mov	%eax, -193(%rbp)	# spill
+	movl	-193(%rbp), %esi
+	movq	-189(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$20, %ecx
+	cltd
+	idivl	%ecx
+	mov	i1(%rip), %eax
+	add	%edx, %eax
+	movl	%eax, i1(%rip)
+#WHILE
+.L16:
+#DIVIDE
+	movq	-20(%rbp), %rdi
+	movl	$0, %eax
+	call	labs
+#CAST
+	mov	$5, %edi
+	movslq	%edi, %rdi
+	cqto
+	idivq	%rdi
+#CAST
+	mov	$10, %edi
+	movslq	%edi, %rdi
+	cmpq	%rdi, %rax
+	jle	.L17
+#DIVIDE
+#CAST
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$7, %ecx
+	cltd
+	idivl	%ecx
+	add	$1, %edx
+	mov	%edx, %eax
+	movslq	%eax, %rax
+	mov	%rax, -209(%rbp)	# spill
+	mov	-20(%rbp), %rax
+	cqto
+	idivq	-209(%rbp)
+	movq	%rax, -20(%rbp)
+#IF
+#CAST
+	mov	$0, %eax
+	movslq	%eax, %rax
+	mov	-20(%rbp), %rdi
+	cmpq	%rax, %rdi
+	je	.L18
+#ADDRESS
+	leaq	.L20(%rip), %rax
+#CAST
+#CAST
+#ADD
+#ADD
+#CAST
+	mov	c1(%rip), %dil
+	movsbq	%dil, %rdi
+#MULTIPLY
+#CAST
+	mov	-29(%rbp), %sil
+	movsbq	%sil, %rsi
+#DIVIDE
+#CAST
+#DEREFERENCE
+	mov	-37(%rbp), %rdx
+	movb	(%rdx), %dl
+	mov	%dl, %cl
+	movsbq	%cl, %rcx
+	mov	%rax, -217(%rbp)	# spill
+	mov	%rcx, %rax
+	cqto
+	idivq	-20(%rbp)
+	imul	%rax, %rsi
+	add	%rsi, %rdi
+#DEREFERENCE
+	mov	-28(%rbp), %rax
+	movq	(%rax), %rax
+	add	%rax, %rdi
+	mov	%rdi, %rax
+	movb	%al,  %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	mov	%edi, -245(%rbp)	# spill
+	movl	-245(%rbp), %esi
+	movq	-217(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+.L18:
+#CAST
+#ADD
+#CAST
+	mov	c1(%rip), %al
+	movsbl	%al, %eax
+	add	$2, %eax
+	mov	%eax, %edi
+	movb	%dil,  %dil
+	movb	%dil, c1(%rip)
+	jmp	.L16
+.L17:
+#MULTIPLY
+	mov	-4(%rbp), %eax
+	imul	$3, %eax
+	movl	%eax, -4(%rbp)
+	jmp	.L12
+.L13:
+#WHILE
+.L21:
+#CAST
+	mov	c1(%rip), %al
+	movsbl	%al, %eax
+	cmpl	$1, %eax
+	jle	.L22
+#CAST
+#SUBTRACT
+#CAST
+	mov	c1(%rip), %al
+	movsbl	%al, %eax
+#REMAINDER
+	mov	%eax, -257(%rbp)	# spill
+	movl	$0, %eax
+	call	rand
+	mov	$3, %ecx
+	cltd
+	idivl	%ecx
+	mov	-257(%rbp), %eax
+	sub	%edx, %eax
+	mov	%eax, %edi
+	movb	%dil,  %dil
+	movb	%dil, c1(%rip)
+#ADDRESS
+	leaq	.L23(%rip), %rax
+#LOGICALOR
+	mov	%rax, -269(%rbp)	# spill
+#CAST
+	mov	-29(%rbp), %al
+	movsbq	%al, %rax
+	mov	l1(%rip), %rdi
+	cmpq	%rax, %rdi
+	jg	.L26
+#CAST
+	mov	-29(%rbp), %al
+	movsbl	%al, %eax
+#DEREFERENCE
+	mov	p1(%rip), %rdi
+	movl	(%rdi), %edi
+	cmpl	%edi, %eax
+	jg	.L24
+	mov	p1(%rip), %rax
+	cmpq	-12(%rbp), %rax
+	jne	.L24
+.L26:
+	movl	$1, %eax
+	jmp	.L25
+.L24:
+	movl	$0, %eax
+.L25:
+	mov	%eax, -273(%rbp)	# spill
+	movl	-273(%rbp), %esi
+	movq	-269(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#IF
+#REMAINDER
+#MULTIPLY
+#DEREFERENCE
+	mov	-28(%rbp), %rax
+	movq	(%rax), %rax
+	mov	-20(%rbp), %rdi
+	imul	%rax, %rdi
+#CAST
+#ADD
+#DEREFERENCE
+	mov	-12(%rbp), %rax
+	movl	(%rax), %eax
+	add	$1, %eax
+	mov	%eax, %esi
+	movslq	%esi, %rsi
+	mov	%rdi, %rax
+	cqto
+	idivq	%rsi
+#CAST
+	mov	$5, %eax
+	movslq	%eax, %rax
+	cmpq	%rax, %rdx
+	jle	.L27
+#ADDRESS
+	leaq	.L29(%rip), %rax
+#ADD
+#SUBTRACT
+#SUBTRACT
+#CAST
+#MULTIPLY
+#CAST
+	mov	-29(%rbp), %dil
+	movsbl	%dil, %edi
+	mov	i1(%rip), %esi
+	imul	%edi, %esi
+	mov	%esi, %edi
+	movslq	%edi, %rdi
+	mov	l1(%rip), %rsi
+	sub	%rdi, %rsi
+#CAST
+#REMAINDER
+#CAST
+#DEREFERENCE
+	mov	s1(%rip), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %dl
+	movsbl	%dl, %edx
+#DEREFERENCE
+	mov	-12(%rbp), %rdi
+	movl	(%rdi), %edi
+	mov	%rax, -305(%rbp)	# spill
+	mov	%edx, %eax
+	cltd
+	idivl	%edi
+	mov	%edx, %eax
+	movslq	%eax, %rax
+	sub	%rax, %rsi
+#CAST
+#GREATER OR EQUAL
+	mov	l1(%rip), %rax
+	cmpq	-20(%rbp), %rax
+	setge	%al
+	movzbl	%al, %eax
+	mov	%eax, %edi
+	movslq	%edi, %rdi
+	add	%rdi, %rsi
+	mov	%rsi, -329(%rbp)	# spill
+	movq	-329(%rbp), %rsi
+	movq	-305(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+	jmp	.L28
+.L27:
+#IF
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+#ADD
+#CAST
+#DEREFERENCE
+	mov	-37(%rbp), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %sil
+	movsbl	%sil, %esi
+	mov	%eax, -333(%rbp)	# spill
+	mov	%esi, -337(%rbp)	# spill
+	movl	-337(%rbp), %edi
+	movl	$0, %eax
+	call	abs
+	add	$4, %eax
+	mov	%eax, -345(%rbp)	# spill
+	mov	-333(%rbp), %eax
+	cltd
+	idivl	-345(%rbp)
+	cmpl	$10, %edx
+	jge	.L30
+#ADDRESS
+	leaq	.L32(%rip), %rax
+#ADD
+#ADD
+#CAST
+#DEREFERENCE
+	mov	s1(%rip), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %sil
+	movsbl	%sil, %esi
+#CAST
+#DEREFERENCE
+#DEREFERENCE
+#ADDRESS
+	leaq	-37(%rbp), %rdi
+	movq	(%rdi), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %dl
+	movsbl	%dl, %edx
+	add	%edx, %esi
+#MULTIPLY
+#NOT EQUAL
+#CAST
+	mov	c1(%rip), %dil
+	movsbq	%dil, %rdi
+	cmpq	-20(%rbp), %rdi
+	setne	%dil
+	movzbl	%dil, %edi
+#NOT EQUAL
+#CAST
+	mov	-29(%rbp), %dl
+	movsbl	%dl, %edx
+	cmpl	-4(%rbp), %edx
+	setne	%dl
+	movzbl	%dl, %edx
+	imul	%edx, %edi
+	add	%edi, %esi
+	mov	%rax, -365(%rbp)	# spill
+	mov	%esi, -369(%rbp)	# spill
+	movl	-369(%rbp), %esi
+	movq	-365(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+	jmp	.L31
+.L30:
+#ADDRESS
+	leaq	.L33(%rip), %rax
+#ADD
+#SUBTRACT
+#SUBTRACT
+#DIVIDE
+#CAST
+	mov	$7, %edi
+	movslq	%edi, %rdi
+	mov	%rax, -377(%rbp)	# spill
+	mov	l1(%rip), %rax
+	cqto
+	idivq	%rdi
+#CAST
+	mov	-29(%rbp), %dil
+	movsbq	%dil, %rdi
+	sub	%rdi, %rax
+#CAST
+#REMAINDER
+#CAST
+#DEREFERENCE
+	mov	s1(%rip), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %sil
+	movsbl	%sil, %esi
+#DEREFERENCE
+	mov	-12(%rbp), %rdi
+	movl	(%rdi), %edi
+	mov	%rax, -393(%rbp)	# spill
+	mov	%esi, %eax
+	cltd
+	idivl	%edi
+	mov	%edx, %eax
+	movslq	%eax, %rax
+	mov	-393(%rbp), %rdi
+	sub	%rax, %rdi
+#CAST
+#GREATER OR EQUAL
+	mov	l1(%rip), %rax
+	cmpq	-20(%rbp), %rax
+	setge	%al
+	movzbl	%al, %eax
+	mov	%eax, %esi
+	movslq	%esi, %rsi
+	add	%rsi, %rdi
+	mov	%rdi, -417(%rbp)	# spill
+	movq	-417(%rbp), %rsi
+	movq	-377(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	c1(%rip), %rax
+	movq	%rax, s1(%rip)
+#ADDRESS
+	leaq	-29(%rbp), %rax
+	movq	%rax, -37(%rbp)
+.L31:
+.L28:
+#IF
+#ADD
+#ADD
+#MULTIPLY
+#CAST
+	mov	i1(%rip), %eax
+	movslq	%eax, %rax
+	imul	$1, %rax
+#ADD
+#MULTIPLY
+#CAST
+#DEREFERENCE
+	mov	s1(%rip), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %sil
+	movsbq	%sil, %rsi
+	imul	$1, %rsi
+	add	-37(%rbp), %rsi
+	add	%rsi, %rax
+#MULTIPLY
+#MULTIPLY
+#CAST
+	mov	c1(%rip), %dil
+	movsbq	%dil, %rdi
+#DEREFERENCE
+	mov	-28(%rbp), %rsi
+	movq	(%rsi), %rsi
+	imul	%rsi, %rdi
+	imul	$1, %rdi
+	add	%rdi, %rax
+	testq	%rax, %rax
+	je	.L34
+#ADDRESS
+	leaq	.L36(%rip), %rax
+#ADD
+#ADD
+	mov	l1(%rip), %rdi
+	add	-20(%rbp), %rdi
+#CAST
+	mov	c1(%rip), %sil
+	movsbq	%sil, %rsi
+	add	%rsi, %rdi
+	mov	%rax, -497(%rbp)	# spill
+	mov	%rdi, -505(%rbp)	# spill
+	movq	-505(%rbp), %rsi
+	movq	-497(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+.L34:
+#IF
+#SUBTRACT
+#ADD
+#MULTIPLY
+	mov	$100, %rax
+	imul	$1, %rax
+#ADDRESS
+	leaq	t(%rip), %rdi
+	add	%rdi, %rax
+#MULTIPLY
+#CAST
+	mov	$1, %edi
+	movslq	%edi, %rdi
+	imul	$1, %rdi
+	sub	%rdi, %rax
+	cmpq	-45(%rbp), %rax
+	jl	.L37
+#CAST
+#ADD
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$26, %ecx
+	cltd
+	idivl	%ecx
+	mov	$65, %eax
+	add	%edx, %eax
+	mov	%eax, %edi
+	movb	%dil,  %dil
+	mov	-45(%rbp), %rax
+	movb	%dil, (%rax)
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$1, %rax
+	mov	-45(%rbp), %rdi
+	add	%rax, %rdi
+	movq	%rdi, -45(%rbp)
+.L37:
+#SUBTRACT
+#CAST
+#REMAINDER
+	movl	$0, %eax
+	call	rand
+	mov	$100, %ecx
+	cltd
+	idivl	%ecx
+	mov	%edx, %eax
+	movslq	%eax, %rax
+	mov	l1(%rip), %rdi
+	sub	%rax, %rdi
+	movq	%rdi, l1(%rip)
+	jmp	.L21
+.L22:
+#CAST
+#ADDRESS
+	leaq	t(%rip), %rax
+	mov	%rax, %rdi
+	movq	%rdi, -12(%rbp)
+	mov	$0, %eax
+	movl	%eax, i1(%rip)
+#CAST
+	mov	$0, %eax
+	movb	%al,  %al
+	mov	s3(%rip), %rdi
+	movb	%al, (%rdi)
+#CAST
+	mov	$0, %eax
+	movb	%al,  %al
+	mov	-45(%rbp), %rdi
+	movb	%al, (%rdi)
+#WHILE
+.L39:
+	mov	i1(%rip), %eax
+	cmpl	$5, %eax
+	jge	.L40
+#ADDRESS
+	leaq	.L41(%rip), %rax
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	i1(%rip), %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	mov	-12(%rbp), %rsi
+	add	%rdi, %rsi
+	movl	(%rsi), %esi
+	mov	%rax, -589(%rbp)	# spill
+	mov	%esi, -593(%rbp)	# spill
+	movl	-593(%rbp), %esi
+	movq	-589(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADD
+	mov	i1(%rip), %eax
+	add	$1, %eax
+	movl	%eax, i1(%rip)
+	jmp	.L39
+.L40:
+#ADDRESS
+	leaq	.L42(%rip), %rax
+#ADD
+#CAST
+#DEREFERENCE
+	mov	s1(%rip), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %sil
+	movsbl	%sil, %esi
+#MULTIPLY
+#MULTIPLY
+#CAST
+#DEREFERENCE
+	mov	-37(%rbp), %rdi
+	movb	(%rdi), %dil
+	mov	%dil, %dl
+	movsbl	%dl, %edx
+#DEREFERENCE
+	mov	p1(%rip), %rdi
+	movl	(%rdi), %edi
+	imul	%edi, %edx
+#DEREFERENCE
+	mov	-12(%rbp), %rdi
+	movl	(%rdi), %edi
+	imul	%edi, %edx
+	add	%edx, %esi
+	mov	%rax, -617(%rbp)	# spill
+	mov	%esi, -621(%rbp)	# spill
+	movl	-621(%rbp), %esi
+	movq	-617(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L43(%rip), %rax
+#ADDRESS
+	leaq	s(%rip), %rdi
+#ADDRESS
+	leaq	t(%rip), %rsi
+	mov	%rax, -629(%rbp)	# spill
+	mov	%rdi, -637(%rbp)	# spill
+	mov	%rsi, -645(%rbp)	# spill
+	movq	-645(%rbp), %rdx
+	movq	-637(%rbp), %rsi
+	movq	-629(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+	movl	$10, %edi
+	movl	$0, %eax
+	call	putchar
+	jmp	.L9
+.L10:
+.L8:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 656
+	.globl	main
+
+	.comm	i1, 4
+	.comm	p1, 8
+	.comm	z, 4
+	.comm	l1, 8
+	.comm	q1, 8
+	.comm	c1, 1
+	.comm	s1, 8
+	.comm	s3, 8
+	.comm	s, 100
+	.comm	t, 100
+.L11:	.asciz "i1 = %d  i2 = %d\n"
+.L14:	.asciz "%d "
+.L15:	.asciz "%d "
+.L20:	.asciz "%d "
+.L23:	.asciz "%d "
+.L29:	.asciz "%ld "
+.L32:	.asciz "%d "
+.L33:	.asciz "%d "
+.L36:	.asciz "%d "
+.L41:	.asciz "%d "
+.L42:	.asciz "%d "
+.L43:	.asciz "%.20s %.20s"
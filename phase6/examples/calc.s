@@ -0,0 +1,361 @@
+lexan:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$lexan.size, %eax
+	subq	%rax, %rsp
+#IF
+	mov	c(%rip), %eax
+	cmpl	$0, %eax
+	jne	.L1
+	movl	$0, %eax
+	call	getchar
+	movl	%eax, c(%rip)
+.L1:
+#WHILE
+.L3:
+	movl	c(%rip), %edi
+	movl	$0, %eax
+	call	isspace
+	testl	%eax, %eax
+	je	.L4
+	mov	c(%rip), %eax
+	cmpl	NL(%rip), %eax
+	je	.L4
+	movl	$0, %eax
+	call	getchar
+	movl	%eax, c(%rip)
+	jmp	.L3
+.L4:
+#IF
+	movl	c(%rip), %edi
+	movl	$0, %eax
+	call	isdigit
+	testl	%eax, %eax
+	jne	.L5
+	mov	c(%rip), %eax
+	movl	%eax, -8(%rbp)
+	mov	$0, %eax
+	movl	%eax, c(%rip)
+	mov	-8(%rbp), %eax
+	jmp	.L0
+.L5:
+	mov	$0, %eax
+	movl	%eax, -4(%rbp)
+#WHILE
+.L7:
+	movl	c(%rip), %edi
+	movl	$0, %eax
+	call	isdigit
+	testl	%eax, %eax
+	je	.L8
+#SUBTRACT
+#ADD
+#MULTIPLY
+	mov	-4(%rbp), %eax
+	imul	$10, %eax
+	add	c(%rip), %eax
+	sub	$48, %eax
+	movl	%eax, -4(%rbp)
+	movl	c(%rip), %edi
+	movl	$0, %eax
+	call	getchar
+	movl	%eax, c(%rip)
+	jmp	.L7
+.L8:
+	mov	-4(%rbp), %eax
+	movl	%eax, lexval(%rip)
+	mov	NUM(%rip), %eax
+	jmp	.L0
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	lexan.size, 32
+	.globl	lexan
+
+match:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$match.size, %eax
+	subq	%rax, %rsp
+	movl	%edi, -4(%rbp)
+#IF
+	mov	lookahead(%rip), %eax
+	cmpl	-4(%rbp), %eax
+	je	.L10
+#ADDRESS
+	leaq	.L12(%rip), %rax
+	mov	%rax, -12(%rbp)	# spill
+	movl	lookahead(%rip), %esi
+	movq	-12(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+	movl	$1, %edi
+	movl	$0, %eax
+	call	exit
+.L10:
+	call	lexan
+	movl	%eax, lookahead(%rip)
+.L9:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	match.size, 16
+	.globl	match
+
+factor:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$factor.size, %eax
+	subq	%rax, %rsp
+#IF
+	mov	lookahead(%rip), %eax
+	cmpl	LPAREN(%rip), %eax
+	jne	.L14
+	movl	LPAREN(%rip), %edi
+	call	match
+	movl	$0, %eax
+	call	expr
+	movl	%eax, -4(%rbp)
+	movl	RPAREN(%rip), %edi
+	call	match
+	mov	-4(%rbp), %eax
+	jmp	.L13
+.L14:
+	mov	lexval(%rip), %eax
+	movl	%eax, -4(%rbp)
+	movl	NUM(%rip), %edi
+	call	match
+	mov	-4(%rbp), %eax
+	jmp	.L13
+.L13:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	factor.size, 16
+	.globl	factor
+
+term:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$term.size, %eax
+	subq	%rax, %rsp
+	call	factor
+	movl	%eax, -4(%rbp)
+#WHILE
+.L17:
+	mov	lookahead(%rip), %eax
+	cmpl	STAR(%rip), %eax
+	je	.L19
+	mov	lookahead(%rip), %eax
+	cmpl	SLASH(%rip), %eax
+	jne	.L18
+.L19:
+#IF
+	mov	lookahead(%rip), %eax
+	cmpl	STAR(%rip), %eax
+	jne	.L20
+	movl	STAR(%rip), %edi
+	call	match
+#MULTIPLY
+	call	factor
+	mov	-4(%rbp), %edi
+	imul	%eax, %edi
+	movl	%edi, -4(%rbp)
+	jmp	.L21
+.L20:
+	movl	SLASH(%rip), %edi
+	call	match
+#DIVIDE
+	call	factor
+	mov	%eax, -12(%rbp)	# spill
+	mov	-4(%rbp), %eax
+	cltd
+	idivl	-12(%rbp)
+	movl	%eax, -4(%rbp)
+.L21:
+	jmp	.L17
+.L18:
+	mov	-4(%rbp), %eax
+	jmp	.L16
+.L16:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	term.size, 16
+	.globl	term
+
+expr:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$expr.size, %eax
+	subq	%rax, %rsp
+	call	term
+	movl	%eax, -4(%rbp)
+#WHILE
+.L23:
+	mov	lookahead(%rip), %eax
+	cmpl	PLUS(%rip), %eax
+	je	.L25
+	mov	lookahead(%rip), %eax
+	cmpl	MINUS(%rip), %eax
+	jne	.L24
+.L25:
+#IF
+	mov	lookahead(%rip), %eax
+	cmpl	PLUS(%rip), %eax
+	jne	.L26
+	movl	PLUS(%rip), %edi
+	call	match
+#ADD
+	call	term
+	mov	-4(%rbp), %edi
+	add	%eax, %edi
+	movl	%edi, -4(%rbp)
+	jmp	.L27
+.L26:
+	movl	MINUS(%rip), %edi
+	call	match
+#SUBTRACT
+	call	term
+	mov	-4(%rbp), %edi
+	sub	%eax, %edi
+	movl	%edi, -4(%rbp)
+.L27:
+	jmp	.L23
+.L24:
+	mov	-4(%rbp), %eax
+	jmp	.L22
+.L22:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	expr.size, 16
+	.globl	expr
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+	mov	$256, %eax
+	movl	%eax, NUM(%rip)
+#CAST
+#DEREFERENCE
+#ADDRESS
+	leaq	.L29(%rip), %rax
+	movb	(%rax), %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	movl	%edi, NL(%rip)
+#CAST
+#DEREFERENCE
+#ADDRESS
+	leaq	.L30(%rip), %rax
+	movb	(%rax), %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	movl	%edi, LPAREN(%rip)
+#CAST
+#DEREFERENCE
+#ADDRESS
+	leaq	.L31(%rip), %rax
+	movb	(%rax), %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	movl	%edi, RPAREN(%rip)
+#CAST
+#DEREFERENCE
+#ADDRESS
+	leaq	.L32(%rip), %rax
+	movb	(%rax), %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	movl	%edi, PLUS(%rip)
+#CAST
+#DEREFERENCE
+#ADDRESS
+	leaq	.L33(%rip), %rax
+	movb	(%rax), %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	movl	%edi, MINUS(%rip)
+#CAST
+#DEREFERENCE
+#ADDRESS
+	leaq	.L34(%rip), %rax
+	movb	(%rax), %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	movl	%edi, STAR(%rip)
+#CAST
+#DEREFERENCE
+#ADDRESS
+	leaq	.L35(%rip), %rax
+	movb	(%rax), %al
+	mov	%al, %dil
+	movsbl	%dil, %edi
+	movl	%edi, SLASH(%rip)
+	call	lexan
+	movl	%eax, lookahead(%rip)
+#WHILE
+.L36:
+#NEGATE
+	mov	$1, %eax
+	negl	%eax
+	mov	lookahead(%rip), %edi
+	cmpl	%eax, %edi
+	je	.L37
+	call	expr
+	movl	%eax, -4(%rbp)
+#ADDRESS
+	leaq	.L38(%rip), %rax
+	mov	%rax, -12(%rbp)	# spill
+	movl	-4(%rbp), %esi
+	movq	-12(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#WHILE
+.L39:
+	mov	lookahead(%rip), %eax
+	cmpl	NL(%rip), %eax
+	jne	.L40
+	movl	NL(%rip), %edi
+	call	match
+	jmp	.L39
+.L40:
+	jmp	.L36
+.L37:
+.L28:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 16
+	.globl	main
+
+	.comm	NUM, 4
+	.comm	NL, 4
+	.comm	LPAREN, 4
+	.comm	RPAREN, 4
+	.comm	PLUS, 4
+	.comm	MINUS, 4
+	.comm	STAR, 4
+	.comm	SLASH, 4
+	.comm	lookahead, 4
+	.comm	c, 4
+	.comm	lexval, 4
+.L12:	.asciz "syntax error at %d\n"
+.L29:	.asciz "\n"
+.L30:	.asciz "("
+.L31:	.asciz ")"
+.L32:	.asciz "+"
+.L33:	.asciz "-"
+.L34:	.asciz "*"
+.L35:	.asciz "/"
+.L38:	.asciz "%d\n"
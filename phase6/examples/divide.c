@@ -0,0 +1,74 @@
+/* divide.c */
+
+int *malloc(), printf();
+long *calloc();
+
+int digits(int n)
+{
+    int s;
+
+    s = 0;
+
+    while (n != 0) {
+	s = s + n % 10;
+	n = n / 10;
+    }
+
+    return s;
+}
+
+int hash(int n)
+{
+    return n * 9 + n / 7 - n % 13 + n / 16 * 5 + n % 1000;
+}
+
+long scale(long *a, int *b, int n)
+{
+    int i;
+    long s;
+
+    i = 0;
+    s = 0;
+
+    while (i < n) {
+	s = s + a[i] * 3 + b[i] * 8 + a[i] / 10007 + b[n - i - 1] % 64;
+	i = i + 1;
+    }
+
+    return s;
+}
+
+int main(void)
+{
+    long *a, s;
+    int *b, i, n;
+
+    n = 1000;
+    a = calloc(n, sizeof a[0]);
+    b = malloc(n * sizeof b[0]);
+
+    i = 0;
+    s = 0;
+
+    while (i < n) {
+	a[i] = i * 1234567;
+	b[i] = i * 37 - 500;
+	i = i + 1;
+    }
+
+    i = 0;
+
+    while (i < 3000000) {
+	s = s + digits(i * 7 - 10000000) + hash(i - 1500000);
+	i = i + 1;
+    }
+
+    i = 0;
+
+    while (i < 20000) {
+	s = s + scale(a, b, n) % 1000;
+	i = i + 1;
+    }
+
+    printf("%ld\n", s);
+}
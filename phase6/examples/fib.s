@@ -0,0 +1,78 @@
+fib:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$fib.size, %eax
+	subq	%rax, %rsp
+	movl	%edi, -4(%rbp)
+#IF
+	mov	-4(%rbp), %eax
+	cmpl	$0, %eax
+	je	.L3
+	mov	-4(%rbp), %eax
+	cmpl	$1, %eax
+	jne	.L1
+.L3:
+	mov	$1, %eax
+	jmp	.L0
+.L1:
+#ADD
+#SUBTRACT
+	mov	-4(%rbp), %eax
+	sub	$1, %eax
+	mov	%eax, -12(%rbp)	# spill
+	movl	-12(%rbp), %edi
+	call	fib
+#SUBTRACT
+	mov	-4(%rbp), %edi
+	sub	$2, %edi
+	mov	%eax, -20(%rbp)	# spill
+	mov	%edi, -24(%rbp)	# spill
+	movl	-24(%rbp), %edi
+	call	fib
+	mov	-20(%rbp), %edi
+	add	%eax, %edi
+	mov	%edi, %eax
+	jmp	.L0
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	fib.size, 32
+	.globl	fib
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+#ADDRESS
+	leaq	.L5(%rip), %rax
+#ADDRESS
+	leaq	-4(%rbp), %rdi
+	mov	%rax, -12(%rbp)	# spill
+	mov	%rdi, -20(%rbp)	# spill
+	movq	-20(%rbp), %rsi
+	movq	-12(%rbp), %rdi
+	movl	$0, %eax
+	call	scanf
+#ADDRESS
+	leaq	.L6(%rip), %rax
+	mov	%rax, -28(%rbp)	# spill
+	movl	-4(%rbp), %edi
+	call	fib
+	mov	%eax, -32(%rbp)	# spill
+	movl	-32(%rbp), %esi
+	movq	-28(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+.L4:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 32
+	.globl	main
+
+.L5:	.asciz "%d"
+.L6:	.asciz "%d\n"
@@ -0,0 +1,51 @@
+foo:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$foo.size, %eax
+	subq	%rax, %rsp
+#ADD
+	mov	x(%rip), %eax
+	add	$1, %eax
+	movl	%eax, x(%rip)
+#ADD
+	mov	x(%rip), %eax
+	add	$1, %eax
+	jmp	.L0
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	foo.size, 16
+	.globl	foo
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+	mov	$65, %eax
+	movl	%eax, x(%rip)
+	movl	x(%rip), %edi
+	movl	$0, %eax
+	call	putchar
+	call	foo
+	mov	%eax, -4(%rbp)	# spill
+	movl	-4(%rbp), %edi
+	movl	$0, %eax
+	call	putchar
+	movl	x(%rip), %edi
+	movl	$0, %eax
+	call	putchar
+	movl	$10, %edi
+	movl	$0, %eax
+	call	putchar
+.L1:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 16
+	.globl	main
+
+	.comm	x, 4
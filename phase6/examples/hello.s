@@ -0,0 +1,20 @@
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+#ADDRESS
+	leaq	.L1(%rip), %rax
+	mov	%rax, -8(%rbp)	# spill
+	movq	-8(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 16
+	.globl	main
+
+.L1:	.asciz "hello world\n"
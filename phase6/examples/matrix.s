@@ -0,0 +1,282 @@
+allocate:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$allocate.size, %eax
+	subq	%rax, %rsp
+	movl	%edi, -4(%rbp)
+	mov	$0, %eax
+	movl	%eax, -8(%rbp)
+#CAST
+#MULTIPLY
+#CAST
+	mov	-4(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	%rax, -32(%rbp)	# spill
+	movq	-32(%rbp), %rdi
+	movl	$0, %eax
+	call	malloc
+	mov	%rax, %rdi
+	movq	%rdi, -16(%rbp)
+#WHILE
+.L1:
+	mov	-8(%rbp), %eax
+	cmpl	-4(%rbp), %eax
+	jge	.L2
+#ADD
+#MULTIPLY
+#CAST
+	mov	-8(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-16(%rbp), %rdi
+	add	%rax, %rdi
+#MULTIPLY
+#CAST
+	mov	-4(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	%rax, -64(%rbp)	# spill
+	mov	%rdi, -72(%rbp)	# spill
+	movq	-64(%rbp), %rdi
+	movl	$0, %eax
+	call	malloc
+	mov	-72(%rbp), %rdi
+	movq	%rax, (%rdi)
+#ADD
+	mov	-8(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -8(%rbp)
+	jmp	.L1
+.L2:
+	mov	-16(%rbp), %rax
+	jmp	.L0
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	allocate.size, 80
+	.globl	allocate
+
+initialize:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$initialize.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movl	%esi, -12(%rbp)
+	mov	$0, %eax
+	movl	%eax, -16(%rbp)
+#WHILE
+.L4:
+	mov	-16(%rbp), %eax
+	cmpl	-12(%rbp), %eax
+	jge	.L5
+	mov	$0, %eax
+	movl	%eax, -20(%rbp)
+#WHILE
+.L6:
+	mov	-20(%rbp), %eax
+	cmpl	-12(%rbp), %eax
+	jge	.L7
+#ADD
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-16(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+#MULTIPLY
+#CAST
+	mov	-20(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	add	%rax, %rdi
+#ADD
+	mov	-16(%rbp), %eax
+	add	-20(%rbp), %eax
+	movl	%eax, (%rdi)
+#ADD
+	mov	-20(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -20(%rbp)
+	jmp	.L6
+.L7:
+#ADD
+	mov	-16(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -16(%rbp)
+	jmp	.L4
+.L5:
+.L3:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	initialize.size, 64
+	.globl	initialize
+
+display:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$display.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movl	%esi, -12(%rbp)
+	mov	$0, %eax
+	movl	%eax, -16(%rbp)
+#WHILE
+.L9:
+	mov	-16(%rbp), %eax
+	cmpl	-12(%rbp), %eax
+	jge	.L10
+	mov	$0, %eax
+	movl	%eax, -20(%rbp)
+#WHILE
+.L11:
+	mov	-20(%rbp), %eax
+	cmpl	-12(%rbp), %eax
+	jge	.L12
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-16(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	movq	%rdi, -28(%rbp)
+#ADDRESS
+	leaq	.L13(%rip), %rax
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-20(%rbp), %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	mov	-28(%rbp), %rsi
+	add	%rdi, %rsi
+	movl	(%rsi), %esi
+	mov	%rax, -68(%rbp)	# spill
+	mov	%esi, -72(%rbp)	# spill
+	movl	-72(%rbp), %esi
+	movq	-68(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADD
+	mov	-20(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -20(%rbp)
+	jmp	.L11
+.L12:
+#ADD
+	mov	-16(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -16(%rbp)
+#ADDRESS
+	leaq	.L14(%rip), %rax
+	mov	%rax, -88(%rbp)	# spill
+	movq	-88(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+	jmp	.L9
+.L10:
+.L8:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	display.size, 96
+	.globl	display
+
+deallocate:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$deallocate.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movl	%esi, -12(%rbp)
+	mov	$0, %eax
+	movl	%eax, -16(%rbp)
+#WHILE
+.L16:
+	mov	-16(%rbp), %eax
+	cmpl	-12(%rbp), %eax
+	jge	.L17
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-16(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	%rdi, -40(%rbp)	# spill
+	movq	-40(%rbp), %rdi
+	movl	$0, %eax
+	call	free
+#ADD
+	mov	-16(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -16(%rbp)
+	jmp	.L16
+.L17:
+	movq	-8(%rbp), %rdi
+	movl	$0, %eax
+	call	free
+.L15:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	deallocate.size, 48
+	.globl	deallocate
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+#ADDRESS
+	leaq	.L19(%rip), %rax
+#ADDRESS
+	leaq	-12(%rbp), %rdi
+	mov	%rax, -20(%rbp)	# spill
+	mov	%rdi, -28(%rbp)	# spill
+	movq	-28(%rbp), %rsi
+	movq	-20(%rbp), %rdi
+	movl	$0, %eax
+	call	scanf
+	movl	-12(%rbp), %edi
+	call	allocate
+	movq	%rax, -8(%rbp)
+	movl	-12(%rbp), %esi
+	movq	-8(%rbp), %rdi
+	call	initialize
+	movl	-12(%rbp), %esi
+	movq	-8(%rbp), %rdi
+	call	display
+	movl	-12(%rbp), %esi
+	movq	-8(%rbp), %rdi
+	call	deallocate
+.L18:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 32
+	.globl	main
+
+.L13:	.asciz "%d "
+.L14:	.asciz "\n"
+.L19:	.asciz "%d"
@@ -0,0 +1,140 @@
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+	mov	$100, %eax
+	movl	%eax, -12(%rbp)
+#CAST
+	mov	$30, %eax
+	movb	%al,  %al
+	movb	%al, -30(%rbp)
+#CAST
+	mov	$2, %eax
+	movb	%al,  %al
+	movb	%al, -31(%rbp)
+#ADD
+#ADD
+#CAST
+	mov	-30(%rbp), %al
+	movsbl	%al, %eax
+	mov	-12(%rbp), %edi
+	add	%eax, %edi
+#CAST
+	mov	-31(%rbp), %al
+	movsbl	%al, %eax
+	add	%eax, %edi
+	movl	%edi, -4(%rbp)
+#CAST
+#SUBTRACT
+#SUBTRACT
+#CAST
+	mov	-30(%rbp), %al
+	movsbl	%al, %eax
+	mov	-12(%rbp), %edi
+	sub	%eax, %edi
+#CAST
+	mov	-31(%rbp), %al
+	movsbl	%al, %eax
+	sub	%eax, %edi
+	mov	%edi, %eax
+	movslq	%eax, %rax
+	movq	%rax, -20(%rbp)
+#CAST
+#MULTIPLY
+#MULTIPLY
+#CAST
+	mov	-30(%rbp), %al
+	movsbl	%al, %eax
+	mov	-12(%rbp), %edi
+	imul	%eax, %edi
+#CAST
+	mov	-31(%rbp), %al
+	movsbl	%al, %eax
+	imul	%eax, %edi
+	mov	%edi, %eax
+	movslq	%eax, %rax
+	movq	%rax, -28(%rbp)
+#ADD
+#DIVIDE
+#CAST
+	mov	-30(%rbp), %al
+	movsbl	%al, %eax
+	mov	%eax, -59(%rbp)	# spill
+	mov	-12(%rbp), %eax
+	cltd
+	idivl	-59(%rbp)
+#CAST
+	mov	-31(%rbp), %dil
+	movsbl	%dil, %edi
+	add	%edi, %eax
+	movl	%eax, -8(%rbp)
+#CAST
+#SUBTRACT
+#REMAINDER
+#CAST
+	mov	-30(%rbp), %al
+	movsbl	%al, %eax
+	mov	%eax, -67(%rbp)	# spill
+	mov	-12(%rbp), %eax
+	cltd
+	idivl	-67(%rbp)
+#CAST
+	mov	-31(%rbp), %al
+	movsbl	%al, %eax
+	sub	%eax, %edx
+	mov	%edx, %eax
+	movb	%al,  %al
+	movb	%al, -29(%rbp)
+#ADDRESS
+	leaq	.L1(%rip), %rax
+	mov	%rax, -79(%rbp)	# spill
+	movl	-4(%rbp), %esi
+	movq	-79(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L2(%rip), %rax
+	mov	%rax, -87(%rbp)	# spill
+	movq	-20(%rbp), %rsi
+	movq	-87(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L3(%rip), %rax
+	mov	%rax, -95(%rbp)	# spill
+	movq	-28(%rbp), %rsi
+	movq	-95(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L4(%rip), %rax
+	mov	%rax, -103(%rbp)	# spill
+	movl	-8(%rbp), %esi
+	movq	-103(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L5(%rip), %rax
+#CAST
+	mov	-29(%rbp), %dil
+	movsbl	%dil, %edi
+	mov	%rax, -111(%rbp)	# spill
+	mov	%edi, -115(%rbp)	# spill
+	movl	-115(%rbp), %esi
+	movq	-111(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 128
+	.globl	main
+
+.L1:	.asciz "%d\n"
+.L2:	.asciz "%ld\n"
+.L3:	.asciz "%ld\n"
+.L4:	.asciz "%d\n"
+.L5:	.asciz "%d\n"
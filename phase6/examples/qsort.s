@@ -0,0 +1,318 @@
+readarray:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$readarray.size, %eax
+	subq	%rax, %rsp
+	mov	$0, %eax
+	movl	%eax, -4(%rbp)
+#WHILE
+.L1:
+	mov	-4(%rbp), %eax
+	cmpl	n(%rip), %eax
+	jge	.L2
+#ADDRESS
+	leaq	.L3(%rip), %rax
+#ADDRESS
+#ADD
+#MULTIPLY
+#CAST
+	mov	-4(%rbp), %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	mov	a(%rip), %rsi
+	add	%rdi, %rsi
+	mov	%rax, -28(%rbp)	# spill
+	mov	%rsi, -36(%rbp)	# spill
+	movq	-36(%rbp), %rsi
+	movq	-28(%rbp), %rdi
+	movl	$0, %eax
+	call	scanf
+#ADD
+	mov	-4(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -4(%rbp)
+	jmp	.L1
+.L2:
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	readarray.size, 48
+	.globl	readarray
+
+writearray:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$writearray.size, %eax
+	subq	%rax, %rsp
+	mov	$0, %eax
+	movl	%eax, -4(%rbp)
+#WHILE
+.L5:
+	mov	-4(%rbp), %eax
+	cmpl	n(%rip), %eax
+	jge	.L6
+#ADDRESS
+	leaq	.L7(%rip), %rax
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-4(%rbp), %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	mov	a(%rip), %rsi
+	add	%rdi, %rsi
+	movl	(%rsi), %esi
+	mov	%rax, -28(%rbp)	# spill
+	mov	%esi, -32(%rbp)	# spill
+	movl	-32(%rbp), %esi
+	movq	-28(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADD
+	mov	-4(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -4(%rbp)
+	jmp	.L5
+.L6:
+#ADDRESS
+	leaq	.L8(%rip), %rax
+	mov	%rax, -44(%rbp)	# spill
+	movq	-44(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+.L4:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	writearray.size, 48
+	.globl	writearray
+
+exchange:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$exchange.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movq	%rsi, -16(%rbp)
+#DEREFERENCE
+	mov	-8(%rbp), %rax
+	movl	(%rax), %eax
+	movl	%eax, -20(%rbp)
+#DEREFERENCE
+	mov	-16(%rbp), %rax
+	movl	(%rax), %eax
+	mov	-8(%rbp), %rdi
+	movl	%eax, (%rdi)
+	mov	-16(%rbp), %rax
+	mov	-20(%rbp), %edi
+	movl	%edi, (%rax)
+.L9:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	exchange.size, 32
+	.globl	exchange
+
+partition:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$partition.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movl	%esi, -12(%rbp)
+	movl	%edx, -16(%rbp)
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-12(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movl	(%rdi), %edi
+	movl	%edi, -28(%rbp)
+#SUBTRACT
+	mov	-12(%rbp), %eax
+	sub	$1, %eax
+	movl	%eax, -20(%rbp)
+#ADD
+	mov	-16(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -24(%rbp)
+#WHILE
+.L11:
+	mov	-20(%rbp), %eax
+	cmpl	-24(%rbp), %eax
+	jge	.L12
+#SUBTRACT
+	mov	-24(%rbp), %eax
+	sub	$1, %eax
+	movl	%eax, -24(%rbp)
+#WHILE
+.L13:
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-24(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movl	(%rdi), %edi
+	cmpl	-28(%rbp), %edi
+	jle	.L14
+#SUBTRACT
+	mov	-24(%rbp), %eax
+	sub	$1, %eax
+	movl	%eax, -24(%rbp)
+	jmp	.L13
+.L14:
+#ADD
+	mov	-20(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -20(%rbp)
+#WHILE
+.L15:
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-20(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movl	(%rdi), %edi
+	cmpl	-28(%rbp), %edi
+	jge	.L16
+#ADD
+	mov	-20(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -20(%rbp)
+	jmp	.L15
+.L16:
+#IF
+	mov	-20(%rbp), %eax
+	cmpl	-24(%rbp), %eax
+	jge	.L17
+#ADDRESS
+#ADD
+#MULTIPLY
+#CAST
+	mov	-20(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+#ADDRESS
+#ADD
+#MULTIPLY
+#CAST
+	mov	-24(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-8(%rbp), %rsi
+	add	%rax, %rsi
+	mov	%rdi, -140(%rbp)	# spill
+	mov	%rsi, -148(%rbp)	# spill
+	movq	-148(%rbp), %rsi
+	movq	-140(%rbp), %rdi
+	call	exchange
+.L17:
+	jmp	.L11
+.L12:
+	mov	-24(%rbp), %eax
+	jmp	.L10
+.L10:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	partition.size, 160
+	.globl	partition
+
+quicksort:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$quicksort.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movl	%esi, -12(%rbp)
+	movl	%edx, -16(%rbp)
+#IF
+	mov	-16(%rbp), %eax
+	cmpl	-12(%rbp), %eax
+	jle	.L20
+	movl	-16(%rbp), %edx
+	movl	-12(%rbp), %esi
+	movq	-8(%rbp), %rdi
+	call	partition
+	movl	%eax, -20(%rbp)
+	movl	-20(%rbp), %edx
+	movl	-12(%rbp), %esi
+	movq	-8(%rbp), %rdi
+	call	quicksort
+#ADD
+	mov	-20(%rbp), %eax
+	add	$1, %eax
+	mov	%eax, -28(%rbp)	# spill
+	movl	-16(%rbp), %edx
+	movl	-28(%rbp), %esi
+	movq	-8(%rbp), %rdi
+	call	quicksort
+.L20:
+.L19:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	quicksort.size, 32
+	.globl	quicksort
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+	mov	$8, %eax
+	movl	%eax, n(%rip)
+#MULTIPLY
+#CAST
+	mov	n(%rip), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	%rax, -16(%rbp)	# spill
+	movq	-16(%rbp), %rdi
+	movl	$0, %eax
+	call	malloc
+	movq	%rax, a(%rip)
+	call	readarray
+#SUBTRACT
+	mov	n(%rip), %eax
+	sub	$1, %eax
+	mov	%eax, -24(%rbp)	# spill
+	movl	-24(%rbp), %edx
+	movl	$0, %esi
+	movq	a(%rip), %rdi
+	call	quicksort
+	call	writearray
+.L22:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 32
+	.globl	main
+
+	.comm	n, 4
+	.comm	a, 8
+.L3:	.asciz "%d"
+.L7:	.asciz "%d "
+.L8:	.asciz "\n"
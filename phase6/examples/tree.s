@@ -0,0 +1,564 @@
+insert:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$insert.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movq	%rsi, -16(%rbp)
+#IF
+	mov	-8(%rbp), %rax
+	testq	%rax, %rax
+	jne	.L1
+#CAST
+#MULTIPLY
+#CAST
+	mov	$3, %eax
+	movslq	%eax, %rax
+	mov	$8, %rdi
+	imul	%rax, %rdi
+	mov	%rdi, -32(%rbp)	# spill
+	movq	-32(%rbp), %rdi
+	movl	$0, %eax
+	call	malloc
+	mov	%rax, %rdi
+	movq	%rdi, -8(%rbp)
+#ADD
+#MULTIPLY
+#CAST
+	mov	$0, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	mov	-16(%rbp), %rax
+	movq	%rax, (%rdi)
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	mov	null(%rip), %rax
+	movq	%rax, (%rdi)
+#ADD
+#MULTIPLY
+#CAST
+	mov	$2, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	mov	null(%rip), %rax
+	movq	%rax, (%rdi)
+	jmp	.L2
+.L1:
+#IF
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$0, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	-16(%rbp), %rax
+	cmpq	%rdi, %rax
+	jge	.L3
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+#CAST
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rsi
+	add	%rax, %rsi
+	movq	(%rsi), %rsi
+	mov	%rsi, %rax
+	mov	%rax, -136(%rbp)	# spill
+	mov	%rdi, -144(%rbp)	# spill
+	movq	-16(%rbp), %rsi
+	movq	-136(%rbp), %rdi
+	call	insert
+	mov	%rax, %rdi
+	mov	-144(%rbp), %rax
+	movq	%rdi, (%rax)
+	jmp	.L4
+.L3:
+#IF
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$0, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	-16(%rbp), %rax
+	cmpq	%rdi, %rax
+	jle	.L5
+#ADD
+#MULTIPLY
+#CAST
+	mov	$2, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+#CAST
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$2, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rsi
+	add	%rax, %rsi
+	movq	(%rsi), %rsi
+	mov	%rsi, %rax
+	mov	%rax, -200(%rbp)	# spill
+	mov	%rdi, -208(%rbp)	# spill
+	movq	-16(%rbp), %rsi
+	movq	-200(%rbp), %rdi
+	call	insert
+	mov	%rax, %rdi
+	mov	-208(%rbp), %rax
+	movq	%rdi, (%rax)
+.L5:
+.L4:
+.L2:
+	mov	-8(%rbp), %rax
+	jmp	.L0
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	insert.size, 208
+	.globl	insert
+
+search:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$search.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movq	%rsi, -16(%rbp)
+#IF
+	mov	-8(%rbp), %rax
+	testq	%rax, %rax
+	jne	.L8
+	mov	$0, %eax
+	jmp	.L7
+.L8:
+#IF
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$0, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	-16(%rbp), %rax
+	cmpq	%rdi, %rax
+	jge	.L10
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	%rdi, %rax
+	mov	%rax, -56(%rbp)	# spill
+	movq	-16(%rbp), %rsi
+	movq	-56(%rbp), %rdi
+	call	search
+	jmp	.L7
+.L10:
+#IF
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$0, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	-16(%rbp), %rax
+	cmpq	%rdi, %rax
+	jle	.L12
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$2, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	%rdi, %rax
+	mov	%rax, -96(%rbp)	# spill
+	movq	-16(%rbp), %rsi
+	movq	-96(%rbp), %rdi
+	call	search
+	jmp	.L7
+.L12:
+	mov	$1, %eax
+	jmp	.L7
+.L7:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	search.size, 96
+	.globl	search
+
+preorder:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$preorder.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+#IF
+	mov	-8(%rbp), %rax
+	testq	%rax, %rax
+	je	.L15
+#ADDRESS
+	leaq	.L17(%rip), %rax
+#DEREFERENCE
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$0, %edi
+	movslq	%edi, %rdi
+	imul	$8, %rdi
+	mov	-8(%rbp), %rsi
+	add	%rdi, %rsi
+	movq	(%rsi), %rsi
+	movl	(%rsi), %esi
+	mov	%rax, -32(%rbp)	# spill
+	mov	%esi, -36(%rbp)	# spill
+	movl	-36(%rbp), %esi
+	movq	-32(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	%rdi, %rax
+	mov	%rax, -60(%rbp)	# spill
+	movq	-60(%rbp), %rdi
+	call	preorder
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$2, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	%rdi, %rax
+	mov	%rax, -84(%rbp)	# spill
+	movq	-84(%rbp), %rdi
+	call	preorder
+.L15:
+.L14:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	preorder.size, 96
+	.globl	preorder
+
+inorder:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$inorder.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+#IF
+	mov	-8(%rbp), %rax
+	testq	%rax, %rax
+	je	.L19
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	%rdi, %rax
+	mov	%rax, -32(%rbp)	# spill
+	movq	-32(%rbp), %rdi
+	call	inorder
+#ADDRESS
+	leaq	.L21(%rip), %rax
+#DEREFERENCE
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$0, %edi
+	movslq	%edi, %rdi
+	imul	$8, %rdi
+	mov	-8(%rbp), %rsi
+	add	%rdi, %rsi
+	movq	(%rsi), %rsi
+	movl	(%rsi), %esi
+	mov	%rax, -56(%rbp)	# spill
+	mov	%esi, -60(%rbp)	# spill
+	movl	-60(%rbp), %esi
+	movq	-56(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#CAST
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	$2, %eax
+	movslq	%eax, %rax
+	imul	$8, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+	movq	(%rdi), %rdi
+	mov	%rdi, %rax
+	mov	%rax, -84(%rbp)	# spill
+	movq	-84(%rbp), %rdi
+	call	inorder
+.L19:
+.L18:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	inorder.size, 96
+	.globl	inorder
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+	mov	$0, %eax
+	movl	%eax, -52(%rbp)
+#WHILE
+.L23:
+	mov	-52(%rbp), %eax
+	cmpl	$8, %eax
+	jge	.L24
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	-52(%rbp), %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	-52(%rbp), %edi
+	movl	%edi, (%rax)
+#ADD
+	mov	-52(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -52(%rbp)
+	jmp	.L23
+.L24:
+#CAST
+	mov	null(%rip), %rax
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$7, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -96(%rbp)	# spill
+	movq	-96(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$4, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -120(%rbp)	# spill
+	movq	-120(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$1, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -144(%rbp)	# spill
+	movq	-144(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$0, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -168(%rbp)	# spill
+	movq	-168(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$5, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -192(%rbp)	# spill
+	movq	-192(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$2, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -216(%rbp)	# spill
+	movq	-216(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$3, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -240(%rbp)	# spill
+	movq	-240(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+#ADD
+#ADDRESS
+	leaq	-48(%rbp), %rax
+#MULTIPLY
+#CAST
+	mov	$6, %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	add	%rdi, %rax
+	mov	%rax, -264(%rbp)	# spill
+	movq	-264(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	insert
+	movq	%rax, -8(%rbp)
+#ADDRESS
+	leaq	.L25(%rip), %rax
+	mov	%rax, -272(%rbp)	# spill
+	movq	-272(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+	movq	-8(%rbp), %rdi
+	call	preorder
+#ADDRESS
+	leaq	.L26(%rip), %rax
+	mov	%rax, -280(%rbp)	# spill
+	movq	-280(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+	movq	-8(%rbp), %rdi
+	call	inorder
+.L22:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 288
+	.globl	main
+
+	.comm	null, 8
+.L17:	.asciz "%d\n"
+.L21:	.asciz "%d\n"
+.L25:	.asciz "preorder traversal:\n"
+.L26:	.asciz "inorder traversal:\n"
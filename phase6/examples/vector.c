@@ -0,0 +1,74 @@
+/* vector.c */
+
+int *malloc(), printf();
+
+int add(int *a, int *b, int *c, int n)
+{
+    int i;
+
+    i = 0;
+
+    while (i < n) {
+	a[i] = b[i] + c[i];
+	i = i + 1;
+    }
+}
+
+int saxpy(int *y, int *x, int k, int n)
+{
+    int i;
+
+    i = 0;
+
+    while (i < n) {
+	y[i] = k * x[i] + y[i];
+	i = i + 1;
+    }
+}
+
+int checksum(int *a, int n)
+{
+    int i, s;
+
+    i = 0;
+    s = 0;
+
+    while (i < n) {
+	s = s * 31 + a[i];
+	i = i + 1;
+    }
+
+    return s;
+}
+
+int main(void)
+{
+    int *a, *b, *c;
+    int i, n;
+
+    n = 10000;
+    a = malloc(n * sizeof a[0]);
+    b = malloc(n * sizeof b[0]);
+    c = malloc(n * sizeof c[0]);
+
+    i = 0;
+
+    while (i < n) {
+	b[i] = i * 7 - 3;
+	c[i] = 1000 - i;
+	i = i + 1;
+    }
+
+    i = 0;
+
+    while (i < 20000) {
+	add(a, b, c, n);
+	saxpy(b, a, 3, n);
+	saxpy(c + 1, b, -1, n - 1);
+	i = i + 1;
+    }
+
+    printf("%d\n", checksum(a, n));
+    printf("%d\n", checksum(b, n));
+    printf("%d\n", checksum(c, n));
+}
@@ -0,0 +1,338 @@
+add:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$add.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movq	%rsi, -16(%rbp)
+	movq	%rdx, -24(%rbp)
+	movl	%ecx, -28(%rbp)
+	mov	$0, %eax
+	movl	%eax, -32(%rbp)
+#WHILE
+.L1:
+	mov	-32(%rbp), %eax
+	cmpl	-28(%rbp), %eax
+	jge	.L2
+#ADD
+#MULTIPLY
+#CAST
+	mov	-32(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+#ADD
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-32(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-16(%rbp), %rsi
+	add	%rax, %rsi
+	movl	(%rsi), %esi
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-32(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-24(%rbp), %rdx
+	add	%rax, %rdx
+	movl	(%rdx), %edx
+	add	%edx, %esi
+	movl	%esi, (%rdi)
+#ADD
+	mov	-32(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -32(%rbp)
+	jmp	.L1
+.L2:
+.L0:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	add.size, 96
+	.globl	add
+
+saxpy:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$saxpy.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movq	%rsi, -16(%rbp)
+	movl	%edx, -20(%rbp)
+	movl	%ecx, -24(%rbp)
+	mov	$0, %eax
+	movl	%eax, -28(%rbp)
+#WHILE
+.L4:
+	mov	-28(%rbp), %eax
+	cmpl	-24(%rbp), %eax
+	jge	.L5
+#ADD
+#MULTIPLY
+#CAST
+	mov	-28(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-8(%rbp), %rdi
+	add	%rax, %rdi
+#ADD
+#MULTIPLY
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-28(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-16(%rbp), %rsi
+	add	%rax, %rsi
+	movl	(%rsi), %esi
+	mov	-20(%rbp), %eax
+	imul	%esi, %eax
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-28(%rbp), %esi
+	movslq	%esi, %rsi
+	imul	$4, %rsi
+	mov	-8(%rbp), %rdx
+	add	%rsi, %rdx
+	movl	(%rdx), %edx
+	add	%edx, %eax
+	movl	%eax, (%rdi)
+#ADD
+	mov	-28(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -28(%rbp)
+	jmp	.L4
+.L5:
+.L3:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	saxpy.size, 96
+	.globl	saxpy
+
+checksum:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$checksum.size, %eax
+	subq	%rax, %rsp
+	movq	%rdi, -8(%rbp)
+	movl	%esi, -12(%rbp)
+	mov	$0, %eax
+	movl	%eax, -16(%rbp)
+	mov	$0, %eax
+	movl	%eax, -20(%rbp)
+#WHILE
+.L7:
+	mov	-16(%rbp), %eax
+	cmpl	-12(%rbp), %eax
+	jge	.L8
+#ADD
+#MULTIPLY
+	mov	-20(%rbp), %eax
+	imul	$31, %eax
+#DEREFERENCE
+#ADD
+#MULTIPLY
+#CAST
+	mov	-16(%rbp), %edi
+	movslq	%edi, %rdi
+	imul	$4, %rdi
+	mov	-8(%rbp), %rsi
+	add	%rdi, %rsi
+	movl	(%rsi), %esi
+	add	%esi, %eax
+	movl	%eax, -20(%rbp)
+#ADD
+	mov	-16(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -16(%rbp)
+	jmp	.L7
+.L8:
+	mov	-20(%rbp), %eax
+	jmp	.L6
+.L6:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	checksum.size, 48
+	.globl	checksum
+
+main:
+	pushq	%rbp
+	movq	%rsp, %rbp
+	movl	$main.size, %eax
+	subq	%rax, %rsp
+	mov	$10000, %eax
+	movl	%eax, -32(%rbp)
+#MULTIPLY
+#CAST
+	mov	-32(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	%rax, -48(%rbp)	# spill
+	movq	-48(%rbp), %rdi
+	movl	$0, %eax
+	call	malloc
+	movq	%rax, -8(%rbp)
+#MULTIPLY
+#CAST
+	mov	-32(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	%rax, -64(%rbp)	# spill
+	movq	-64(%rbp), %rdi
+	movl	$0, %eax
+	call	malloc
+	movq	%rax, -16(%rbp)
+#MULTIPLY
+#CAST
+	mov	-32(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	%rax, -80(%rbp)	# spill
+	movq	-80(%rbp), %rdi
+	movl	$0, %eax
+	call	malloc
+	movq	%rax, -24(%rbp)
+	mov	$0, %eax
+	movl	%eax, -28(%rbp)
+#WHILE
+.L10:
+	mov	-28(%rbp), %eax
+	cmpl	-32(%rbp), %eax
+	jge	.L11
+#ADD
+#MULTIPLY
+#CAST
+	mov	-28(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-16(%rbp), %rdi
+	add	%rax, %rdi
+#SUBTRACT
+#MULTIPLY
+	mov	-28(%rbp), %eax
+	imul	$7, %eax
+	sub	$3, %eax
+	movl	%eax, (%rdi)
+#ADD
+#MULTIPLY
+#CAST
+	mov	-28(%rbp), %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-24(%rbp), %rdi
+	add	%rax, %rdi
+#SUBTRACT
+	mov	$1000, %eax
+	sub	-28(%rbp), %eax
+	movl	%eax, (%rdi)
+#ADD
+	mov	-28(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -28(%rbp)
+	jmp	.L10
+.L11:
+	mov	$0, %eax
+	movl	%eax, -28(%rbp)
+#WHILE
+.L12:
+	mov	-28(%rbp), %eax
+	cmpl	$20000, %eax
+	jge	.L13
+	movl	-32(%rbp), %ecx
+	movq	-24(%rbp), %rdx
+	movq	-16(%rbp), %rsi
+	movq	-8(%rbp), %rdi
+	call	add
+	movl	-32(%rbp), %ecx
+	movl	$3, %edx
+	movq	-8(%rbp), %rsi
+	movq	-16(%rbp), %rdi
+	call	saxpy
+#ADD
+#MULTIPLY
+#CAST
+	mov	$1, %eax
+	movslq	%eax, %rax
+	imul	$4, %rax
+	mov	-24(%rbp), %rdi
+	add	%rax, %rdi
+#NEGATE
+	mov	$1, %eax
+	negl	%eax
+#SUBTRACT
+	mov	-32(%rbp), %esi
+	sub	$1, %esi
+	mov	%eax, -152(%rbp)	# spill
+	mov	%rdi, -160(%rbp)	# spill
+	mov	%esi, -164(%rbp)	# spill
+	movl	-164(%rbp), %ecx
+	movl	-152(%rbp), %edx
+	movq	-16(%rbp), %rsi
+	movq	-160(%rbp), %rdi
+	call	saxpy
+#ADD
+	mov	-28(%rbp), %eax
+	add	$1, %eax
+	movl	%eax, -28(%rbp)
+	jmp	.L12
+.L13:
+#ADDRESS
+	leaq	.L14(%rip), %rax
+	mov	%rax, -176(%rbp)	# spill
+	movl	-32(%rbp), %esi
+	movq	-8(%rbp), %rdi
+	call	checksum
+	mov	%eax, -180(%rbp)	# spill
+	movl	-180(%rbp), %esi
+	movq	-176(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L15(%rip), %rax
+	mov	%rax, -188(%rbp)	# spill
+	movl	-32(%rbp), %esi
+	movq	-16(%rbp), %rdi
+	call	checksum
+	mov	%eax, -192(%rbp)	# spill
+	movl	-192(%rbp), %esi
+	movq	-188(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+#ADDRESS
+	leaq	.L16(%rip), %rax
+	mov	%rax, -200(%rbp)	# spill
+	movl	-32(%rbp), %esi
+	movq	-24(%rbp), %rdi
+	call	checksum
+	mov	%eax, -204(%rbp)	# spill
+	movl	-204(%rbp), %esi
+	movq	-200(%rbp), %rdi
+	movl	$0, %eax
+	call	printf
+.L9:
+	movq	%rbp, %rsp
+	popq	%rbp
+	ret
+
+	.set	main.size, 208
+	.globl	main
+
+.L14:	.asciz "%d\n"
+.L15:	.asciz "%d\n"
+.L16:	.asciz "%d\n"
@@ -6,27 +6,39 @@
  *
  *		Extra functionality:
  *		- putting all the global declarations at the end
+ *		- an immediate frame size, since the body of a function is
+ *		  generated before its prologue
+ *		- no stack adjustment for leaf functions whose frame fits
+ *		  in the red zone, and optionally no frame pointer
+ *		- reusing the stack slots of temporaries once their values
+ *		  have been consumed
+ *		- a pool of string literals in read-only data, with each
+ *		  literal stored once, and one that is the tail of another
+ *		  stored within it
  */
 
+# include <map>
+# include <algorithm>
+# include <climits>
+# include <cstdlib>
 # include <sstream>
 # include <iostream>
 # include "generator.h"
 # include "Register.h"
 # include "machine.h"
+# include "profile.h"
+# include "statistics.h"
 # include "Tree.h"
 
 using namespace std;
 
-/* This needs to be set to zero if temporaries are placed on the stack. */
-
-# define SIMPLE_PROLOGUE 0
-
-
 /* Okay, I admit it ... these are lame, but they work. */
 
 # define isNumber(expr)		(expr->_operand[0] == '$')
 # define isRegister(expr)	(expr->_register != nullptr)
 # define isMemory(expr)		(!isNumber(expr) && !isRegister(expr))
+# define isConstant(expr)	(isNumber(expr) && !isRegister(expr))
+# define literal(expr)		(strtol(expr->_operand.c_str() + 1, nullptr, 0))
 
 
 /* The registers that we are using in the assignment. */
@@ -38,14 +50,32 @@ static Register *rdx = new Register("%rdx", "%edx", "%dl");
 static Register *rcx = new Register("%rcx", "%ecx", "%cl");
 static Register *r8 = new Register("%r8", "%r8d", "%r8b");
 static Register *r9 = new Register("%r9", "%r9d", "%r9b");
+static Register *rbx = new Register("%rbx", "%ebx", "%bl");
+static Register *r12 = new Register("%r12", "%r12d", "%r12b");
+static Register *r13 = new Register("%r13", "%r13d", "%r13b");
+static Register *r14 = new Register("%r14", "%r14d", "%r14b");
+static Register *r15 = new Register("%r15", "%r15d", "%r15b");
 static Register *parameters[] = {rdi, rsi, rdx, rcx, r8, r9};
 vector<Register *> registers = { rax, rdi, rsi, rdx, rcx, r8, r9 };
 
+/* The callee-saved registers, which hold only values live across a call,
+   and those of them used by the current function. */
+
+static vector<Register *> callee = {rbx, r12, r13, r14, r15};
+static vector<Register *> used;
+
 /* global variables */
 int temp_offset;
-typedef std::vector<string> Strings;
-Strings sts;
+static map<Expression *, int> temps;
+static map<int, vector<int>> slots;
+static map<string, Label> strings;
 Label *retLbl;
+bool framePointer = true;
+bool debugInfo = false;
+static int outgoing;
+static bool leaf;
+static string function, deferred;
+static const Counts *counts;
 
 /*
  * Function:	suffix (private)
@@ -75,6 +105,38 @@ static int align(int offset)
 }
 
 
+/*
+ * Function:	frame (private)
+ *
+ * Description:	Return the operand for the given offset in the stack
+ *		frame, which is relative to the frame pointer if there is
+ *		one.  Otherwise, it is relative to the stack pointer, which
+ *		lies below the frame by the size of the frame.  As that
+ *		size is not known until the body is generated, it is a
+ *		symbol that is set before the prologue.  Since no frame
+ *		pointer is saved, the parameters on the stack lie eight
+ *		bytes closer than they otherwise would.
+ */
+
+static string frame(int offset)
+{
+    stringstream ss;
+
+
+    if (framePointer)
+	ss << offset << "(%rbp)";
+
+    else {
+	if (offset > 0)
+	    offset -= SIZEOF_PTR;
+
+	ss << function << ".size" << (offset < 0 ? "" : "+") << offset << "(%rsp)";
+    }
+
+    return ss.str();
+}
+
+
 /*
  * Function:	operator << (private)
  *
@@ -92,6 +154,53 @@ static ostream &operator <<(ostream &ostr, Expression *expr)
 }
 
 
+/*
+ * Function:	assigntemp
+ *
+ * Description:	Create temporaries for stack spills.  A slot freed by an
+ *		earlier temporary of the same size is reused if possible,
+ *		and otherwise a new slot is aligned on its size below the
+ *		others.  An expression spilled again keeps its slot.
+ *
+ */
+
+void assigntemp(Expression *expr) {
+  int size = expr->type().size();
+  vector<int> &bucket = slots[size];
+
+  if (temps.count(expr) == 0) {
+    if (!bucket.empty()) {
+      temps[expr] = bucket.back();
+      bucket.pop_back();
+    } else {
+      temp_offset -= size;
+      temp_offset -= (size + temp_offset % size) % size;
+      temps[expr] = temp_offset;
+    }
+  }
+
+  expr->_operand = frame(temps[expr]);
+}
+
+
+/*
+ * Function:	freetemp (private)
+ *
+ * Description:	Free the temporary of an expression whose value has been
+ *		consumed, so that its slot can be reused.
+ *
+ */
+
+static void freetemp(Expression *expr) {
+  map<Expression *, int>::iterator it = temps.find(expr);
+
+  if (it != temps.end()) {
+    slots[expr->type().size()].push_back(it->second);
+    temps.erase(it);
+  }
+}
+
+
 /*
  * Function:	assign
  *
@@ -101,6 +210,9 @@ static ostream &operator <<(ostream &ostr, Expression *expr)
 
 void assign(Expression *expr, Register *reg)
 {
+  if (expr != nullptr && reg == nullptr)
+    freetemp(expr);
+
   if (expr != nullptr) {
     if (expr->_register != nullptr)
       expr->_register->_node = nullptr;
@@ -115,21 +227,6 @@ void assign(Expression *expr, Register *reg)
 }
 
 
-/*
- * Function:	assigntemp
- *
- * Description:	Create temporaries for stack spills.
- *
- */
-
-void assigntemp(Expression *expr) {
-  stringstream ss;
-
-  temp_offset -= expr->type().size();
-  ss << temp_offset << "(%rbp)";
-  expr->_operand = ss.str();
-}
-
 /*
  * Function:	load
  *
@@ -145,6 +242,11 @@ void load(Expression *expr, Register *reg) {
       cout << "\tmov\t" << reg->name(size);
       cout << ", " << reg->_node->_operand;
       cout << "\t# spill" << endl;
+
+      if (memReport || timeTrace) {
+        tallies[SPILLS] ++;
+        frameSpills ++;
+      }
     }
 
     if (expr != nullptr) {
@@ -161,7 +263,9 @@ void load(Expression *expr, Register *reg) {
 /*
  * Function:	release
  *
- * Description:	Releases all registers by setting to nullptr.
+ * Description:	Releases all registers by setting to nullptr.  No value
+ *		lives beyond its statement, so any temporaries still held
+ *		are freed as well.
  *
  */
 
@@ -169,6 +273,12 @@ void release()
 {
   for (unsigned i = 0; i < registers.size(); i ++)
     assign(nullptr, registers[i]);
+
+  for (unsigned i = 0; i < callee.size(); i ++)
+    assign(nullptr, callee[i]);
+
+  while (!temps.empty())
+    freetemp(temps.begin()->first);
 }
 
 
@@ -189,69 +299,257 @@ Register *getreg() {
 }
 
 
+/*
+ * Function:	count (private)
+ *
+ * Description:	Increment the given profile counter of the function, if
+ *		generating a profile.  The flags are never live between
+ *		statements or before a call, so incq may clobber them.
+ */
+
+static void count(unsigned probe)
+{
+    if (!profileGenerate.empty())
+	cout << "\tincq\t" << counter(function, probe) << endl;
+}
+
+
+/*
+ * Function:	compare (private)
+ *
+ * Description:	Generate code to compare the two operands of a relational
+ *		or equality operator, leaving the result in the condition
+ *		codes.  The left operand is always placed in a register so
+ *		that the comparison is against a register, and the cmp can
+ *		be fused with the conditional jump or set that follows.
+ */
+
+static void compare(Expression *left, Expression *right)
+{
+    left->generate();
+    right->generate();
+
+    if (!isRegister(left))
+	load(left, getreg());
+
+    cout << "\tcmp" << suffix(left->type().size()) << right << ", ";
+    cout << left << endl;
+
+    assign(left, nullptr);
+    assign(right, nullptr);
+}
+
+
+/*
+ * Function:	branch (private)
+ *
+ * Description:	Emit a conditional jump to the given label using the given
+ *		condition code if the jump is to be taken when the result
+ *		is true, and its inverse otherwise.
+ */
+
+static void branch(const string &cc, const string &inverse, const Label &label,
+	bool ifTrue)
+{
+    cout << "\tj" << (ifTrue ? cc : inverse) << "\t" << label << endl;
+}
+
+
+/*
+ * Function:	set (private)
+ *
+ * Description:	Materialize the condition codes as the value 0 or 1 of the
+ *		given expression, which is left in a register.
+ */
+
+static void set(Expression *expr, const string &cc)
+{
+    Register *reg = getreg();
+
+    cout << "\tset" << cc << "\t" << reg->name(1) << endl;
+    cout << "\tmovzbl\t" << reg->name(1) << ", " << reg->name(4) << endl;
+    assign(expr, reg);
+}
+
+
 /*
  * Function:	Expression::test
  *
- * Description:	Intermediate step for expressions that require
- *              a comparison.
+ * Description:	Generate jumping code for an expression used as a test.
+ *		If the value of the expression is equal to IFTRUE, then
+ *		control is transferred to the given label; otherwise,
+ *		control falls through to the next instruction.  This is
+ *		the fall-through form of the true and false lists of Aho
+ *		et al., where one of the two lists is always empty.  The
+ *		default is to compare the value of the expression against
+ *		zero.  Operators that can do better override this.
  */
 
-void Expression::test(const Label &label, bool ifTrue) {
-  generate();
+void Expression::test(const Label &label, bool ifTrue)
+{
+    generate();
 
-  if(_register == nullptr)
-    load(this,getreg());
+    if (!isRegister(this))
+	load(this, getreg());
 
-  cout << "\t cmp\t$0, " << this << endl;
-  cout << (ifTrue ? "\tjne\t" : "\tje\t") << label << endl;
+    cout << "\ttest" << suffix(_type.size()) << this << ", " << this << endl;
+    branch("ne", "e", label, ifTrue);
 
-  assign(this, nullptr);
+    assign(this, nullptr);
 }
 
 
 /*
- * Function:	GreaterThan::test
+ * Function:	Number::test
  *
- * Description:	Intermediate step for expressions that require
- *              a comparison.
+ * Description:	Generate jumping code for an integer literal, whose value is
+ *		known at compile time, so no comparison is ever needed.
  */
 
-void GreaterThan::test(const Label &label, bool onTrue)
+void Number::test(const Label &label, bool ifTrue)
 {
-  _left->generate();
-  _right->generate();
+    if ((strtoul(_value.c_str(), nullptr, 0) != 0) == ifTrue)
+	cout << "\tjmp\t" << label << endl;
+}
 
-  if (_left->_register == nullptr)
-    load(_left, getreg());
 
-  cout << "\tcmp\t" << _right << ", " << _left << endl;
-  cout << (onTrue ? "\tjg\t" : "\tjle\t") << label << endl;
+/*
+ * Function:	Not::test
+ *
+ * Description:	Generate jumping code for a logical negation, which is
+ *		simply the jumping code for its operand with the sense of
+ *		the test reversed.
+ */
 
-  assign(_left, nullptr);
-  assign(_right, nullptr);
+void Not::test(const Label &label, bool ifTrue)
+{
+    _expr->test(label, !ifTrue);
 }
 
 
 /*
  * Function:	LessThan::test
  *
- * Description:	Intermediate step for expressions that require
- *              a comparison.
+ * Description:	Generate jumping code for binary <.
  */
 
-void LessThan::test(const Label &label, bool onTrue)
+void LessThan::test(const Label &label, bool ifTrue)
 {
-  _left->generate();
-  _right->generate();
+    compare(_left, _right);
+    branch("l", "ge", label, ifTrue);
+}
 
-  if (_left->_register == nullptr)
-    load(_left, getreg());
 
-  cout << "\tcmp\t" << _right << ", " << _left << endl;
-  cout << (onTrue ? "\tjl\t" : "\tjge\t") << label << endl;
+/*
+ * Function:	GreaterThan::test
+ *
+ * Description:	Generate jumping code for binary >.
+ */
 
-  assign(_left, nullptr);
-  assign(_right, nullptr);
+void GreaterThan::test(const Label &label, bool ifTrue)
+{
+    compare(_left, _right);
+    branch("g", "le", label, ifTrue);
+}
+
+
+/*
+ * Function:	LessOrEqual::test
+ *
+ * Description:	Generate jumping code for binary <=.
+ */
+
+void LessOrEqual::test(const Label &label, bool ifTrue)
+{
+    compare(_left, _right);
+    branch("le", "g", label, ifTrue);
+}
+
+
+/*
+ * Function:	GreaterOrEqual::test
+ *
+ * Description:	Generate jumping code for binary >=.
+ */
+
+void GreaterOrEqual::test(const Label &label, bool ifTrue)
+{
+    compare(_left, _right);
+    branch("ge", "l", label, ifTrue);
+}
+
+
+/*
+ * Function:	Equal::test
+ *
+ * Description:	Generate jumping code for binary ==.
+ */
+
+void Equal::test(const Label &label, bool ifTrue)
+{
+    compare(_left, _right);
+    branch("e", "ne", label, ifTrue);
+}
+
+
+/*
+ * Function:	NotEqual::test
+ *
+ * Description:	Generate jumping code for binary !=.
+ */
+
+void NotEqual::test(const Label &label, bool ifTrue)
+{
+    compare(_left, _right);
+    branch("ne", "e", label, ifTrue);
+}
+
+
+/*
+ * Function:	LogicalAnd::test
+ *
+ * Description:	Generate short-circuit jumping code for binary &&.  If we
+ *		are jumping on false, then either operand being false takes
+ *		the jump.  If we are jumping on true, then the left operand
+ *		being false skips the test of the right operand.
+ */
+
+void LogicalAnd::test(const Label &label, bool ifTrue)
+{
+    if (!ifTrue) {
+	_left->test(label, false);
+	_right->test(label, false);
+
+    } else {
+	Label skip;
+
+	_left->test(skip, false);
+	_right->test(label, true);
+	cout << skip << ":" << endl;
+    }
+}
+
+
+/*
+ * Function:	LogicalOr::test
+ *
+ * Description:	Generate short-circuit jumping code for binary ||, which is
+ *		the mirror image of the code for binary &&.
+ */
+
+void LogicalOr::test(const Label &label, bool ifTrue)
+{
+    if (ifTrue) {
+	_left->test(label, true);
+	_right->test(label, true);
+
+    } else {
+	Label skip;
+
+	_left->test(skip, true);
+	_right->test(label, false);
+	cout << skip << ":" << endl;
+    }
 }
 
 
@@ -280,245 +578,682 @@ void Number::generate()
  */
 
 void Identifier::generate()
+{
+    if (_symbol->_offset == 0)
+	   _operand = global_prefix + _symbol->name() + global_suffix;
+    else
+	   _operand = frame(_symbol->_offset);
+}
+
+
+/*
+ * Function:	decode (private)
+ *
+ * Description:	Return the characters of a string literal, with its quotes
+ *		removed and its escape sequences replaced, as the assembler
+ *		would store them.
+ */
+
+static string decode(const string &literal)
+{
+    string chars;
+    unsigned i = 1, value;
+
+
+    while (i + 1 < literal.size()) {
+	if (literal[i] != '\\') {
+	    chars += literal[i ++];
+	    continue;
+	}
+
+	switch (literal[++ i]) {
+	case 'n': chars += '\n'; i ++; break;
+	case 't': chars += '\t'; i ++; break;
+	case 'r': chars += '\r'; i ++; break;
+	case 'b': chars += '\b'; i ++; break;
+	case 'f': chars += '\f'; i ++; break;
+	case 'v': chars += '\v'; i ++; break;
+	case 'a': chars += '\a'; i ++; break;
+
+	case 'x':
+	    value = 0;
+
+	    while (isxdigit(literal[++ i]))
+		value = value * 16 + (isdigit(literal[i]) ? literal[i] - '0' :
+			tolower(literal[i]) - 'a' + 10);
+
+	    chars += (char) value;
+	    break;
+
+	default:
+	    if (literal[i] >= '0' && literal[i] <= '7') {
+		value = 0;
+
+		for (unsigned j = 0; j < 3 && literal[i] >= '0' && literal[i] <= '7'; j ++)
+		    value = value * 8 + literal[i ++] - '0';
+
+		chars += (char) value;
+	    } else
+		chars += literal[i ++];
+	}
+    }
+
+    return chars;
+}
+
+
+/*
+ * Function:	encode (private)
+ *
+ * Description:	Return the given characters as a quoted string for the
+ *		assembler, escaping any that are not printable.
+ */
+
+static string encode(const string &chars)
 {
     stringstream ss;
 
 
-    if (_symbol->_offset == 0)
-	   ss << global_prefix << _symbol->name() << global_suffix;
-    else
-	   ss << _symbol->_offset << "(%rbp)";
+    ss << '"';
 
-    _operand = ss.str();
+    for (unsigned i = 0; i < chars.size(); i ++) {
+	unsigned char c = chars[i];
+
+	if (c == '"' || c == '\\')
+	    ss << '\\' << c;
+	else if (c == '\n')
+	    ss << "\\n";
+	else if (c == '\t')
+	    ss << "\\t";
+	else if (isprint(c))
+	    ss << c;
+	else
+	    ss << '\\' << (char) ('0' + c / 64) << (char) ('0' + c / 8 % 8)
+		<< (char) ('0' + c % 8);
+    }
+
+    ss << '"';
+    return ss.str();
 }
 
 
 /*
  * Function:	String::generate
  *
- * Description:	Generate code for an identifier.  Since there is really no
- *		code to generate, we simply update our operand.
+ * Description:	Generate code for a string literal.  Since there is really
+ *		no code to generate, we simply update our operand to the
+ *		label of the literal in the pool, which is added to the
+ *		pool if not already there.
+ */
+
+void String::generate()
+{
+    stringstream ss;
+
+    ss << strings[decode(_value)] << global_suffix;
+    _operand = ss.str();
+}
+
+/*
+ * Function:	preserve (private)
+ *
+ * Description:	Preserve the value in a caller-saved register across a
+ *		call by moving it to a free callee-saved register, which
+ *		must then be saved by the function, or by spilling it if
+ *		there is none.
+ */
+
+static void preserve(Register *reg)
+{
+    for (unsigned i = 0; i < callee.size(); i ++)
+	if (callee[i]->_node == nullptr) {
+	    cout << "\tmovq\t" << reg->name() << ", " << callee[i]->name() << endl;
+
+	    if (find(used.begin(), used.end(), callee[i]) == used.end())
+		used.push_back(callee[i]);
+
+	    assign(reg->_node, callee[i]);
+	    return;
+	}
+
+    load(nullptr, reg);
+}
+
+
+/*
+ * Function:	Call::generate
+ *
+ * Description:	Generate code for a function call.  Arguments are first
+ *		evaluated in case any them are in fact other function
+ *		calls.  Since no value lives beyond the statement that
+ *		computes it, the values other than the arguments that are
+ *		still in caller-saved registers are exactly those live
+ *		across the call, and only they are preserved.
+ *
+ *		Any arguments beyond the sixth are pushed on the stack from
+ *		right to left.  Each argument on the stack always requires
+ *		eight bytes, so the stack will always be aligned on a
+ *		multiple of eight bytes.  To ensure 16-byte alignment, we
+ *		adjust the stack pointer if necessary.  Without the frame
+ *		pointer, the frame is addressed from the stack pointer,
+ *		which must not move, so the arguments are instead stored
+ *		at the bottom of the frame, which has room for those of
+ *		every call.  The first six are
+ *		then moved straight into their registers, filling those
+ *		that are free first, so that an argument is moved out of
+ *		the way only if the moves form a cycle.
+ */
+
+void Call::generate()
+{
+    unsigned size, bytesPushed = 0;
+    unsigned n = min(_args.size(), (size_t) NUM_ARGS_IN_REGS);
+    bool moved;
+
+
+    /* Generate code for all the arguments first. */
+
+    leaf = false;
+    count(_probe);
+
+    for (unsigned i = 0; i < _args.size(); i ++)
+	_args[i]->generate();
+
+    for (unsigned i = 0; i < registers.size(); i ++)
+	if (registers[i]->_node != nullptr && find(_args.begin(), _args.end(),
+		registers[i]->_node) == _args.end())
+	    preserve(registers[i]);
+
+
+    /* Adjust the stack if necessary, and push the arguments. */
+
+    if (_args.size() > NUM_ARGS_IN_REGS) {
+	bytesPushed = align((_args.size() - NUM_ARGS_IN_REGS) * SIZEOF_ARG);
+
+	if (bytesPushed > 0 && framePointer)
+	    cout << "\tsubq\t$" << bytesPushed << ", %rsp" << endl;
+    }
+
+    for (unsigned i = _args.size(); i > NUM_ARGS_IN_REGS; i --) {
+	Expression *arg = _args[i - 1];
+	stringstream slot;
+
+	size = arg->type().size();
+	bytesPushed += SIZEOF_ARG;
+
+	if (!framePointer) {
+	    slot << (i - 1 - NUM_ARGS_IN_REGS) * SIZEOF_ARG << "(%rsp)";
+
+	    if (isRegister(arg))
+		cout << "\tmovq\t" << arg->_register->name() << ", ";
+	    else if (isNumber(arg))
+		cout << "\tmovq\t" << arg << ", ";
+	    else {
+		load(nullptr, rax);
+		cout << "\tmov" << suffix(size) << arg << ", ";
+		cout << rax->name(size) << endl;
+		cout << "\tmovq\t%rax, ";
+	    }
+
+	    cout << slot.str() << endl;
+
+	} else if (isRegister(arg))
+	    cout << "\tpushq\t" << arg->_register->name() << endl;
+	else if (isNumber(arg) || size == SIZEOF_ARG)
+	    cout << "\tpushq\t" << arg << endl;
+	else {
+	    load(nullptr, rax);
+	    cout << "\tmov" << suffix(size) << arg << ", ";
+	    cout << rax->name(size) << endl;
+	    cout << "\tpushq\t%rax" << endl;
+	}
+
+	assign(arg, nullptr);
+    }
+
+    if (!framePointer) {
+	outgoing = max(outgoing, (int) bytesPushed);
+	bytesPushed = 0;
+    }
+
+
+    /* Move the arguments into their registers. */
+
+    do {
+	moved = false;
+
+	for (unsigned i = 0; i < n; i ++)
+	    if (_args[i]->_register != parameters[i] &&
+		    parameters[i]->_node == nullptr) {
+		load(_args[i], parameters[i]);
+		moved = true;
+	    }
+    } while (moved);
+
+    for (unsigned i = 0; i < n; i ++)
+	load(_args[i], parameters[i]);
+
+
+    /* Call the function.  Technically, we only need to assign the number
+       of floating point arguments to %eax if the function being called
+       takes a variable number of arguments.  But, it never hurts. */
+
+    if (_id->type().parameters() == nullptr) {
+	load(nullptr, rax);
+	cout << "\tmovl\t$0, %eax" << endl;
+    }
+
+    cout << "\tcall\t" << global_prefix << _id->name() << endl;
+
+
+    /* Reclaim the space of any arguments pushed on the stack. */
+
+    if (bytesPushed > 0)
+	cout << "\taddq\t$" << bytesPushed << ", %rsp" << endl;
+
+    /* The return value is left in %rax, which is free since the only
+       values in caller-saved registers were the arguments. */
+
+    for (unsigned i = 0; i < n; i ++)
+	assign(_args[i], nullptr);
+
+    assign(this, rax);
+}
+
+
+/*
+ * Function: Return::generate()
+ *
+ * Description: Generate code for return statement.
+ */
+
+void Return::generate() {
+  _expr->generate();
+  load(_expr, rax);
+  cout << "\tjmp\t" << *retLbl << endl;
+}
+
+
+/*
+ * Function:	Assignment::generate
+ *
+ * Description:	Generate code for an assignment statement.  If the
+ *		left-hand side is a dereference, then we store indirectly
+ *		through the pointer rather than computing the value being
+ *		overwritten.
  */
 
-void String::generate()
-{
-    stringstream ss;
+void Assignment::generate()
+{
+    Expression *pointer = _left->getDereference();
+    unsigned size = _left->type().size();
+
+
+    if (pointer != nullptr) {
+	pointer->generate();
+	_right->generate();
+
+	if (!isRegister(pointer))
+	    load(pointer, getreg());
+
+	if (!isRegister(_right))
+	    load(_right, getreg());
+
+	cout << "\tmov" << suffix(size) << _right->_register->name(size);
+	cout << ", (" << pointer << ")" << endl;
+	assign(pointer, nullptr);
+
+    } else {
+	_left->generate();
+	_right->generate();
+
+	if (!isRegister(_right))
+	    load(_right, getreg());
+
+	cout << "\tmov" << suffix(size) << _right->_register->name(size);
+	cout << ", " << _left << endl;
+    }
+
+    assign(_right, nullptr);
+}
+
+
+/*
+ * Function:	locate (private)
+ *
+ * Description:	With debugging information, mark the code that follows as
+ *		coming from the given line of the source file.
+ */
+
+static void locate(unsigned line)
+{
+    if (debugInfo && line > 0)
+	cout << "\t.loc\t1 " << line << endl;
+}
+
+
+/*
+ * Function:	statement (private)
+ *
+ * Description:	Generate code for a statement, marked with the line on
+ *		which it starts.  No value lives beyond the statement that
+ *		computes it, so the registers are released afterwards.
+ */
+
+static void statement(Statement *stmt)
+{
+    locate(stmt->_line);
+    stmt->generate();
+    release();
+}
+
+
+/*
+ * Function:	Block::generate
+ *
+ * Description:	Generate code for this block, which simply means we
+ *		generate code for each statement within the block.
+ */
+
+void Block::generate()
+{
+    for (unsigned i = 0; i < _stmts.size(); i ++)
+	statement(_stmts[i]);
+}
+
+
+/*
+ * Function:	Function::generate
+ *
+ * Description:	Generate code for this function, which entails allocating
+ *		space for local variables, then emitting our prologue, the
+ *		body of the function, and the epilogue.  The body is
+ *		generated first, so that the size of the stack frame,
+ *		including any temporaries, is known for the prologue.
+ *
+ *		A leaf function makes no calls, and so can use the red
+ *		zone below the stack pointer for its frame without moving
+ *		the stack pointer at all.  Without the frame pointer, the
+ *		stack pointer must be eight bytes from a multiple of
+ *		sixteen, since the return address is on the stack, and the
+ *		frame is addressed from the stack pointer using its size,
+ *		which is set once the body is generated.
+ */
+
+void Function::generate()
+{
+    int locals = 0, offset, size;
+    unsigned numSpilled = _id->type().parameters()->size();
+    const Symbols &symbols = _body->declarations()->symbols();
+    stringstream body, code, restores;
+    streambuf *saved;
+    bool cfi = debugInfo && framePointer;
+
+    retLbl = new Label();
+    function = _id->name();
+    counts = profile(this);
+    leaf = true;
+    used.clear();
+    deferred.clear();
+    outgoing = 0;
+
+    /* Assign offsets to all symbols within the scope of the function. */
+
+    allocate(locals);
+
+    if (numSpilled > NUM_ARGS_IN_REGS)
+		numSpilled = NUM_ARGS_IN_REGS;
+
+    for (unsigned i = 0; i < numSpilled; i ++) {
+		unsigned size = symbols[i]->type().size();
+		body << "\tmov" << suffix(size) << parameters[i]->name(size);
+		body << ", " << frame(symbols[i]->_offset) << endl;
+    }
+
+
+    /* Generate the body, and then compute the size of the frame. */
+
+    saved = cout.rdbuf(body.rdbuf());
+    temp_offset = locals;
+    temps.clear();
+    slots.clear();
+    count(0);
+    _body->generate();
+    offset = temp_offset;
+    cout.rdbuf(saved);
+
+    offset -= (SIZEOF_PTR + offset % SIZEOF_PTR) % SIZEOF_PTR;
+    offset -= used.size() * SIZEOF_PTR;
+
+    if (framePointer) {
+		size = -offset + align(offset);
+
+		if (leaf && size <= RED_ZONE)
+		    size = 0;
+    } else {
+		size = -offset + outgoing + SIZEOF_PTR;
+		size += align(size) - SIZEOF_PTR;
+
+		if (leaf && -offset <= RED_ZONE)
+		    size = 0;
+    }
+
+
+    /* Save and restore any callee-saved registers used by the body. */
+
+    frameSize = -offset;
+    offset += used.size() * SIZEOF_PTR;
+
+    for (unsigned i = 0; i < used.size(); i ++) {
+	offset -= SIZEOF_PTR;
+	code << "\tmovq\t" << used[i]->name() << ", ";
+	code << frame(offset) << endl;
 
-    Label *st = new Label();
-    ss << *st;
-    _operand = ss.str();
-    ss << ":\t.asciz " << _value << endl;
-    sts.push_back(ss.str());
-}
+	if (cfi) {
+	    code << "\t.cfi_offset\t" << used[i]->name() << ", ";
+	    code << offset - INIT_ARG_OFFSET << endl;
+	}
 
-/*
- * Function:	Call::generate
- *
- * Description:	Generate code for a function call.  Arguments are first
- *		evaluated in case any them are in fact other function
- *		calls.  The first six arguments are placed in registers and
- *		any remaining arguments are pushed on the stack from right
- *		to left.  Each argument on the stack always requires eight
- *		bytes, so the stack will always be aligned on a multiple of
- *		eight bytes.  To ensure 16-byte alignment, we adjust the
- *		stack pointer if necessary.
- *
- *		NOT FINISHED: Ignores any return value.
- */
+	restores << "\tmovq\t" << frame(offset) << ", ";
+	restores << used[i]->name() << endl;
+    }
 
-void Call::generate()
-{
-    unsigned size, bytesPushed = 0;
+    code << body.str() << *retLbl << ":" << endl << restores.str();
 
 
-    /* Generate code for all the arguments first. */
+    /* Generate the prologue, body, and epilogue.  With debugging
+       information, a frame with a frame pointer is also described so
+       that the stack can be unwound. */
 
-    for (unsigned i = 0; i < _args.size(); i ++)
-	     _args[i]->generate();
+    if (debugInfo && typed_symbols)
+		cout << "\t.type\t" << global_prefix << _id->name() << ", @function" << endl;
+
+    if (!framePointer)
+		cout << "\t.set\t" << _id->name() << ".size, " << size << endl;
 
-    for (unsigned i = 0; i < registers.size(); i++)
-      load(nullptr, registers[i]);
+    cout << global_prefix << _id->name() << ":" << endl;
 
+    if (cfi)
+		cout << "\t.cfi_startproc" << endl;
 
-    /* Adjust the stack if necessary. */
+    locate(_line);
 
-    if (_args.size() > NUM_ARGS_IN_REGS) {
-    	bytesPushed = align((_args.size() - NUM_ARGS_IN_REGS) * SIZEOF_ARG);
+    if (framePointer) {
+		cout << "\tpushq\t%rbp" << endl;
 
-    	if (bytesPushed > 0)
-    	    cout << "\tsubq\t$" << bytesPushed << ", %rsp" << endl;
-    }
+		if (cfi) {
+		    cout << "\t.cfi_def_cfa_offset\t" << INIT_ARG_OFFSET << endl;
+		    cout << "\t.cfi_offset\t%rbp, " << -INIT_ARG_OFFSET << endl;
+		}
 
+		cout << "\tmovq\t%rsp, %rbp" << endl;
 
-    /* Move the arguments into the correct registers or memory locations. */
-
-    for (int i = _args.size() - 1; i >= 0; i --) {
-	    size = _args[i]->type().size();
-
-    	if (i < NUM_ARGS_IN_REGS) {
-			if(_args[i]->type().isFunction()) {
-			    cout << "\tmov" << suffix(size) << "%eax" << ", ";
-			    cout << parameters[i]->name(size) << endl;
-			}
-    	    cout << "\tmov" << suffix(size) << _args[i] << ", ";
-    	    cout << parameters[i]->name(size) << endl;
-    	} else {
-    	    bytesPushed += SIZEOF_ARG;
-
-    	    if (isRegister(_args[i]))
-    		    cout << "\tpushq\t" << _args[i]->_register->name() << endl;
-    	    else if (isNumber(_args[i]) || size == SIZEOF_ARG)
-    		    cout << "\tpushq\t" << _args[i] << endl;
-    	    else {
-        		cout << "\tmov" << suffix(size) << _args[i] << ", ";
-        		cout << rax->name(size) << endl;
-        		cout << "\tpushq\t%rax" << endl;
-    	    }
-    	}
+		if (cfi)
+		    cout << "\t.cfi_def_cfa_register\t%rbp" << endl;
     }
 
+    if (size > 0)
+		cout << "\tsubq\t$" << size << ", %rsp" << endl;
 
-    /* Call the function.  Technically, we only need to assign the number
-       of floating point arguments to %eax if the function being called
-       takes a variable number of arguments.  But, it never hurts. */
+    cout << code.str();
 
-   if (_id->type().parameters() == nullptr)
-    cout << "\tmovl\t$0, %eax" << endl;
+    if (framePointer) {
+		if (cfi && !deferred.empty())
+		    cout << "\t.cfi_remember_state" << endl;
 
-    cout << "\tcall\t" << global_prefix << _id->name() << endl;
+		if (size > 0)
+		    cout << "\tmovq\t%rbp, %rsp" << endl;
 
+		cout << "\tpopq\t%rbp" << endl;
 
-    /* Reclaim the space of any arguments pushed on the stack. */
+		if (cfi)
+		    cout << "\t.cfi_def_cfa\t%rsp, " << SIZEOF_PTR << endl;
+    } else if (size > 0)
+		cout << "\taddq\t$" << size << ", %rsp" << endl;
 
-    if (bytesPushed > 0)
-	   cout << "\taddq\t$" << bytesPushed << ", %rsp" << endl;
+    cout << "\tret" << endl;
 
-    /* Save return from call. Assign a temporary to save return value. */
+    if (cfi && !deferred.empty())
+		cout << "\t.cfi_restore_state" << endl;
 
-    assigntemp(this);
-    cout << "\tmovl\t%eax, " << _operand << endl;
-}
+    cout << endl << deferred;
 
+    if (cfi)
+		cout << "\t.cfi_endproc" << endl;
 
-/*
- * Function: Return::generate()
- *
- * Description: Generate code for return statement.
- */
+    if (debugInfo && typed_symbols) {
+		cout << "\t.size\t" << global_prefix << _id->name() << ", .-";
+		cout << global_prefix << _id->name() << endl;
+    }
 
-void Return::generate() {
-  _expr->generate();
-  cout << "\tmov\t" << _expr << ", %eax" << endl;
-  cout << "\tjmp\t" << *retLbl << endl;
+    cout << "\t.globl\t" << global_prefix << _id->name() << endl << endl;
 }
 
 
 /*
- * Function:	Assignment::generate
- *
- * Description:	Generate code for an assignment statement.
+ * Function:	isTail (private)
  *
- *		NOT FINISHED: Only works if the right-hand side is an
- *		integer literal and the left-hand size is an integer
- *		scalar.
+ * Description:	Return whether the first string ends with the second.
  */
 
-void Assignment::generate()
+static bool isTail(const string &s, const string &tail)
 {
-    _left->generate();
-    _right->generate();
-
-
-	int lsize = _left->type().size();
-	int rsize = _right->type().size();
-	load(_right, getreg());
-	cout << "\tmov"<<suffix(lsize) << _right->_register->name(rsize) << ", " << _left << endl;
+    return s.size() >= tail.size() &&
+	s.compare(s.size() - tail.size(), tail.size(), tail) == 0;
 }
 
 
 /*
- * Function:	Block::generate
+ * Function:	backwards (private)
  *
- * Description:	Generate code for this block, which simply means we
- *		generate code for each statement within the block.
+ * Description:	Compare two strings from their last characters to their
+ *		first, so that a string sorts just before those of which it
+ *		is the tail.
  */
 
-void Block::generate()
+static bool backwards(const map<string, Label>::iterator &a,
+	const map<string, Label>::iterator &b)
 {
-    for (unsigned i = 0; i < _stmts.size(); i ++)
-      _stmts[i]->generate();
+    return lexicographical_compare(a->first.rbegin(), a->first.rend(),
+	    b->first.rbegin(), b->first.rend());
 }
 
 
 /*
- * Function:	Function::generate
+ * Function:	generateStrings (private)
  *
- * Description:	Generate code for this function, which entails allocating
- *		space for local variables, then emitting our prologue, the
- *		body of the function, and the epilogue.
+ * Description:	Generate the pool of string literals in read-only data.
+ *		When sorted from their last characters, any string that is
+ *		the tail of another is followed by the longest such string,
+ *		so it can be stored within that string, with its label
+ *		placed among the characters.
  */
 
-void Function::generate()
+static void generateStrings()
 {
-    int offset = 0;
-    unsigned numSpilled = _id->type().parameters()->size();
-    const Symbols &symbols = _body->declarations()->symbols();
-    retLbl = new Label();
+    vector<map<string, Label>::iterator> sorted;
+    vector<map<string, Label>::iterator> tails;
+    map<string, Label>::iterator it;
+    unsigned offset;
 
-    /* Assign offsets to all symbols within the scope of the function. */
 
-    allocate(offset);
+    if (strings.empty())
+	return;
 
+    for (it = strings.begin(); it != strings.end(); ++ it)
+	sorted.push_back(it);
 
-    /* Generate the prologue, body, and epilogue. */
+    sort(sorted.begin(), sorted.end(), backwards);
+    cout << readonly_section << endl;
 
-    cout << global_prefix << _id->name() << ":" << endl;
-    cout << "\tpushq\t%rbp" << endl;
-    cout << "\tmovq\t%rsp, %rbp" << endl;
+    while (!sorted.empty()) {
+	tails.assign(1, sorted.back());
+	sorted.pop_back();
 
-    if (SIMPLE_PROLOGUE) {
-		offset -= align(offset);
-		cout << "\tsubq\t$" << -offset << ", %rsp" << endl;
-    } else {
-		cout << "\tmovl\t$" << _id->name() << ".size, %eax" << endl;
-		cout << "\tsubq\t%rax, %rsp" << endl;
-    }
+	while (!sorted.empty() && isTail(tails[0]->first, sorted.back()->first)) {
+	    tails.push_back(sorted.back());
+	    sorted.pop_back();
+	}
 
-    if (numSpilled > NUM_ARGS_IN_REGS)
-		numSpilled = NUM_ARGS_IN_REGS;
+	const string &chars = tails[0]->first;
+	offset = 0;
 
-    for (unsigned i = 0; i < numSpilled; i ++) {
-		unsigned size = symbols[i]->type().size();
-		cout << "\tmov" << suffix(size) << parameters[i]->name(size);
-		cout << ", " << symbols[i]->_offset << "(%rbp)" << endl;
-    }
+	for (unsigned i = 1; i < tails.size(); i ++) {
+	    cout << tails[i - 1]->second << ":\t.ascii\t";
+	    cout << encode(chars.substr(offset, chars.size() - tails[i]->first.size() - offset)) << endl;
+	    offset = chars.size() - tails[i]->first.size();
+	}
 
-    temp_offset = offset;
-    _body->generate();
-    offset = temp_offset;
+	cout << tails.back()->second << ":\t.asciz\t" << encode(chars.substr(offset)) << endl;
+    }
+}
 
-    cout << *retLbl << ":" << endl;
 
-    cout << "\tmovq\t%rbp, %rsp" << endl;
-    cout << "\tpopq\t%rbp" << endl;
-    cout << "\tret" << endl << endl;
+/*
+ * Function:	stringLiterals
+ *
+ * Description:	Return the characters of each string literal in the pool,
+ *		indexed by the operand that refers to it, so that the
+ *		literals can be stored without generating them.
+ */
 
+map<string, string> stringLiterals()
+{
+    map<string, string> literals;
+    map<string, Label>::iterator it;
+    stringstream ss;
 
-    /* Finish aligning the stack. */
 
-    if (!SIMPLE_PROLOGUE) {
-		offset -= align(offset);
-		cout << "\t.set\t" << _id->name() << ".size, " << -offset << endl;
+    for (it = strings.begin(); it != strings.end(); ++ it) {
+	ss.str("");
+	ss << it->second << global_suffix;
+	literals[ss.str()] = it->first;
     }
 
-    cout << "\t.globl\t" << global_prefix << _id->name() << endl << endl;
+    return literals;
+}
+
+
+/*
+ * Function:	generateFile
+ *
+ * Description:	With debugging information, name the source file to which
+ *		the line numbers refer, the standard input being named as
+ *		other compilers name it.
+ */
+
+void generateFile(const string &name)
+{
+    if (debugInfo)
+	cout << "\t.file\t1 \"" << (name.empty() ? "<stdin>" : name) << "\"" << endl;
 }
 
 
 /*
  * Function:	generateGlobals
  *
- * Description:	Generate code for any global variable declarations.
+ * Description:	Generate code for any global variable declarations, and
+ *		then the string literals.
  */
 
 void generateGlobals(Scope *scope)
@@ -531,9 +1266,7 @@ void generateGlobals(Scope *scope)
 	    cout << symbols[i]->type().size() << endl;
 	}
 
-  for(unsigned j = 0; j < sts.size(); j++) {
-        cout << sts[j];
-   }
+    generateStrings();
 }
 
 
@@ -546,11 +1279,12 @@ void generateGlobals(Scope *scope)
 void Negate::generate() {
   cout << "#NEGATE" << endl;
   _expr->generate();
-  assigntemp(this);
 
-  cout << "\tmovl\t" << _expr << ", %eax" << endl;
-  cout << "\tnegl\t" << "%eax" << endl;
-  cout << "\tmovl\t %eax, " << _operand << endl;
+  if (!isRegister(_expr))
+    load(_expr, getreg());
+
+  cout << "\tneg" << suffix(_type.size()) << _expr << endl;
+  assign(this, _expr->_register);
 }
 
 
@@ -563,13 +1297,13 @@ void Negate::generate() {
 void Not::generate() {
   cout << "#NOT" << endl;
   _expr->generate();
-  assigntemp(this);
 
-  cout << "\tmovl\t" << _expr << ", %eax" << endl;
-  cout << "\tcmpl\t$0, %eax" << endl;
-  cout << "\tsete\t%al" << endl;
-  cout << "\tmovzbl\t%al, %eax" << endl;
-  cout << "\tmovl\t %eax, " << _operand << endl;
+  if (!isRegister(_expr))
+    load(_expr, getreg());
+
+  cout << "\ttest" << suffix(_expr->type().size()) << _expr << ", " << _expr << endl;
+  assign(_expr, nullptr);
+  set(this, "e");
 }
 
 
@@ -582,10 +1316,13 @@ void Not::generate() {
 void Dereference::generate() {
   cout<<"#DEREFERENCE"<<endl;
   _expr->generate();
-  //assigntemp(this);
-  load(_expr,getreg());
-  int size = _expr->type().size();
-  cout << "\tmov\t("<< _expr->_register->name(size) <<"), "<< _expr->_register->name(size) << endl;
+
+  if (!isRegister(_expr))
+    load(_expr, getreg());
+
+  unsigned size = _type.size();
+  cout << "\tmov" << suffix(size) << "(" << _expr << "), ";
+  cout << _expr->_register->name(size) << endl;
   assign(this, _expr->_register);
 }
 
@@ -598,19 +1335,30 @@ void Dereference::generate() {
 
 void Address::generate() {
   cout << "#ADDRESS" << endl;
-  _expr->generate();
-  _operand = _expr->_operand;
-  
-  assigntemp(this);
-  cout << "\tleaq\t" << _expr << ", "<<getreg() << endl;
-  cout << "\tmov"<<suffix(this->type().size())<<"\t"<<getreg()<<", " << this <<endl;
+  Expression *pointer = _expr->getDereference();
+
+  if (pointer != nullptr) {
+    pointer->generate();
+
+    if (!isRegister(pointer))
+      load(pointer, getreg());
+
+    assign(this, pointer->_register);
+
+  } else {
+    _expr->generate();
+    Register *reg = getreg();
+    cout << "\tleaq\t" << _expr << ", " << reg->name() << endl;
+    assign(this, reg);
+  }
 }
 
 
 /*
 * Function:	Cast::generate
 *
-* Description:	Generate code for any unary () expressions.
+* Description:	Generate code for any unary () expressions.  A literal
+*		that is nonnegative as an int is simply widened in place.
 */
 
 void Cast::generate()
@@ -619,6 +1367,10 @@ void Cast::generate()
 	unsigned destSize = this->type().size();
 	unsigned srcSize = this->_expr->type().size();
 	_expr->generate();
+	if (destSize >= srcSize && isConstant(_expr) && literal(_expr) <= INT_MAX){
+		_operand = _expr->_operand;
+		return;
+	}
 	load(_expr,getreg());
 	string presuffix;
 	if (destSize == srcSize){
@@ -652,7 +1404,6 @@ void Add::generate() {
   cout << "#ADD" << endl;
   _left->generate();
   _right->generate();
-  assigntemp(this);
   if (_left->_register == nullptr)
     load(_left, getreg());
 
@@ -673,7 +1424,6 @@ void Subtract::generate() {
   cout << "#SUBTRACT" << endl;
   _left->generate();
   _right->generate();
-  assigntemp(this);
   if (_left->_register == nullptr)
     load(_left, getreg());
 
@@ -684,6 +1434,183 @@ void Subtract::generate() {
 }
 
 
+/*
+ * Function:	power (private)
+ *
+ * Description:	Return the base two logarithm of a value if it is a power
+ *		of two greater than one, and zero otherwise.
+ */
+
+static unsigned power(long value)
+{
+    unsigned k = 0;
+
+    if (value < 2 || (value & (value - 1)) != 0)
+	return 0;
+
+    while ((1L << k) != value)
+	k ++;
+
+    return k;
+}
+
+
+/*
+ * Function:	magic (private)
+ *
+ * Description:	Compute the magic number and shift for a signed division
+ *		by the given constant of the given size, as in Figure 10-1
+ *		of Warren's Hacker's Delight: the quotient is the high half
+ *		of the product of the dividend and the multiplier, plus the
+ *		dividend if the multiplier is negative, shifted right.
+ */
+
+static void magic(long divisor, unsigned size, long &multiplier, unsigned &shift)
+{
+    unsigned bits = size * 8;
+    unsigned long mask = bits == 64 ? ~0UL : (1UL << bits) - 1;
+    unsigned long d = divisor, t = 1UL << (bits - 1);
+    unsigned long anc = t - 1 - t % d, delta;
+    unsigned long q1 = t / anc, r1 = t - q1 * anc;
+    unsigned long q2 = t / d, r2 = t - q2 * d;
+    unsigned p = bits - 1;
+
+
+    do {
+	p ++;
+	q1 = 2 * q1 & mask;
+	r1 = 2 * r1 & mask;
+
+	if (r1 >= anc) {
+	    q1 ++;
+	    r1 -= anc;
+	}
+
+	q2 = 2 * q2 & mask;
+	r2 = 2 * r2 & mask;
+
+	if (r2 >= d) {
+	    q2 ++;
+	    r2 -= d;
+	}
+
+	delta = d - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    multiplier = (q2 + 1) & mask;
+
+    if (bits < 64 && multiplier >= (long) t)
+	multiplier -= (long) (mask + 1);
+
+    shift = p - bits;
+}
+
+
+/*
+ * Function:	multiplyConstant
+ *
+ * Description:	Multiply the given register in place by a constant using
+ *		a shift or an address computation if possible, returning
+ *		whether any code was written.
+ */
+
+bool multiplyConstant(Register *reg, unsigned size, long value)
+{
+    const string &r = reg->name(8);
+
+
+    if (size != 4 && size != 8)
+	return false;
+
+    if (power(value) > 0) {
+	cout << "\tshl" << suffix(size) << "$" << power(value) << ", ";
+	cout << reg->name(size) << endl;
+	return true;
+    }
+
+    if (value == 3 || value == 5 || value == 9) {
+	cout << "\tlea" << suffix(size) << "(" << r << "," << r << ",";
+	cout << value - 1 << "), " << reg->name(size) << endl;
+	return true;
+    }
+
+    return false;
+}
+
+
+/*
+ * Function:	divideConstant
+ *
+ * Description:	Divide %rax by a constant without a division instruction,
+ *		returning whether any code was written.  The quotient is
+ *		left in %rax, and if requested, the remainder in %rdx, as
+ *		with idiv.  A power of two is handled by biasing a negative
+ *		dividend before an arithmetic shift, so that the quotient
+ *		is truncated toward zero, and any other divisor by a
+ *		multiplication by its magic number.  The given scratch
+ *		register is also used.
+ */
+
+bool divideConstant(Register *scratch, unsigned size, long divisor,
+	bool remainder)
+{
+    const string &a = rax->name(size), &d = rdx->name(size);
+    const string &s = scratch->name(size);
+    string op = suffix(size);
+    unsigned bits = size * 8, k = power(divisor);
+    unsigned shift;
+    long multiplier;
+
+
+    if ((size != 4 && size != 8) || divisor < 2 || divisor > INT_MAX)
+	return false;
+
+    if (k == 0)
+	magic(divisor, size, multiplier, shift);
+
+    if (remainder || (k == 0 && multiplier < 0))
+	cout << "\tmov" << op << a << ", " << s << endl;
+
+    if (k > 0) {
+	cout << "\tmov" << op << a << ", " << d << endl;
+	cout << "\tsar" << op << "$" << bits - 1 << ", " << d << endl;
+	cout << "\tshr" << op << "$" << bits - k << ", " << d << endl;
+	cout << "\tadd" << op << a << ", " << d << endl;
+	cout << "\tmov" << op << d << ", " << a << endl;
+	cout << "\tsar" << op << "$" << k << ", " << a << endl;
+
+	if (remainder)
+	    cout << "\tand" << op << "$" << -divisor << ", " << d << endl;
+
+    } else {
+	cout << "\tmov" << op << "$" << multiplier << ", " << d << endl;
+	cout << "\timul" << op << d << endl;
+
+	if (multiplier < 0)
+	    cout << "\tadd" << op << s << ", " << d << endl;
+
+	if (shift > 0)
+	    cout << "\tsar" << op << "$" << shift << ", " << d << endl;
+
+	cout << "\tmov" << op << d << ", " << a << endl;
+	cout << "\tshr" << op << "$" << bits - 1 << ", " << a << endl;
+	cout << "\tadd" << op << d << ", " << a << endl;
+
+	if (remainder) {
+	    cout << "\timul" << op << "$" << divisor << ", " << a << ", ";
+	    cout << d << endl;
+	}
+    }
+
+    if (remainder) {
+	cout << "\tsub" << op << d << ", " << s << endl;
+	cout << "\tmov" << op << s << ", " << d << endl;
+    }
+
+    return true;
+}
+
+
 /*
  * Function:	Multiply::generate
  *
@@ -694,17 +1621,56 @@ void Multiply::generate() {
   cout << "#MULTIPLY" << endl;
   _left->generate();
   _right->generate();
-  assigntemp(this);
   if (_left->_register == nullptr)
     load(_left, getreg());
 
-  cout << "\timul\t" << _right << ", " << _left << endl;
+  if (!isConstant(_right) ||
+      !multiplyConstant(_left->_register, _type.size(), literal(_right)))
+    cout << "\timul\t" << _right << ", " << _left << endl;
 
   assign(_right, nullptr);
   assign(this, _left->_register);
 }
 
 
+/*
+ * Function:	divide (private)
+ *
+ * Description:	Generate code to divide the left operand by the right
+ *		operand, leaving the quotient in %rax and the remainder in
+ *		%rdx.  A literal divisor avoids the division if possible,
+ *		computing the remainder only if requested.  Otherwise, the
+ *		divisor cannot be an immediate, so a literal is first
+ *		loaded into %rcx.
+ */
+
+static void divide(Expression *left, Expression *right, bool remainder)
+{
+  left->generate();
+  right->generate();
+  load(left, rax);
+  load(nullptr, rdx);
+
+  if (isConstant(right)) {
+    load(nullptr, rcx);
+
+    if (divideConstant(rcx, left->type().size(), literal(right), remainder)) {
+      assign(left, nullptr);
+      assign(right, nullptr);
+      return;
+    }
+
+    load(right, rcx);
+  }
+
+  cout << (left->type().size() == 8 ? "\tcqto" : "\tcltd") << endl;
+  cout << "\tidiv" << suffix(right->type().size()) << right << endl;
+
+  assign(left, nullptr);
+  assign(right, nullptr);
+}
+
+
 /*
  * Function:	Divide::generate
  *
@@ -713,15 +1679,8 @@ void Multiply::generate() {
 
 void Divide::generate() {
   cout << "#DIVIDE" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-  load(_left, rax);
-  load(_right, rsi);
-  cout << "\tcltd" << endl;
-  cout << "\tidivl\t" << _right << endl;
-  assign(_right, nullptr);
-  assign(this, _left->_register);
+  divide(_left, _right, false);
+  assign(this, rax);
 }
 
 
@@ -733,15 +1692,7 @@ void Divide::generate() {
 
 void Remainder::generate() {
   cout << "#REMAINDER" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-  load(_left, rax);
-  load(_right, rsi);
-  cout << "\tcltd" << endl;
-  cout << "\tidivl\t" << _right << endl;
-
-  assign(_right, nullptr);
+  divide(_left, _right, true);
   assign(this, rdx);
 }
 
@@ -754,15 +1705,8 @@ void Remainder::generate() {
 
 void LessThan::generate() {
   cout << "#LESS THAN" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-
-  cout << "\tmovl\t" << _left << ", %eax" << endl;
-  cout << "\tcmpl\t" << _right << ", %eax" << endl;
-  cout << "\tsetl\t%al" << endl;
-  cout << "\tmovzbl\t%al, %eax" << endl;
-  cout << "\tmovl\t%eax, " << _operand << endl;
+  compare(_left, _right);
+  set(this, "l");
 }
 
 
@@ -774,15 +1718,8 @@ void LessThan::generate() {
 
 void GreaterThan::generate() {
   cout << "#GREATER THAN" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-
-  cout << "\tmovl\t" << _left << ", %eax" << endl;
-  cout << "\tcmpl\t" << _right << ", %eax" << endl;
-  cout << "\tsetg\t%al" << endl;
-  cout << "\tmovzbl\t%al, %eax" << endl;
-  cout << "\tmovl\t%eax, " << _operand << endl;
+  compare(_left, _right);
+  set(this, "g");
 }
 
 
@@ -794,15 +1731,8 @@ void GreaterThan::generate() {
 
 void LessOrEqual::generate() {
   cout << "#LESS OR EQUAL" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-
-  cout << "\tmovl\t" << _left << ", %eax" << endl;
-  cout << "\tcmpl\t" << _right << ", %eax" << endl;
-  cout << "\tsetle\t%al" << endl;
-  cout << "\tmovzbl\t%al, %eax" << endl;
-  cout << "\tmovl\t%eax, " << _operand << endl;
+  compare(_left, _right);
+  set(this, "le");
 }
 
 
@@ -814,15 +1744,8 @@ void LessOrEqual::generate() {
 
 void GreaterOrEqual::generate() {
   cout << "#GREATER OR EQUAL" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-
-  cout << "\tmovl\t" << _left << ", %eax" << endl;
-  cout << "\tcmpl\t" << _right << ", %eax" << endl;
-  cout << "\tsetge\t%al" << endl;
-  cout << "\tmovzbl\t%al, %eax" << endl;
-  cout << "\tmovl\t%eax, " << _operand << endl;
+  compare(_left, _right);
+  set(this, "ge");
 }
 
 
@@ -834,15 +1757,8 @@ void GreaterOrEqual::generate() {
 
 void Equal::generate() {
   cout << "#EQUAL" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-
-  cout << "\tmovl\t" << _left << ", %eax" << endl;
-  cout << "\tcmpl\t" << _right << ", %eax" << endl;
-  cout << "\tsete\t%al" << endl;
-  cout << "\tmovzbl\t%al, %eax" << endl;
-  cout << "\tmovl\t%eax, " << _operand << endl;
+  compare(_left, _right);
+  set(this, "e");
 }
 
 
@@ -854,15 +1770,35 @@ void Equal::generate() {
 
 void NotEqual::generate() {
   cout << "#NOT EQUAL" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
+  compare(_left, _right);
+  set(this, "ne");
+}
+
+
+/*
+ * Function:	logical (private)
+ *
+ * Description:	Materialize the value of a logical expression by using its
+ *		jumping code.  Since the code contains branches, any values
+ *		in registers are spilled first so the register contents
+ *		agree on both paths when they join.
+ */
+
+static void logical(Expression *expr)
+{
+  Label zero, exit;
 
-  cout << "\tmovl\t" << _left << ", %eax" << endl;
-  cout << "\tcmpl\t" << _right << ", %eax" << endl;
-  cout << "\tsetne\t%al" << endl;
-  cout << "\tmovzbl\t%al, %eax" << endl;
-  cout << "\tmovl\t%eax, " << _operand << endl;
+  for (unsigned i = 0; i < registers.size(); i ++)
+    load(nullptr, registers[i]);
+
+  expr->test(zero, false);
+  Register *reg = getreg();
+  cout << "\tmovl\t$1, " << reg->name(4) << endl;
+  cout << "\tjmp\t" << exit << endl;
+  cout << zero << ":" << endl;
+  cout << "\tmovl\t$0, " << reg->name(4) << endl;
+  cout << exit << ":" << endl;
+  assign(expr, reg);
 }
 
 
@@ -874,29 +1810,8 @@ void NotEqual::generate() {
 
 void LogicalAnd::generate()
 {
-  cout<<"#Logical And"<<endl;
   cout << "#LOGICALAND" << endl;
-  _left->generate();
-  _right->generate();
-  assigntemp(this);
-  Label *lbl = new Label();
-  if(lbl)
-  {
-
-    //left
-    cout << "\tmovl\t" << _left << ", %eax" << endl;
-    cout << "\tcmpl\t$0, %eax" << endl;
-    cout << "\tje\t" << *lbl  << endl;
-    //right
-    cout << "\tmovl\t" << _right << ", %eax" << endl;
-    cout << "\tcmpl\t$0, %eax" << endl;
-
-    //LABEL
-    cout << *lbl << ":" << endl;
-    cout << "\tsetne\t%al" << endl;
-    cout << "\tmovzbl\t%al, %eax" << endl;
-    cout << "\tmovl\t%eax, " << _operand << endl;
-  }
+  logical(this);
 }
 
 
@@ -909,47 +1824,96 @@ void LogicalAnd::generate()
 void LogicalOr::generate()
 {
   cout << "#LOGICALOR" << endl;
-  assigntemp(this);
-  Label *lbl = new Label();
-  if(lbl)
-  {
-
-    //left
-    _left->generate();
-    cout << "\tmovl\t" << _left << ", %eax" << endl;
-    cout << "\tcmpl\t$0, %eax" << endl;
-    cout << "\tjne\t" << *lbl  << endl;
-    _right->generate();
-    //right
-    cout << "\tmovl\t" << _right << ", %eax" << endl;
-    cout << "\tcmpl\t$0, %eax" << endl;
-
-    //LABEL
-    cout << *lbl << ":" << endl;
-    cout << "\tsetne\t%al" << endl;
-    cout << "\tmovzbl\t%al, %eax" << endl;
-    cout << "\tmovl\t%eax, " << _operand << endl;
-  }
+  logical(this);
+}
+
+
+/*
+ * Function:	defer (private)
+ *
+ * Description:	Generate code for a statement that the profile shows is
+ *		rarely executed.  The code is placed after the end of the
+ *		function, starting at the given label and jumping back to
+ *		the exit label, so that it is out of the way of the code
+ *		that is usually executed.  Any counter given is
+ *		incremented first.
+ */
+
+static void defer(Statement *stmt, const Label &label, const Label &exit,
+	int probe = -1)
+{
+    stringstream code;
+    streambuf *saved;
+
+
+    saved = cout.rdbuf(code.rdbuf());
+    cout << label << ":" << endl;
+
+    if (probe >= 0)
+	count(probe);
+
+    statement(stmt);
+    cout << "\tjmp\t" << exit << endl;
+    cout.rdbuf(saved);
+    deferred += code.str();
+}
+
+
+/*
+ * Function:	small (private)
+ *
+ * Description:	Return whether the given assembly code has few enough
+ *		instructions that it is worth aligning as a loop.
+ */
+
+static bool small(const string &code)
+{
+    stringstream in(code);
+    unsigned count = 0;
+    string line;
+
+
+    while (getline(in, line))
+	if (line.size() > 1 && line[0] == '\t' && line[1] != '.')
+	    count ++;
+
+    return count <= SMALL_LOOP;
 }
 
 
 /*
  * Function:	While::generate
  *
- * Description:	Generate code for any while loops.
+ * Description:	Generate code for any while loops.  The loop is rotated
+ *		so that the test is at the bottom: a guard skips the loop
+ *		entirely if the test is initially false, and otherwise each
+ *		iteration takes only the branch back to the top.  The top
+ *		of a small loop is aligned so that it starts a fetch block,
+ *		unless the profile shows that the body is never executed.
  */
 
 void While::generate() {
   cout << "#WHILE" << endl;
   Label loop, exit;
+  stringstream body;
+  streambuf *saved;
 
-  cout << loop << ":" << endl;
-
-  _expr->test(exit,false);
-  _stmt->generate();
   release();
+  count(_probe);
+  _expr->test(exit, false);
+
+  saved = cout.rdbuf(body.rdbuf());
+  count(_probe + 1);
+  statement(_stmt);
+  locate(_line);
+  _expr->test(loop, true);
+  cout.rdbuf(saved);
 
-  cout << "\tjmp\t" << loop << endl;
+  if (small(body.str()) && (counts == nullptr || (*counts)[_probe + 1] > 0))
+    cout << "\t.p2align\t" << LOOP_ALIGNMENT << endl;
+
+  cout << loop << ":" << endl;
+  cout << body.str();
   cout << exit << ":" << endl;
 }
 
@@ -957,21 +1921,56 @@ void While::generate() {
 /*
  * Function:	If::generate
  *
- * Description:	Generate code for any if statements.
+ * Description:	Generate code for any if statements.  The test jumps
+ *		around the then statement when false, so the then statement
+ *		is laid out as the fall-through path.  However, if the
+ *		profile shows that one of the statements is rarely
+ *		executed, it is moved out of the way and the other becomes
+ *		the fall-through path.
  */
 
 void If::generate() {
   cout << "#IF" << endl;
   Label skip, exit;
-  _expr->generate();
-  _expr->test(skip,false);
-  _thenStmt->generate();
-  if(_elseStmt){
-	cout <<"\tjmp\t"<<exit<< endl;
+  unsigned long reached = 0, taken = 0;
+
+  count(_probe);
+
+  if (counts != nullptr) {
+    reached = (*counts)[_probe];
+    taken = (*counts)[_probe + 1];
+  }
+
+  if (isRare(taken, reached)) {
+    _expr->test(skip, true);
+    defer(_thenStmt, skip, exit, _probe + 1);
+
+    if (_elseStmt != nullptr) {
+      statement(_elseStmt);
+    }
+
+    cout << exit << ":" << endl;
+    return;
   }
-  cout << skip << ":" << endl;
-  if(_elseStmt){
-	_elseStmt->generate();
-	cout<<exit<<":"<<endl;
+
+  if (_elseStmt != nullptr && isRare(reached - taken, reached)) {
+    _expr->test(skip, false);
+    count(_probe + 1);
+    statement(_thenStmt);
+    defer(_elseStmt, skip, exit);
+    cout << exit << ":" << endl;
+    return;
   }
+
+  _expr->test(skip, false);
+  count(_probe + 1);
+  statement(_thenStmt);
+
+  if (_elseStmt != nullptr) {
+    cout << "\tjmp\t" << exit << endl;
+    cout << skip << ":" << endl;
+    statement(_elseStmt);
+    cout << exit << ":" << endl;
+  } else
+    cout << skip << ":" << endl;
 }
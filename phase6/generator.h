@@ -8,8 +8,18 @@
 
 # ifndef GENERATOR_H
 # define GENERATOR_H
+# include <map>
+# include <string>
 # include "Scope.h"
+# include "Register.h"
 
+extern bool framePointer, debugInfo;
+
+void generateFile(const std::string &name);
 void generateGlobals(Scope *scope);
+std::map<std::string, std::string> stringLiterals();
+bool multiplyConstant(Register *reg, unsigned size, long value);
+bool divideConstant(Register *scratch, unsigned size, long divisor,
+	bool remainder);
 
 # endif /* GENERATOR_H */
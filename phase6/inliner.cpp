@@ -0,0 +1,397 @@
+/*
+ * File:	inliner.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for the inliner, which replaces a call to a
+ *		small leaf function defined in the same translation unit
+ *		with a copy of the body of that function.  Besides saving
+ *		the call itself, the body can then be optimized along with
+ *		its caller, so that the arguments need not be moved to the
+ *		parameter registers, nor any caller-saved registers be
+ *		saved around the call.
+ *
+ *		The flow graphs are inlined before they are put in SSA
+ *		form, so the variables of the callee simply become new
+ *		variables of the caller, and its stack frame is placed
+ *		below that of the caller.  Each parameter becomes the value
+ *		of its argument, and each return becomes an assignment to
+ *		a new variable, which replaces the value of the call,
+ *		followed by a jump to the code after the call.
+ *
+ *		The functions are visited in a depth-first walk of the
+ *		call graph, so that a function is inlined into its callers
+ *		only after its own calls have been.  A function that is
+ *		still being visited, that is, one that is part of a cycle
+ *		of recursive calls, is never inlined, and a function that
+ *		still makes calls after its own calls have been inlined is
+ *		not a leaf, and is never inlined either.
+ *
+ *		With a profile, a call that was never made is left alone,
+ *		and a call made more often than its caller is entered,
+ *		that is, one within a loop, may inline a larger function.
+ */
+
+# include <set>
+# include <algorithm>
+# include "machine.h"
+# include "IR.h"
+
+using namespace std;
+
+unsigned inlineLimit = 40;
+
+static map<string, Graph *> functions;
+static set<Graph *> active, done;
+
+
+/*
+ * Function:	cost (private)
+ *
+ * Description:	Return the estimated size of the code for a flow graph,
+ *		or -1 if it cannot be inlined: if it makes any calls, or
+ *		takes the address of a parameter passed on the stack.  The
+ *		instructions that merely name a value usually end up as
+ *		operands or registers and so are not counted.
+ */
+
+static int cost(const Graph *graph)
+{
+    int size = 0;
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	const Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    const Instruction *in = instructions[j];
+
+	    if (in->_opcode == OP_CALL)
+		return -1;
+
+	    if (in->_opcode == OP_FRAME && in->_value > 0)
+		return -1;
+
+	    switch (in->_opcode) {
+	    case OP_CONST: case OP_PARAM: case OP_FRAME: case OP_GLOBAL:
+	    case OP_GET: case OP_SET:
+		break;
+
+	    default:
+		size ++;
+	    }
+	}
+    }
+
+    return size;
+}
+
+
+/*
+ * Function:	lowest (private)
+ *
+ * Description:	Return the offset of the lowest stack slot used in memory
+ *		by a flow graph.  The variables kept in registers need no
+ *		slots, unlike those whose address is taken and the arrays.
+ */
+
+static int lowest(const Graph *graph)
+{
+    int offset = 0;
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	const Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++)
+	    if (instructions[j]->_opcode == OP_FRAME)
+		offset = min(offset, (int) instructions[j]->_value);
+    }
+
+    return offset;
+}
+
+
+/*
+ * Function:	inlinable (private)
+ *
+ * Description:	Return whether a call in the given caller can be replaced
+ *		by the body of the given function, which must be small
+ *		enough, be called with the right number of arguments, and
+ *		return a value of the size expected by the call.
+ */
+
+static bool inlinable(const Graph *caller, const Instruction *call,
+	const Graph *callee)
+{
+    Parameters *params = callee->_id->type().parameters();
+    map<const Instruction *, unsigned long>::const_iterator it;
+    unsigned limit = inlineLimit;
+    int size = cost(callee);
+
+
+    it = caller->_calls.find(call);
+
+    if (it != caller->_calls.end() && caller->_count >= 0) {
+	if (it->second == 0)
+	    return false;
+
+	if (it->second > (unsigned long) caller->_count)
+	    limit *= 4;
+    }
+
+    if (size < 0 || (unsigned) size > limit)
+	return false;
+
+    if (params->size() != call->_operands.size())
+	return false;
+
+    for (unsigned i = 0; i < callee->_blocks.size(); i ++) {
+	const Instruction *in = callee->_blocks[i]->terminator();
+
+	if (in != nullptr && in->_opcode == OP_RETURN && !in->_operands.empty())
+	    if (in->_operands[0]->_size != call->_size)
+		return false;
+    }
+
+    return true;
+}
+
+
+/*
+ * Function:	split (private)
+ *
+ * Description:	Move the instructions that follow the given position in a
+ *		block into a new block, which also takes over the
+ *		successors of the block.
+ */
+
+static BasicBlock *split(Graph *graph, BasicBlock *block, unsigned position)
+{
+    BasicBlock *after = new BasicBlock();
+    Instructions &instructions = block->_instructions;
+
+
+    after->_count = block->_count;
+
+    for (unsigned i = position; i < instructions.size(); i ++)
+	after->append(instructions[i]);
+
+    instructions.erase(instructions.begin() + position, instructions.end());
+
+    for (unsigned i = 0; i < block->_successors.size(); i ++) {
+	BasicBlocks &preds = block->_successors[i]->_predecessors;
+
+	for (unsigned j = 0; j < preds.size(); j ++)
+	    if (preds[j] == block)
+		preds[j] = after;
+    }
+
+    after->_successors = block->_successors;
+    block->_successors.clear();
+    graph->_blocks.push_back(after);
+    return after;
+}
+
+
+/*
+ * Function:	expand (private)
+ *
+ * Description:	Replace the call at the given position in a block with a
+ *		copy of the flow graph of the function called.  The call
+ *		itself becomes a read of the variable to which the value is
+ *		returned.
+ */
+
+static void expand(Graph *graph, BasicBlock *block, unsigned position,
+	const Graph *callee)
+{
+    Instruction *call = block->_instructions[position];
+    map<Instruction *, Instruction *> values;
+    map<BasicBlock *, BasicBlock *> blocks;
+    unsigned base, result;
+    BasicBlock *after;
+    Instructions args;
+    int frame;
+
+
+    /* The call becomes a read of the result in the block after it. */
+
+    after = split(graph, block, position + 1);
+    block->_instructions.pop_back();
+    args = call->_operands;
+
+    result = graph->_variables.size();
+    graph->_variables.push_back(call->_size);
+    call->_opcode = OP_GET;
+    call->_operands.clear();
+    call->_value = result;
+    call->_name.clear();
+    after->insert(call, 0);
+
+
+    /* Make room for the variables and stack frame of the callee. */
+
+    base = graph->_variables.size();
+    graph->_variables.insert(graph->_variables.end(),
+	    callee->_variables.begin(), callee->_variables.end());
+
+    frame = graph->_offset - (SIZEOF_PTR + graph->_offset % SIZEOF_PTR) % SIZEOF_PTR;
+    graph->_offset = min(graph->_offset, frame + lowest(callee));
+
+
+    /* Copy the blocks and instructions, with each parameter replaced by
+       its argument converted to the size of the parameter. */
+
+    for (unsigned i = 0; i < callee->_blocks.size(); i ++) {
+	blocks[callee->_blocks[i]] = new BasicBlock();
+	blocks[callee->_blocks[i]]->_count = callee->_blocks[i]->_count;
+	graph->_blocks.push_back(blocks[callee->_blocks[i]]);
+    }
+
+    for (unsigned i = 0; i < callee->_blocks.size(); i ++) {
+	BasicBlock *from = callee->_blocks[i], *to = blocks[from];
+
+	for (unsigned j = 0; j < from->_instructions.size(); j ++) {
+	    Instruction *in = from->_instructions[j], *copy;
+
+	    if (in->_opcode == OP_PARAM) {
+		copy = args[in->_value];
+
+		if (copy->_size < in->_size)
+		    copy = new Instruction(OP_EXT, in->_size, {copy});
+		else if (copy->_size > in->_size)
+		    copy = new Instruction(OP_TRUNC, in->_size, {copy});
+
+		if (copy != args[in->_value]) {
+		    copy->_line = call->_line;
+		    block->append(copy);
+		}
+
+		values[in] = copy;
+		continue;
+	    }
+
+	    if (in->_opcode == OP_RETURN) {
+		if (!in->_operands.empty())
+		    to->append(new Instruction(OP_SET, 0, in->_operands, result));
+
+		to->append(new Instruction(OP_JUMP, 0));
+		to->_successors.push_back(after);
+		after->_predecessors.push_back(to);
+		continue;
+	    }
+
+	    copy = new Instruction(in->_opcode, in->_size, in->_operands, in->_value);
+	    copy->_name = in->_name;
+	    copy->_line = in->_line;
+
+	    if (in->_opcode == OP_GET || in->_opcode == OP_SET)
+		copy->_value += base;
+	    else if (in->_opcode == OP_FRAME)
+		copy->_value += frame;
+
+	    values[in] = copy;
+	    to->append(copy);
+	}
+
+	for (unsigned j = 0; j < from->_successors.size(); j ++)
+	    to->_successors.push_back(blocks[from->_successors[j]]);
+
+	for (unsigned j = 0; j < from->_predecessors.size(); j ++)
+	    to->_predecessors.push_back(blocks[from->_predecessors[j]]);
+    }
+
+    for (unsigned i = 0; i < callee->_blocks.size(); i ++) {
+	Instructions &instructions = blocks[callee->_blocks[i]]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instructions &operands = instructions[j]->_operands;
+
+	    for (unsigned k = 0; k < operands.size(); k ++)
+		if (values.count(operands[k]) > 0)
+		    operands[k] = values[operands[k]];
+	}
+    }
+
+
+    /* Finally, jump from the call to the copy of the entry block. */
+
+    block->append(new Instruction(OP_JUMP, 0));
+    block->_successors.push_back(blocks[callee->_entry]);
+    blocks[callee->_entry]->_predecessors.push_back(block);
+}
+
+
+/*
+ * Function:	visit (private)
+ *
+ * Description:	Inline the calls made by a function, after first visiting
+ *		each function it calls that has not yet been visited.
+ */
+
+static void visit(Graph *graph)
+{
+    map<string, Graph *>::iterator it;
+
+
+    active.insert(graph);
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++)
+	    if (instructions[j]->_opcode == OP_CALL) {
+		it = functions.find(instructions[j]->_name);
+
+		if (it != functions.end() && active.count(it->second) == 0 &&
+			done.count(it->second) == 0)
+		    visit(it->second);
+	    }
+    }
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+
+	for (unsigned j = 0; j < block->_instructions.size(); j ++) {
+	    Instruction *in = block->_instructions[j];
+
+	    if (in->_opcode == OP_CALL) {
+		it = functions.find(in->_name);
+
+		if (it != functions.end() && done.count(it->second) > 0 &&
+			inlinable(graph, in, it->second)) {
+		    expand(graph, block, j, it->second);
+		    break;
+		}
+	    }
+	}
+    }
+
+    active.erase(graph);
+    done.insert(graph);
+}
+
+
+/*
+ * Function:	inlineCalls
+ *
+ * Description:	Inline the calls to small leaf functions among the given
+ *		flow graphs, which must not yet be in SSA form.
+ */
+
+void inlineCalls(const vector<Graph *> &graphs)
+{
+    functions.clear();
+    active.clear();
+    done.clear();
+
+    if (inlineLimit == 0)
+	return;
+
+    for (unsigned i = 0; i < graphs.size(); i ++)
+	functions[global_prefix + graphs[i]->_id->name()] = graphs[i];
+
+    for (unsigned i = 0; i < graphs.size(); i ++)
+	if (done.count(graphs[i]) == 0)
+	    visit(graphs[i]);
+}
@@ -0,0 +1,959 @@
+/*
+ * File:	interpreter.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for the interpreter, which runs a program
+ *		without generating, assembling, or linking any code, so
+ *		that a short program starts running as soon as it has been
+ *		checked.
+ *
+ *		Each function is built as a flow graph, as for the
+ *		optimizer, which is then lowered without being optimized
+ *		into a compact bytecode for a register machine.  Each
+ *		integer constant and the address of each global has a
+ *		register of its own, initialized on entry, as does each
+ *		local scalar variable.  The other values are assigned
+ *		registers by a linear scan over the blocks in order, so a
+ *		register is reused once its value is dead.  Where it is
+ *		safe, reading a variable simply uses its register, the
+ *		value assigned to a variable is computed directly into its
+ *		register, a local in memory is accessed by its offset in
+ *		the stack frame, and a comparison is combined with the
+ *		branch that tests it.
+ *
+ *		The bytecode is threaded: each instruction holds the
+ *		address of the code that executes it, using the labels as
+ *		values of GCC, which then jumps directly to that of the
+ *		next.  Every value is kept sign-extended from its size, so
+ *		that only the arithmetic and truncation need to know the
+ *		size, and extension costs nothing.
+ *
+ *		The globals and string literals are allocated on the heap,
+ *		and the locals that live in memory in a stack frame, so
+ *		their addresses can be passed to the C library.  A function
+ *		not defined in the program is found with dlsym() and called
+ *		through a shim that always passes the most arguments any
+ *		call may have, which is harmless since the caller removes
+ *		them.
+ */
+
+# include <map>
+# include <dlfcn.h>
+# include <alloca.h>
+# include <cstdlib>
+# include <cstring>
+# include <iostream>
+# include "machine.h"
+# include "generator.h"
+# include "interpreter.h"
+# include "IR.h"
+
+using namespace std;
+
+# define MAX_ARGS 16
+
+enum {
+    I_PARAM, I_MOVE, I_FRAME, I_TRUNC1, I_TRUNC4,
+    I_LOAD1, I_LOAD4, I_LOAD8, I_STORE1, I_STORE4, I_STORE8,
+    I_LOADF1, I_LOADF4, I_LOADF8, I_STOREF1, I_STOREF4, I_STOREF8,
+    I_ADD4, I_ADD8, I_SUB4, I_SUB8, I_MUL4, I_MUL8,
+    I_DIV4, I_DIV8, I_REM4, I_REM8, I_NEG4, I_NEG8,
+    I_LT, I_GT, I_LE, I_GE, I_EQ, I_NE,
+    I_JUMP, I_JLT, I_JGT, I_JLE, I_JGE, I_JEQ, I_JNE, I_JNZ, I_JZ,
+    I_CALL, I_EXTERN, I_RETURN
+};
+
+/* An instruction of the bytecode, which holds the address of the code
+   that executes it and up to three operands, usually registers. */
+
+struct Code {
+    const void *op;
+    int a, b, c;
+};
+
+/* A function lowered into bytecode, with the initial values of its
+   constant registers, and a list of the argument registers for each
+   of its calls, each preceded by the number of arguments.  A frame
+   holds the registers, the locals in memory below the frame pointer,
+   and the parameters passed in memory above it. */
+
+struct Routine {
+    vector<Code> code;
+    vector<long> constants;
+    vector<int> lists;
+    unsigned registers, locals, incoming;
+};
+
+/* What is known about each value while lowering a flow graph: its
+   position in the layout, its uses and the position of the last one,
+   the value whose register it shares, if any, and whether it is used
+   outside its block or needs no code of its own. */
+
+struct Value {
+    unsigned position, uses, last;
+    Instruction *user, *alias;
+    int reg;
+    bool remote, folded;
+};
+
+static const void *const *labels;
+static vector<Routine> routines;
+static vector<void *> externs;
+static map<string, unsigned> indices, externals;
+static map<string, char *> addresses;
+static vector<Value> values;
+static unsigned base;
+
+
+/*
+ * Function:	fail (private)
+ *
+ * Description:	Report an error in preparing the program and terminate.
+ */
+
+static void fail(const string &msg, const string &arg = "")
+{
+    cerr << "scc: " << msg << arg << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	shim (private)
+ *
+ * Description:	Call a function in the C library with the arguments in
+ *		the given registers, as if it took a variable number of
+ *		arguments, which is how the compiled code calls it.
+ */
+
+static long shim(void *function, const long *r, const int *list)
+{
+    typedef long (*Variadic)(...);
+    long args[MAX_ARGS] = {0};
+    Variadic callee;
+
+
+    for (int i = 0; i < list[0]; i ++)
+	args[i] = r[list[i + 1]];
+
+    memcpy(&callee, &function, sizeof(callee));
+
+    return callee(args[0], args[1], args[2], args[3], args[4], args[5],
+	    args[6], args[7], args[8], args[9], args[10], args[11],
+	    args[12], args[13], args[14], args[15]);
+}
+
+
+/*
+ * Function:	execute (private)
+ *
+ * Description:	Execute a routine, whose arguments are the registers of
+ *		its caller named in the given list, and return its value.
+ *		Called with a null routine, it instead records the
+ *		addresses of the code for each operation.
+ */
+
+# define NEXT		goto *(++ pc)->op
+# define BRANCH(cond)	if (cond) { pc = code + pc->c; goto *pc->op; } NEXT
+
+static long execute(const Routine *routine, const long *caller, const int *list)
+{
+    static const void *const handlers[] = {
+	&&param, &&move, &&frame, &&trunc1, &&trunc4,
+	&&load1, &&load4, &&load8, &&store1, &&store4, &&store8,
+	&&loadf1, &&loadf4, &&loadf8, &&storef1, &&storef4, &&storef8,
+	&&add4, &&add8, &&sub4, &&sub8, &&mul4, &&mul8,
+	&&div4, &&div8, &&rem4, &&rem8, &&neg4, &&neg8,
+	&&lt, &&gt, &&le, &&ge, &&eq, &&ne,
+	&&jump, &&jlt, &&jgt, &&jle, &&jge, &&jeq, &&jne, &&jnz, &&jz,
+	&&call, &&extern_, &&return_,
+    };
+
+    const Code *code, *pc;
+    const int *lists;
+    char *fp;
+    long *r;
+
+
+    if (routine == nullptr) {
+	labels = handlers;
+	return 0;
+    }
+
+    r = (long *) alloca(routine->registers * sizeof(long) +
+	    routine->locals + routine->incoming);
+    memcpy(r, routine->constants.data(), routine->constants.size() * sizeof(long));
+
+    fp = (char *) (r + routine->registers) + routine->locals;
+    lists = routine->lists.data();
+    code = pc = routine->code.data();
+    goto *pc->op;
+
+param:
+    r[pc->a] = pc->b < list[0] ? normalize(caller[list[pc->b + 1]], pc->c) : 0;
+    NEXT;
+
+move:
+    r[pc->a] = r[pc->b];
+    NEXT;
+
+frame:
+    r[pc->a] = (long) (fp + pc->b);
+    NEXT;
+
+trunc1:
+    r[pc->a] = (signed char) r[pc->b];
+    NEXT;
+
+trunc4:
+    r[pc->a] = (int) r[pc->b];
+    NEXT;
+
+load1:
+    r[pc->a] = *(signed char *) r[pc->b];
+    NEXT;
+
+load4:
+    r[pc->a] = *(int *) r[pc->b];
+    NEXT;
+
+load8:
+    r[pc->a] = *(long *) r[pc->b];
+    NEXT;
+
+store1:
+    *(char *) r[pc->a] = r[pc->b];
+    NEXT;
+
+store4:
+    *(int *) r[pc->a] = r[pc->b];
+    NEXT;
+
+store8:
+    *(long *) r[pc->a] = r[pc->b];
+    NEXT;
+
+loadf1:
+    r[pc->a] = *(signed char *) (fp + pc->b);
+    NEXT;
+
+loadf4:
+    r[pc->a] = *(int *) (fp + pc->b);
+    NEXT;
+
+loadf8:
+    r[pc->a] = *(long *) (fp + pc->b);
+    NEXT;
+
+storef1:
+    *(char *) (fp + pc->a) = r[pc->b];
+    NEXT;
+
+storef4:
+    *(int *) (fp + pc->a) = r[pc->b];
+    NEXT;
+
+storef8:
+    *(long *) (fp + pc->a) = r[pc->b];
+    NEXT;
+
+
+    /* The arithmetic is unsigned so that overflow wraps around as it
+       does in the compiled code, and is then truncated to the size. */
+
+add4:
+    r[pc->a] = (int) ((unsigned long) r[pc->b] + r[pc->c]);
+    NEXT;
+
+add8:
+    r[pc->a] = (unsigned long) r[pc->b] + r[pc->c];
+    NEXT;
+
+sub4:
+    r[pc->a] = (int) ((unsigned long) r[pc->b] - r[pc->c]);
+    NEXT;
+
+sub8:
+    r[pc->a] = (unsigned long) r[pc->b] - r[pc->c];
+    NEXT;
+
+mul4:
+    r[pc->a] = (int) ((unsigned long) r[pc->b] * r[pc->c]);
+    NEXT;
+
+mul8:
+    r[pc->a] = (unsigned long) r[pc->b] * r[pc->c];
+    NEXT;
+
+div4:
+    r[pc->a] = (int) (r[pc->b] / r[pc->c]);
+    NEXT;
+
+div8:
+    r[pc->a] = r[pc->b] / r[pc->c];
+    NEXT;
+
+rem4:
+    r[pc->a] = (int) (r[pc->b] % r[pc->c]);
+    NEXT;
+
+rem8:
+    r[pc->a] = r[pc->b] % r[pc->c];
+    NEXT;
+
+neg4:
+    r[pc->a] = (int) -(unsigned long) r[pc->b];
+    NEXT;
+
+neg8:
+    r[pc->a] = -(unsigned long) r[pc->b];
+    NEXT;
+
+lt:
+    r[pc->a] = r[pc->b] < r[pc->c];
+    NEXT;
+
+gt:
+    r[pc->a] = r[pc->b] > r[pc->c];
+    NEXT;
+
+le:
+    r[pc->a] = r[pc->b] <= r[pc->c];
+    NEXT;
+
+ge:
+    r[pc->a] = r[pc->b] >= r[pc->c];
+    NEXT;
+
+eq:
+    r[pc->a] = r[pc->b] == r[pc->c];
+    NEXT;
+
+ne:
+    r[pc->a] = r[pc->b] != r[pc->c];
+    NEXT;
+
+jump:
+    pc = code + pc->c;
+    goto *pc->op;
+
+jlt:
+    BRANCH(r[pc->a] < r[pc->b]);
+
+jgt:
+    BRANCH(r[pc->a] > r[pc->b]);
+
+jle:
+    BRANCH(r[pc->a] <= r[pc->b]);
+
+jge:
+    BRANCH(r[pc->a] >= r[pc->b]);
+
+jeq:
+    BRANCH(r[pc->a] == r[pc->b]);
+
+jne:
+    BRANCH(r[pc->a] != r[pc->b]);
+
+jnz:
+    BRANCH(r[pc->a] != 0);
+
+jz:
+    BRANCH(r[pc->a] == 0);
+
+call:
+    r[pc->a] = execute(&routines[pc->b], r, lists + pc->c);
+    NEXT;
+
+extern_:
+    r[pc->a] = shim(externs[pc->b], r, lists + pc->c);
+    NEXT;
+
+return_:
+    return pc->a >= 0 ? r[pc->a] : 0;
+}
+
+# undef NEXT
+# undef BRANCH
+
+
+/*
+ * Function:	value (private)
+ *
+ * Description:	Return what is known about an instruction of the flow
+ *		graph being lowered.
+ */
+
+static Value &value(const Instruction *in)
+{
+    return values[in->_number - base];
+}
+
+
+/*
+ * Function:	reg (private)
+ *
+ * Description:	Return the register holding the value of an instruction.
+ */
+
+static int reg(const Instruction *in)
+{
+    const Value &v = value(in);
+
+    return v.alias != nullptr ? value(v.alias).reg : v.reg;
+}
+
+
+/*
+ * Function:	framed (private)
+ *
+ * Description:	Return whether the address of a local in memory is used
+ *		only as an offset from the frame pointer.
+ */
+
+static bool framed(const Instruction *in)
+{
+    return in->_opcode == OP_FRAME && value(in).folded;
+}
+
+
+/*
+ * Function:	emit (private)
+ *
+ * Description:	Append an instruction to the bytecode of a routine.
+ */
+
+static void emit(Routine &routine, int op, int a, int b = 0, int c = 0)
+{
+    Code code = {labels[op], a, b, c};
+
+    routine.code.push_back(code);
+}
+
+
+/*
+ * Function:	access (private)
+ *
+ * Description:	Return the offset of the operation of the given size for
+ *		loads and stores, which follow one another.
+ */
+
+static int access(unsigned size)
+{
+    return size == 1 ? 0 : size == 4 ? 1 : 2;
+}
+
+
+/*
+ * Function:	locate (private)
+ *
+ * Description:	Return the address of a global variable or string literal,
+ *		given its operand, or of a global in the C library.
+ */
+
+static long locate(const string &name)
+{
+    map<string, char *>::iterator it = addresses.find(name);
+    string symbol = name.substr(strlen(global_prefix));
+    void *address;
+
+
+    if (it != addresses.end())
+	return (long) it->second;
+
+    symbol = symbol.substr(0, symbol.size() - strlen(global_suffix));
+    address = dlsym(RTLD_DEFAULT, symbol.c_str());
+
+    if (address == nullptr)
+	fail("undefined reference to ", symbol);
+
+    return (long) address;
+}
+
+
+/*
+ * Function:	callee (private)
+ *
+ * Description:	Return the index of a function in the C library called
+ *		with the given name, finding it the first time.
+ */
+
+static unsigned callee(const string &name)
+{
+    map<string, unsigned>::iterator it = externals.find(name);
+    string symbol = name.substr(strlen(global_prefix));
+    void *address;
+
+
+    if (it != externals.end())
+	return it->second;
+
+    address = dlsym(RTLD_DEFAULT, symbol.c_str());
+
+    if (address == nullptr)
+	fail("undefined reference to ", symbol);
+
+    externs.push_back(address);
+    return externals[name] = externs.size() - 1;
+}
+
+
+/*
+ * Function:	produces (private)
+ *
+ * Description:	Return whether an instruction computes its value into a
+ *		register chosen for it, which could then be that of a
+ *		variable instead.
+ */
+
+static bool produces(const Instruction *in)
+{
+    const Value &v = value(in);
+
+    if (v.folded || v.alias != nullptr)
+	return false;
+
+    switch (in->_opcode) {
+    case OP_PARAM: case OP_FRAME: case OP_GET: case OP_LOAD: case OP_CALL:
+    case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_REM:
+    case OP_NEG: case OP_LT: case OP_GT: case OP_LE: case OP_GE:
+    case OP_EQ: case OP_NE: case OP_TRUNC: case OP_COPY:
+	return true;
+    }
+
+    return false;
+}
+
+
+/*
+ * Function:	analyze (private)
+ *
+ * Description:	Number the instructions of a flow graph in order, find
+ *		the uses of each value, collect the constants of a routine,
+ *		and decide which values share a register or need no code
+ *		of their own.
+ */
+
+static void analyze(Graph *graph, Routine &routine)
+{
+    const BasicBlocks &blocks = graph->_blocks;
+    unsigned first = ~0u, last = 0, position = 0;
+    map<long, int> constants;
+
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	for (unsigned j = 0; j < blocks[i]->_instructions.size(); j ++) {
+	    first = min(first, blocks[i]->_instructions[j]->_number);
+	    last = max(last, blocks[i]->_instructions[j]->_number);
+	}
+
+    base = first;
+    values.assign(last - first + 1, Value());
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	for (unsigned j = 0; j < blocks[i]->_instructions.size(); j ++) {
+	    Value &v = value(blocks[i]->_instructions[j]);
+
+	    v.position = v.last = position ++;
+	    v.uses = 0;
+	    v.user = v.alias = nullptr;
+	    v.reg = -1;
+	    v.remote = v.folded = false;
+	}
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	for (unsigned j = 0; j < blocks[i]->_instructions.size(); j ++) {
+	    Instruction *in = blocks[i]->_instructions[j];
+
+	    for (unsigned k = 0; k < in->_operands.size(); k ++) {
+		Value &v = value(in->_operands[k]);
+
+		v.uses ++;
+		v.user = in;
+		v.last = max(v.last, value(in).position);
+		v.remote = v.remote || in->_operands[k]->_block != in->_block;
+	    }
+	}
+
+
+    /* Each distinct constant and address of a global has a register,
+       which precedes those of the variables. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	for (unsigned j = 0; j < blocks[i]->_instructions.size(); j ++) {
+	    Instruction *in = blocks[i]->_instructions[j];
+	    long constant;
+
+	    if (in->_opcode == OP_CONST)
+		constant = normalize(in->_value, in->_size);
+	    else if (in->_opcode == OP_GLOBAL)
+		constant = locate(in->_name);
+	    else
+		continue;
+
+	    if (constants.count(constant) == 0) {
+		constants[constant] = routine.constants.size();
+		routine.constants.push_back(constant);
+	    }
+
+	    value(in).reg = constants[constant];
+	    value(in).folded = true;
+	}
+
+
+    /* An extension shares the register of its operand, which must then
+       live as long as the extension does. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++)
+	for (unsigned j = 0; j < blocks[i]->_instructions.size(); j ++) {
+	    Instruction *in = blocks[i]->_instructions[j], *root;
+
+	    if (in->_opcode != OP_EXT)
+		continue;
+
+	    root = in->_operands[0];
+
+	    if (value(root).alias != nullptr)
+		root = value(root).alias;
+
+	    Value &v = value(in), &r = value(root);
+
+	    v.alias = root;
+	    r.last = max(r.last, v.last);
+	    r.remote = r.remote || v.remote || in->_block != root->_block;
+	}
+
+
+    /* A read of a variable uses its register if the variable is not
+       assigned before the value is last used, within the block. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++) {
+	const Instructions &instructions = blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instruction *in = instructions[j];
+	    Value &v = value(in);
+	    bool safe = !v.remote;
+
+	    if (in->_opcode != OP_GET)
+		continue;
+
+	    for (unsigned k = j + 1; safe && k < instructions.size() &&
+		    value(instructions[k]).position < v.last; k ++)
+		if (instructions[k]->_opcode == OP_SET &&
+			instructions[k]->_value == in->_value)
+		    safe = false;
+
+	    if (safe) {
+		v.reg = routine.constants.size() + in->_value;
+		v.folded = true;
+	    }
+	}
+    }
+
+
+    /* A value assigned to a variable right after it is computed is
+       computed directly into the register of the variable. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++) {
+	const Instructions &instructions = blocks[i]->_instructions;
+
+	for (unsigned j = 1; j < instructions.size(); j ++) {
+	    Instruction *in = instructions[j], *prev = instructions[j - 1];
+
+	    if (in->_opcode == OP_SET && in->_operands[0] == prev &&
+		    value(prev).uses == 1 && produces(prev)) {
+		value(prev).reg = routine.constants.size() + in->_value;
+		value(in).folded = true;
+	    }
+	}
+    }
+
+
+    /* A local in memory used only once is accessed by its offset, and a
+       comparison just before the branch that tests it is combined
+       with the branch. */
+
+    for (unsigned i = 0; i < blocks.size(); i ++) {
+	const Instructions &instructions = blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instruction *in = instructions[j], *user = value(in).user;
+
+	    if (value(in).uses != 1)
+		continue;
+
+	    if (in->_opcode == OP_FRAME && value(in).reg < 0) {
+		if (user->_opcode == OP_LOAD ||
+			(user->_opcode == OP_STORE && user->_operands[1] != in))
+		    value(in).folded = true;
+
+	    } else if (in->isCompare() && j + 2 == instructions.size() &&
+		    user == instructions[j + 1] && user->_opcode == OP_BRANCH)
+		value(in).folded = true;
+	}
+    }
+}
+
+
+/*
+ * Function:	lower (private)
+ *
+ * Description:	Lower a flow graph into the bytecode of a routine.  The
+ *		registers hold the constants, then the variables, and then
+ *		the other values.
+ */
+
+static void lower(Graph *graph, Routine &routine)
+{
+    static const int inverse[] = {3, 2, 1, 0, 5, 4};
+    const BasicBlocks &blocks = graph->_blocks;
+    vector<pair<unsigned, BasicBlock *>> targets;
+    vector<pair<unsigned, int>> active;
+    unsigned numVars, next, high = 0;
+    vector<unsigned> starts;
+    vector<int> available;
+
+
+    analyze(graph, routine);
+    numVars = graph->_variables.size();
+    next = routine.constants.size() + numVars;
+
+    for (unsigned i = 0; i < blocks.size(); i ++) {
+	const Instructions &instructions = blocks[i]->_instructions;
+	BasicBlock *following = i + 1 < blocks.size() ? blocks[i + 1] : nullptr;
+
+	starts.push_back(routine.code.size());
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instruction *in = instructions[j];
+	    Value &v = value(in);
+	    int dst, op = in->_opcode;
+	    Instruction *test;
+	    unsigned list;
+
+
+	    /* Assign a register to the value, reusing that of a dead value
+	       if possible. */
+
+	    if (v.reg < 0 && v.alias == nullptr && !v.folded && produces(in)) {
+		for (unsigned k = 0; k < active.size(); k ++)
+		    if (active[k].first <= v.position) {
+			available.push_back(active[k].second);
+			active[k --] = active.back();
+			active.pop_back();
+		    }
+
+		if (available.empty())
+		    v.reg = next ++;
+		else {
+		    v.reg = available.back();
+		    available.pop_back();
+		}
+
+		active.push_back(make_pair(v.last, v.reg));
+	    }
+
+	    dst = v.reg;
+
+	    switch (op) {
+	    case OP_CONST: case OP_GLOBAL: case OP_EXT:
+		break;
+
+	    case OP_PARAM:
+		emit(routine, I_PARAM, dst, in->_value, in->_size);
+		break;
+
+	    case OP_FRAME:
+		high = max(high, (unsigned) max(in->_value + SIZEOF_LONG, 0L));
+
+		if (!v.folded)
+		    emit(routine, I_FRAME, dst, in->_value);
+
+		break;
+
+	    case OP_GET:
+		if (!v.folded)
+		    emit(routine, I_MOVE, dst, routine.constants.size() + in->_value);
+
+		break;
+
+	    case OP_SET:
+		if (!v.folded)
+		    emit(routine, I_MOVE, routine.constants.size() + in->_value,
+			    reg(in->_operands[0]));
+
+		break;
+
+	    case OP_COPY:
+		emit(routine, I_MOVE, dst, reg(in->_operands[0]));
+		break;
+
+	    case OP_LOAD:
+		if (framed(in->_operands[0]))
+		    emit(routine, I_LOADF1 + access(in->_size), dst,
+			    in->_operands[0]->_value);
+		else
+		    emit(routine, I_LOAD1 + access(in->_size), dst,
+			    reg(in->_operands[0]));
+
+		break;
+
+	    case OP_STORE:
+		if (framed(in->_operands[0]))
+		    emit(routine, I_STOREF1 + access(in->_size),
+			    in->_operands[0]->_value, reg(in->_operands[1]));
+		else
+		    emit(routine, I_STORE1 + access(in->_size),
+			    reg(in->_operands[0]), reg(in->_operands[1]));
+
+		break;
+
+	    case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_REM:
+		emit(routine, I_ADD4 + 2 * (op - OP_ADD) + (in->_size == 8), dst,
+			reg(in->_operands[0]), reg(in->_operands[1]));
+		break;
+
+	    case OP_NEG:
+		emit(routine, I_NEG4 + (in->_size == 8), dst, reg(in->_operands[0]));
+		break;
+
+	    case OP_LT: case OP_GT: case OP_LE: case OP_GE: case OP_EQ: case OP_NE:
+		if (!v.folded)
+		    emit(routine, I_LT + op - OP_LT, dst, reg(in->_operands[0]),
+			    reg(in->_operands[1]));
+
+		break;
+
+	    case OP_TRUNC:
+		emit(routine, in->_size == 1 ? I_TRUNC1 : in->_size == 4 ?
+			I_TRUNC4 : I_MOVE, dst, reg(in->_operands[0]));
+		break;
+
+	    case OP_CALL:
+		if (in->_operands.size() > MAX_ARGS)
+		    fail("too many arguments in call to ", in->_name);
+
+		list = routine.lists.size();
+		routine.lists.push_back(in->_operands.size());
+
+		for (unsigned k = 0; k < in->_operands.size(); k ++)
+		    routine.lists.push_back(reg(in->_operands[k]));
+
+		if (indices.count(in->_name) > 0)
+		    emit(routine, I_CALL, dst, indices[in->_name], list);
+		else {
+		    emit(routine, I_EXTERN, dst, callee(in->_name), list);
+
+		    if (in->_size == 1 || in->_size == 4)
+			emit(routine, in->_size == 1 ? I_TRUNC1 : I_TRUNC4, dst, dst);
+		}
+
+		break;
+
+	    case OP_JUMP:
+		if (blocks[i]->_successors[0] != following) {
+		    targets.push_back(make_pair(routine.code.size(), blocks[i]->_successors[0]));
+		    emit(routine, I_JUMP, 0);
+		}
+
+		break;
+
+	    case OP_BRANCH:
+		test = in->_operands[0];
+
+		if (value(test).folded) {
+		    op = I_JLT + test->_opcode - OP_LT;
+
+		    if (blocks[i]->_successors[0] == following)
+			op = I_JLT + inverse[op - I_JLT];
+
+		    emit(routine, op, reg(test->_operands[0]), reg(test->_operands[1]));
+		} else if (blocks[i]->_successors[0] == following)
+		    emit(routine, I_JZ, reg(test));
+		else
+		    emit(routine, I_JNZ, reg(test));
+
+		if (blocks[i]->_successors[0] == following)
+		    targets.push_back(make_pair(routine.code.size() - 1, blocks[i]->_successors[1]));
+		else {
+		    targets.push_back(make_pair(routine.code.size() - 1, blocks[i]->_successors[0]));
+
+		    if (blocks[i]->_successors[1] != following) {
+			targets.push_back(make_pair(routine.code.size(), blocks[i]->_successors[1]));
+			emit(routine, I_JUMP, 0);
+		    }
+		}
+
+		break;
+
+	    case OP_RETURN:
+		emit(routine, I_RETURN, in->_operands.empty() ? -1 : reg(in->_operands[0]));
+		break;
+
+	    default:
+		fail("cannot interpret ", graph->_id->name());
+	    }
+	}
+    }
+
+    for (unsigned i = 0; i < targets.size(); i ++)
+	routine.code[targets[i].first].c = starts[targets[i].second->_number];
+
+    routine.registers = (next + 1) & ~1;
+    routine.locals = (-graph->_offset + 15) & ~15;
+    routine.incoming = high;
+}
+
+
+/*
+ * Function:	interpret
+ *
+ * Description:	Run a program by interpreting its functions, with its
+ *		globals allocated on the heap, and return the value
+ *		returned by its main function.
+ */
+
+int interpret(const vector<Function *> &functions, Scope *globals,
+	int argc, char *argv[])
+{
+    const Symbols &symbols = globals->symbols();
+    map<string, string> literals;
+    map<string, string>::iterator it;
+    long args[] = {argc, (long) argv};
+    int list[] = {2, 0, 1};
+    string main;
+
+
+    for (unsigned i = 0; i < symbols.size(); i ++)
+	if (!symbols[i]->type().isFunction()) {
+	    string name = global_prefix + symbols[i]->name() + global_suffix;
+	    addresses[name] = (char *) calloc(1, symbols[i]->type().size() + 1);
+	}
+
+    for (unsigned i = 0; i < functions.size(); i ++) {
+	functions[i]->build();
+	functions[i]->flowGraph()->order();
+	indices[global_prefix + functions[i]->id()->name()] = i;
+    }
+
+    literals = stringLiterals();
+
+    for (it = literals.begin(); it != literals.end(); ++ it) {
+	addresses[it->first] = (char *) malloc(it->second.size() + 1);
+	memcpy(addresses[it->first], it->second.c_str(), it->second.size() + 1);
+    }
+
+    execute(nullptr, nullptr, nullptr);
+    routines.resize(functions.size());
+
+    for (unsigned i = 0; i < functions.size(); i ++)
+	lower(functions[i]->flowGraph(), routines[i]);
+
+    main = global_prefix + string("main");
+
+    if (indices.count(main) == 0)
+	fail("undefined reference to ", "main");
+
+    return execute(&routines[indices[main]], args, list);
+}
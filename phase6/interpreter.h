@@ -0,0 +1,18 @@
+/*
+ * File:	interpreter.h
+ *
+ * Description:	This file contains the function declarations for running
+ *		a program by interpreting its flow graphs, without
+ *		generating any code for it at all.
+ */
+
+# ifndef INTERPRETER_H
+# define INTERPRETER_H
+# include <vector>
+# include "Tree.h"
+# include "Scope.h"
+
+int interpret(const std::vector<Function *> &functions, Scope *globals,
+	int argc, char *argv[]);
+
+# endif /* INTERPRETER_H */
@@ -0,0 +1,206 @@
+/*
+ * File:	jit.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for running an assembled object in memory
+ *		rather than writing it to a file, linking it, and then
+ *		executing it.
+ *
+ *		The object is loaded into a single mapping so that all
+ *		RIP-relative references are within reach: the code first,
+ *		followed by a stub for each external function, and then
+ *		the data on a separate page.  External symbols are resolved
+ *		in our own process with dlsym(), so the program shares the
+ *		C library with the compiler.  Since the C library is far
+ *		away, each call to it goes through a stub that jumps
+ *		indirectly through an absolute address.  Once relocated,
+ *		the code is made executable and no longer writable.
+ */
+
+# include <dlfcn.h>
+# include <cstdlib>
+# include <cstring>
+# include <iostream>
+# include <unistd.h>
+# include <sys/mman.h>
+# include "jit.h"
+
+using namespace std;
+
+# define STUB_SIZE 16
+
+
+/*
+ * Function:	roundup (private)
+ *
+ * Description:	Round a value up to a multiple of the given power of two.
+ */
+
+static unsigned long roundup(unsigned long value, unsigned long alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+/*
+ * Function:	fail (private)
+ *
+ * Description:	Report an error in loading the object and terminate.
+ */
+
+static void fail(const string &msg, const string &arg = "")
+{
+    cerr << "scc: " << msg << arg << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	run
+ *
+ * Description:	Load the given object into memory, relocate it, and call
+ *		its main function with the given arguments.  Once main
+ *		returns, the functions listed in the .fini_array section
+ *		are called in reverse order, as they would be at exit.
+ *		The return value of main is returned.
+ */
+
+int run(Object &object, int argc, char *argv[])
+{
+    vector<Section> &sections = object.sections;
+    vector<unsigned long> bases(sections.size());
+    vector<unsigned long> addresses(object.symbols.size(), 0);
+    unsigned long page = sysconf(_SC_PAGESIZE), size = 0, code, stubs;
+    unsigned char *memory;
+
+
+    /* Lay out the executable sections, the stubs, and then everything
+       else starting on a new page, including the common symbols.  The
+       debugging sections are not needed to run the program. */
+
+    for (unsigned i = 0; i < sections.size(); i ++)
+	if (sections[i].exec) {
+	    size = roundup(size, sections[i].align);
+	    bases[i] = size;
+	    size += sections[i].size;
+	}
+
+    stubs = size = roundup(size, STUB_SIZE);
+
+    for (unsigned i = 0; i < object.symbols.size(); i ++)
+	if (object.symbols[i].section == SYM_UNDEFINED)
+	    size += STUB_SIZE;
+
+    code = size = roundup(size, page);
+
+    for (unsigned i = 0; i < sections.size(); i ++)
+	if (!sections[i].exec && !sections[i].debug) {
+	    size = roundup(size, sections[i].align);
+	    bases[i] = size;
+	    size += sections[i].size;
+	}
+
+    for (unsigned i = 0; i < object.symbols.size(); i ++)
+	if (object.symbols[i].section == SYM_COMMON) {
+	    size = roundup(size, object.symbols[i].value);
+	    addresses[i] = size;
+	    size += object.symbols[i].size;
+	}
+
+    size = roundup(size, page);
+    memory = (unsigned char *) mmap(nullptr, size, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED)
+	fail("cannot allocate memory for program");
+
+
+    /* Copy the contents of each section.  The mapping is already zero,
+       which takes care of .bss and the common symbols. */
+
+    for (unsigned i = 0; i < sections.size(); i ++)
+	if (!sections[i].nobits && !sections[i].debug)
+	    memcpy(memory + bases[i], sections[i].bytes.data(), sections[i].size);
+
+
+    /* Determine the address of every symbol. */
+
+    for (unsigned i = 0; i < object.symbols.size(); i ++) {
+	const ObjectSymbol &s = object.symbols[i];
+
+	if (s.section >= 0)
+	    addresses[i] = (unsigned long) memory + bases[s.section] + s.value;
+
+	else if (s.section == SYM_COMMON)
+	    addresses[i] += (unsigned long) memory;
+
+	else if (s.section == SYM_ABSOLUTE)
+	    addresses[i] = s.value;
+
+	else {
+	    void *external = dlsym(RTLD_DEFAULT, s.name.c_str());
+	    unsigned char *stub = memory + stubs;
+
+	    if (external == nullptr)
+		fail("undefined reference to ", s.name);
+
+	    stub[0] = 0xff;
+	    stub[1] = 0x25;
+	    memset(stub + 2, 0, 4);
+	    memcpy(stub + 6, &external, sizeof(external));
+
+	    addresses[i] = (unsigned long) stub;
+	    stubs += STUB_SIZE;
+	}
+    }
+
+
+    /* Apply the relocations. */
+
+    for (unsigned i = 0; i < sections.size(); i ++)
+	for (unsigned j = 0; !sections[i].debug && j < sections[i].relocs.size(); j ++) {
+	    const Relocation &r = sections[i].relocs[j];
+	    unsigned char *place = memory + bases[i] + r.offset;
+	    long value = addresses[object.table[r.symbol]] + r.addend;
+
+	    if (r.type == RELOC_PC32 || r.type == RELOC_PLT32)
+		value -= (long) place;
+
+	    if (r.type == RELOC_64)
+		memcpy(place, &value, 8);
+
+	    else if ((r.type == RELOC_32 && (unsigned long) value >> 32 != 0) ||
+		    (r.type != RELOC_32 && value != (int) value))
+		fail("relocation out of range for ", r.symbol);
+
+	    else
+		memcpy(place, &value, 4);
+	}
+
+
+    /* Make the code executable, and call the program. */
+
+    if (mprotect(memory, code, PROT_READ | PROT_EXEC) != 0)
+	fail("cannot make program executable");
+
+    if (!object.defined("main"))
+	fail("undefined reference to ", "main");
+
+    int (*entry)(int, char **);
+    void (*fini)();
+    unsigned long address = addresses[object.table["main"]];
+    int status;
+
+    memcpy(&entry, &address, sizeof(entry));
+    status = entry(argc, argv);
+
+    for (unsigned i = 0; i < sections.size(); i ++)
+	if (sections[i].name == ".fini_array")
+	    for (unsigned j = sections[i].size; j >= sizeof(address); j -= sizeof(address)) {
+		memcpy(&address, memory + bases[i] + j - sizeof(address), sizeof(address));
+		memcpy(&fini, &address, sizeof(fini));
+		fini();
+	    }
+
+    return status;
+}
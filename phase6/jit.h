@@ -0,0 +1,14 @@
+/*
+ * File:	jit.h
+ *
+ * Description:	This file contains the function declarations for running
+ *		an assembled object directly in memory.
+ */
+
+# ifndef JIT_H
+# define JIT_H
+# include "assembler.h"
+
+int run(Object &object, int argc, char *argv[]);
+
+# endif /* JIT_H */
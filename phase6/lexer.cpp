@@ -11,6 +11,7 @@
 # include <cstdlib>
 # include <iostream>
 # include "lexer.h"
+# include "statistics.h"
 # include "tokens.h"
 
 using namespace std;
@@ -82,13 +83,13 @@ void report(const string &str, const string &arg)
 
 
 /*
- * Function:	lexan
+ * Function:	tokenize (private)
  *
  * Description:	Read and tokenize the standard input stream.  The lexeme is
  *		stored in a buffer.
  */
 
-int lexan(string &lexbuf)
+static int tokenize(string &lexbuf)
 {
     int p;
     unsigned i;
@@ -344,3 +345,31 @@ int lexan(string &lexbuf)
 
     return DONE;
 }
+
+
+/*
+ * Function:	lexan
+ *
+ * Description:	Return the next token from the standard input stream,
+ *		counting it and charging the time taken to lexing if they
+ *		are being reported.  Only the wall-clock time is taken,
+ *		since the processor time is too slow to read per token.
+ */
+
+int lexan(string &lexbuf)
+{
+    chrono::steady_clock::time_point start;
+    chrono::duration<double, milli> elapsed;
+    int token;
+
+
+    if (!timeReport && !memReport)
+	return tokenize(lexbuf);
+
+    start = chrono::steady_clock::now();
+    token = tokenize(lexbuf);
+    elapsed = chrono::steady_clock::now() - start;
+    phaseTimes[LEXING].wall += elapsed.count();
+    tallies[TOKENS] ++;
+    return token;
+}
@@ -0,0 +1,527 @@
+/*
+ * File:	loops.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for the loop optimizations, which are done on
+ *		the flow graph in SSA form:
+ *
+ *		- loop invariant code motion, which moves each computation
+ *		  whose operands do not change within a loop to the block
+ *		  just before the loop, called its preheader
+ *		- vectorization of loops of a single block, which is done
+ *		  in vectorizer.cpp once the invariant code is moved out
+ *		- strength reduction, which replaces a scaled induction
+ *		  variable, such as the address of a[i] computed from i, by
+ *		  a new variable that is incremented by a constant amount
+ *		  on each iteration
+ *
+ *		A loop is found from each back edge, which is an edge to a
+ *		block that dominates its source.  Since while loops are
+ *		built with their test at the bottom and guarded by a copy
+ *		of the test at the top, the preheader is only reached when
+ *		the body is executed at least once.  A load that is
+ *		executed on every iteration can therefore be moved to the
+ *		preheader, as long as nothing stored in the loop may change
+ *		it.  We use the size of the access as its type: a store can
+ *		only change a load of the same size, except that a store or
+ *		load of a character may refer to any location.
+ */
+
+# include <set>
+# include <algorithm>
+# include "machine.h"
+# include "IR.h"
+
+using namespace std;
+
+typedef set<BasicBlock *> Blocks;
+
+struct Loop {
+    BasicBlock *header, *preheader;
+    BasicBlocks latches;
+    Blocks blocks;
+};
+
+/* Instructions ordered as they were created, rather than by address, so
+   that the code does not depend upon where they happen to be allocated. */
+
+struct Earlier {
+    bool operator ()(const Instruction *a, const Instruction *b) const {
+	return a->_number < b->_number;
+    }
+};
+
+
+/*
+ * Function:	find (private)
+ *
+ * Description:	Find the loops in the graph, innermost first.  The blocks
+ *		of a loop are its header and all blocks that reach one of
+ *		its latches without passing through the header.  The
+ *		preheader is the only predecessor of the header outside the
+ *		loop, if it has no other successor.
+ */
+
+static vector<Loop> find(Graph *graph)
+{
+    vector<Loop> loops;
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *header = graph->_blocks[i];
+	BasicBlocks work, outside;
+	Loop loop;
+
+	for (unsigned j = 0; j < header->_predecessors.size(); j ++)
+	    if (graph->dominates(header, header->_predecessors[j]))
+		loop.latches.push_back(header->_predecessors[j]);
+	    else
+		outside.push_back(header->_predecessors[j]);
+
+	if (loop.latches.empty())
+	    continue;
+
+	loop.header = header;
+	loop.blocks.insert(header);
+	work = loop.latches;
+
+	while (!work.empty()) {
+	    BasicBlock *block = work.back();
+
+	    work.pop_back();
+
+	    if (loop.blocks.insert(block).second)
+		work.insert(work.end(), block->_predecessors.begin(),
+			block->_predecessors.end());
+	}
+
+	loop.preheader = nullptr;
+
+	if (outside.size() == 1 && outside[0]->_successors.size() == 1)
+	    loop.preheader = outside[0];
+
+	loops.push_back(loop);
+    }
+
+    stable_sort(loops.begin(), loops.end(), [](const Loop &a, const Loop &b) {
+	    return a.blocks.size() < b.blocks.size(); });
+
+    return loops;
+}
+
+
+/*
+ * Function:	preheaders (private)
+ *
+ * Description:	Give each loop a preheader if it does not have one, by
+ *		splitting the edge from its only predecessor outside the
+ *		loop.  A loop entered from more than one place is left
+ *		alone.
+ */
+
+static void preheaders(Graph *graph)
+{
+    vector<Loop> loops = find(graph);
+    bool changed = false;
+
+
+    for (unsigned i = 0; i < loops.size(); i ++) {
+	BasicBlock *header = loops[i].header, *pred = nullptr, *block;
+	unsigned count = 0;
+
+	if (loops[i].preheader != nullptr)
+	    continue;
+
+	for (unsigned j = 0; j < header->_predecessors.size(); j ++)
+	    if (loops[i].blocks.count(header->_predecessors[j]) == 0) {
+		pred = header->_predecessors[j];
+		count ++;
+	    }
+
+	if (count != 1)
+	    continue;
+
+	block = new BasicBlock();
+	block->append(new Instruction(OP_JUMP, 0));
+	block->_predecessors.push_back(pred);
+	block->_successors.push_back(header);
+	replace(pred->_successors.begin(), pred->_successors.end(), header, block);
+	replace(header->_predecessors.begin(), header->_predecessors.end(), pred, block);
+	graph->_blocks.push_back(block);
+	changed = true;
+    }
+
+    if (changed) {
+	graph->order();
+	graph->dominators();
+    }
+}
+
+
+/*
+ * Function:	executed (private)
+ *
+ * Description:	Return whether a block of a loop is executed whenever the
+ *		loop is entered, and on every iteration, which is the case
+ *		if it dominates every latch and every block that exits the
+ *		loop.
+ */
+
+static bool executed(Graph *graph, const Loop &loop, BasicBlock *block)
+{
+    for (Blocks::const_iterator it = loop.blocks.begin(); it != loop.blocks.end(); ++ it) {
+	bool exits = (*it)->_successors.empty();
+
+	for (unsigned i = 0; i < (*it)->_successors.size(); i ++)
+	    if (loop.blocks.count((*it)->_successors[i]) == 0)
+		exits = true;
+
+	if (exits && !graph->dominates(block, *it))
+	    return false;
+    }
+
+    for (unsigned i = 0; i < loop.latches.size(); i ++)
+	if (!graph->dominates(block, loop.latches[i]))
+	    return false;
+
+    return true;
+}
+
+
+/*
+ * Function:	aliases (private)
+ *
+ * Description:	Return whether a store may change the location read by a
+ *		load.  Two distinct variables never overlap, and otherwise
+ *		we compare the sizes of the accesses.
+ */
+
+static bool aliases(const Instruction *store, const Instruction *load)
+{
+    const Instruction *a = store->_operands[0], *b = load->_operands[0];
+
+
+    if ((a->_opcode == OP_FRAME || a->_opcode == OP_GLOBAL) &&
+	    (b->_opcode == OP_FRAME || b->_opcode == OP_GLOBAL))
+	return a->_opcode == b->_opcode && a->_value == b->_value &&
+	    a->_name == b->_name;
+
+    if (store->_size == 1 || load->_size == 1)
+	return true;
+
+    return store->_size == load->_size;
+}
+
+
+/*
+ * Function:	movable (private)
+ *
+ * Description:	Return whether an instruction of a loop whose operands are
+ *		all invariant may be moved to its preheader.  A division is
+ *		only moved if it cannot trap, and a load only if it is
+ *		always executed and cannot be changed within the loop.
+ */
+
+static bool movable(Graph *graph, const Loop &loop, const Instructions &effects,
+	const Instruction *in)
+{
+    if (in->_opcode == OP_DIV || in->_opcode == OP_REM) {
+	const Instruction *divisor = in->_operands[1];
+
+	return divisor->_opcode == OP_CONST && divisor->_value != 0 &&
+	    divisor->_value != -1;
+    }
+
+    if (in->isPure())
+	return true;
+
+    if (in->_opcode != OP_LOAD || !executed(graph, loop, in->_block))
+	return false;
+
+    for (unsigned i = 0; i < effects.size(); i ++)
+	if (effects[i]->_opcode == OP_CALL || aliases(effects[i], in))
+	    return false;
+
+    return true;
+}
+
+
+/*
+ * Function:	hoist (private)
+ *
+ * Description:	Move the invariant instructions of a loop to its
+ *		preheader.  The blocks are visited in reverse postorder so
+ *		that an instruction is moved before any that use it.
+ */
+
+static void hoist(Graph *graph, const Loop &loop)
+{
+    BasicBlock *preheader = loop.preheader;
+    Instructions effects;
+
+
+    for (Blocks::const_iterator it = loop.blocks.begin(); it != loop.blocks.end(); ++ it)
+	for (unsigned i = 0; i < (*it)->_instructions.size(); i ++) {
+	    Instruction *in = (*it)->_instructions[i];
+
+	    if (in->_opcode == OP_STORE || in->_opcode == OP_CALL)
+		effects.push_back(in);
+	}
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+	Instructions &instructions = block->_instructions;
+
+	if (loop.blocks.count(block) == 0)
+	    continue;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    Instruction *in = instructions[j];
+	    bool invariant = in->_opcode != OP_PHI;
+
+	    for (unsigned k = 0; k < in->_operands.size(); k ++)
+		if (loop.blocks.count(in->_operands[k]->_block) > 0)
+		    invariant = false;
+
+	    if (invariant && movable(graph, loop, effects, in)) {
+		instructions.erase(instructions.begin() + j --);
+		preheader->insert(in, preheader->_instructions.size() - 1);
+	    }
+	}
+    }
+}
+
+
+/*
+ * Function:	coefficient (private)
+ *
+ * Description:	Return the multiple of a basic induction variable that the
+ *		given value adds to it on each iteration, or zero if the
+ *		value is not a linear function of it.  The scaled flag is
+ *		set if a multiplication is involved.
+ */
+
+static long coefficient(const Loop &loop, Instruction *phi, Instruction *in,
+	bool &scaled)
+{
+    Instruction *a, *b;
+    long c;
+
+
+    if (in == phi)
+	return 1;
+
+    if (loop.blocks.count(in->_block) == 0 || in->_operands.empty())
+	return 0;
+
+    a = in->_operands[0];
+
+    if (in->_opcode == OP_EXT)
+	return coefficient(loop, phi, a, scaled);
+
+    if (in->_operands.size() != 2)
+	return 0;
+
+    b = in->_operands[1];
+
+    if (in->_opcode == OP_ADD && loop.blocks.count(a->_block) == 0)
+	swap(a, b);
+
+    if (in->_opcode == OP_MUL && a->_opcode == OP_CONST)
+	swap(a, b);
+
+    if ((in->_opcode == OP_ADD || in->_opcode == OP_SUB) &&
+	    loop.blocks.count(b->_block) == 0)
+	return coefficient(loop, phi, a, scaled);
+
+    if (in->_opcode == OP_MUL && b->_opcode == OP_CONST) {
+	c = coefficient(loop, phi, a, scaled);
+	scaled = true;
+	return c * b->_value;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function:	clone (private)
+ *
+ * Description:	Compute in the preheader the value that a linear function
+ *		of an induction variable has on entry to the loop.
+ */
+
+static Instruction *clone(const Loop &loop, Instruction *phi, Instruction *init,
+	Instruction *in)
+{
+    BasicBlock *preheader = loop.preheader;
+    Instruction *copy;
+
+
+    if (in == phi)
+	return init;
+
+    if (loop.blocks.count(in->_block) == 0)
+	return in;
+
+    copy = new Instruction(in->_opcode, in->_size, in->_operands, in->_value);
+
+    for (unsigned i = 0; i < copy->_operands.size(); i ++)
+	copy->_operands[i] = clone(loop, phi, init, copy->_operands[i]);
+
+    preheader->insert(copy, preheader->_instructions.size() - 1);
+    return copy;
+}
+
+
+/*
+ * Function:	reduce (private)
+ *
+ * Description:	Perform strength reduction on a loop with a single latch.
+ *		A basic induction variable is a phi function of the header
+ *		that is incremented by a constant on each iteration.  Each
+ *		scaled linear function of one that is used other than to
+ *		compute another such function is replaced by a new phi
+ *		function, which starts at the value of the function on
+ *		entry and is incremented by a constant.
+ */
+
+static void reduce(Graph *graph, const Loop &loop)
+{
+    BasicBlock *header = loop.header, *latch;
+    map<Instruction *, Instruction *> values;
+    map<Instruction *, Instruction *, Earlier> bases;
+    map<Instruction *, long, Earlier> steps;
+    map<Instruction *, long> strides;
+    unsigned entry, back;
+
+
+    if (loop.latches.size() != 1 || header->_predecessors.size() != 2)
+	return;
+
+    latch = loop.latches[0];
+    back = header->_predecessors[0] == latch ? 0 : 1;
+    entry = 1 - back;
+
+
+    /* Find the basic induction variables. */
+
+    for (unsigned i = 0; i < header->_instructions.size(); i ++) {
+	Instruction *phi = header->_instructions[i], *next;
+
+	if (phi->_opcode != OP_PHI)
+	    break;
+
+	next = phi->_operands[back];
+
+	if (next->_opcode != OP_ADD && next->_opcode != OP_SUB)
+	    continue;
+
+	if (next->_operands[0] == phi && next->_operands[1]->_opcode == OP_CONST)
+	    steps[phi] = next->_operands[1]->_value;
+	else if (next->_opcode == OP_ADD && next->_operands[1] == phi &&
+		next->_operands[0]->_opcode == OP_CONST)
+	    steps[phi] = next->_operands[0]->_value;
+	else
+	    continue;
+
+	if (next->_opcode == OP_SUB)
+	    steps[phi] = -steps[phi];
+    }
+
+    if (steps.empty())
+	return;
+
+
+    /* Find the values to reduce, which are those used by an instruction
+       that is not itself a linear function of the same variable. */
+
+    for (Blocks::const_iterator it = loop.blocks.begin(); it != loop.blocks.end(); ++ it)
+	for (unsigned i = 0; i < (*it)->_instructions.size(); i ++) {
+	    Instruction *user = (*it)->_instructions[i];
+
+	    for (unsigned j = 0; j < user->_operands.size(); j ++) {
+		Instruction *in = user->_operands[j];
+
+		if (bases.count(in) > 0 || !in->isPure() || in->_size != SIZEOF_PTR)
+		    continue;
+
+		for (map<Instruction *, long, Earlier>::iterator p = steps.begin(); p != steps.end(); ++ p) {
+		    bool scaled = false, inner = false;
+		    long c = coefficient(loop, p->first, in, scaled);
+
+		    if (c == 0 || !scaled)
+			continue;
+
+		    if (user->isPure() && user->_size == in->_size)
+			inner = coefficient(loop, p->first, user, scaled) != 0;
+
+		    if (!inner) {
+			bases[in] = p->first;
+			strides[in] = c * p->second;
+		    }
+
+		    break;
+		}
+	    }
+	}
+
+
+    /* Replace each by a new variable. */
+
+    for (map<Instruction *, Instruction *, Earlier>::iterator it = bases.begin(); it != bases.end(); ++ it) {
+	Instruction *in = it->first, *basic = it->second, *phi, *step, *next;
+
+	phi = new Instruction(OP_PHI, in->_size, Instructions(2));
+	step = new Instruction(OP_CONST, in->_size, {}, normalize(strides[in], in->_size));
+	next = new Instruction(OP_ADD, in->_size, {phi, step});
+
+	phi->_operands[entry] = clone(loop, basic, basic->_operands[entry], in);
+	phi->_operands[back] = next;
+	header->insert(phi, 0);
+	latch->insert(step, latch->_instructions.size() - 1);
+	latch->insert(next, latch->_instructions.size() - 1);
+	values[in] = phi;
+    }
+
+    graph->replace(values);
+}
+
+
+/*
+ * Function:	optimizeLoops
+ *
+ * Description:	Move the invariant code out of each loop, innermost first,
+ *		vectorize what loops we can, and then reduce the strength
+ *		of the induction variables, including those of the new
+ *		vector loops.
+ */
+
+void optimizeLoops(Graph *graph)
+{
+    vector<Loop> loops;
+    bool changed = false;
+
+
+    preheaders(graph);
+    loops = find(graph);
+
+    for (unsigned i = 0; i < loops.size(); i ++)
+	if (loops[i].preheader != nullptr)
+	    hoist(graph, loops[i]);
+
+    for (unsigned i = 0; i < loops.size(); i ++)
+	if (loops[i].preheader != nullptr && loops[i].blocks.size() == 1)
+	    if (vectorize(graph, loops[i].preheader, loops[i].header))
+		changed = true;
+
+    if (changed) {
+	graph->order();
+	graph->dominators();
+	loops = find(graph);
+    }
+
+    for (unsigned i = 0; i < loops.size(); i ++)
+	if (loops[i].preheader != nullptr)
+	    reduce(graph, loops[i]);
+}
@@ -0,0 +1,68 @@
+/*
+ * File:	machine.cpp
+ *
+ * Description:	This file contains the definitions of the conventions of
+ *		the assembler for the target system, and the function to
+ *		choose the target named on the command line.
+ *
+ *		On Linux, the ELF conventions are used: symbols have no
+ *		prefix, local labels start with .L, and each function is
+ *		given a type and size.  On macOS, the Mach-O conventions
+ *		are used instead, and symbols are prefixed with an
+ *		underscore.  Only ELF objects can be assembled directly.
+ */
+
+# include "machine.h"
+
+using namespace std;
+
+# if defined (__APPLE__)
+
+const char *global_prefix = "_";
+const char *global_suffix = "(%rip)";
+const char *label_prefix = "L";
+const char *readonly_section = "\t.const";
+bool typed_symbols = false, elf_target = false;
+
+# else
+
+const char *global_prefix = "";
+const char *global_suffix = "(%rip)";
+const char *label_prefix = ".L";
+const char *readonly_section = "\t.section\t.rodata";
+bool typed_symbols = true, elf_target = true;
+
+# endif
+
+
+/*
+ * Function:	selectTarget
+ *
+ * Description:	Target the system named by the given triple, such as
+ *		x86_64-linux-gnu or x86_64-apple-darwin, and return whether
+ *		it is supported.  Only the architecture and system matter.
+ */
+
+bool selectTarget(const string &triple)
+{
+    if (triple.compare(0, 7, "x86_64-") != 0)
+	return false;
+
+    if (triple.find("-linux") != string::npos) {
+	global_prefix = "";
+	label_prefix = ".L";
+	readonly_section = "\t.section\t.rodata";
+	typed_symbols = elf_target = true;
+	return true;
+    }
+
+    if (triple.find("-darwin") != string::npos || triple.find("-macos") != string::npos) {
+	global_prefix = "_";
+	label_prefix = "L";
+	readonly_section = "\t.const";
+	typed_symbols = elf_target = false;
+	return true;
+    }
+
+    return false;
+}
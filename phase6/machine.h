@@ -3,31 +3,46 @@
  *
  * Description:	This file contains the values of various parameters for the
  *		target machine architecture.
+ *
+ *		The data layout and calling convention are constants known
+ *		when the compiler itself is compiled.  The conventions of
+ *		the assembler, which differ between Linux and macOS although
+ *		the ABI does not, are instead chosen when the compiler runs,
+ *		so that either system can be targeted from the other.  By
+ *		default, that of the host is targeted.
  */
 
-# define SIZEOF_CHAR 1
-# define SIZEOF_INT 4
-# define SIZEOF_LONG 8
-# define SIZEOF_PTR 8
+# ifndef MACHINE_H
+# define MACHINE_H
+# include <string>
+
+/* The System V ABI for x86-64, used by both Linux and macOS.  Each
+   argument passed on the stack has a slot the size of a pointer, with
+   the first just above the return address and saved frame pointer. */
+
+constexpr int SIZEOF_CHAR = 1;
+constexpr int SIZEOF_INT = 4;
+constexpr int SIZEOF_LONG = 8;
+constexpr int SIZEOF_PTR = 8;
 
-# define SIZEOF_ARG 8
-# define NUM_ARGS_IN_REGS 6
-# define INIT_ARG_OFFSET 16
-# define STACK_ALIGNMENT 16
+constexpr int SIZEOF_ARG = SIZEOF_PTR;
+constexpr int NUM_ARGS_IN_REGS = 6;
+constexpr int INIT_ARG_OFFSET = 2 * SIZEOF_PTR;
+constexpr int STACK_ALIGNMENT = 16;
+constexpr int RED_ZONE = 128;
 
-# if defined (__linux__) && defined(__x86_64__)
+/* The alignment of loops, and the size of those small enough to be
+   worth aligning. */
 
-# define global_prefix ""
-# define global_suffix ""
-# define label_prefix ".L"
+constexpr int LOOP_ALIGNMENT = 4;
+constexpr int SMALL_LOOP = 32;
 
-# elif defined (__APPLE__) && defined(__x86_64__)
+/* The conventions of the assembler for the target system. */
 
-# define global_prefix "_"
-# define global_suffix "(%rip)"
-# define label_prefix "L"
+extern const char *global_prefix, *global_suffix, *label_prefix;
+extern const char *readonly_section;
+extern bool typed_symbols, elf_target;
 
-# else
+bool selectTarget(const std::string &triple);
 
-# error Unsupport architecture
-# endif
+# endif /* MACHINE_H */
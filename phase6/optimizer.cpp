@@ -0,0 +1,937 @@
+/*
+ * File:	optimizer.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for the optimizer, which puts a flow graph in
+ *		SSA form and then improves it with a series of passes:
+ *
+ *		- sparse conditional constant propagation (Wegman and
+ *		  Zadeck), which also removes the branches and blocks it
+ *		  proves are never taken or reached
+ *		- copy propagation, which also removes phi functions that
+ *		  merge only a single value
+ *		- global value numbering over the dominator tree, along
+ *		  with a few algebraic simplifications
+ *		- dead code elimination
+ *		- simplification of the flow graph, which removes empty
+ *		  blocks and merges straight-line sequences of blocks
+ *
+ *		The passes are run in sequence, along with the loop
+ *		optimizations in loops.cpp, by the pass manager in
+ *		passes.cpp.
+ *
+ *		SSA form is constructed using the algorithm of Cytron et
+ *		al.: phi functions are placed at the iterated dominance
+ *		frontier of the definitions of each variable, and then the
+ *		variables are renamed by walking the dominator tree.
+ */
+
+# include <set>
+# include <algorithm>
+# include "IR.h"
+
+using namespace std;
+
+typedef map<Instruction *, Instruction *> Values;
+
+
+/*
+ * Function:	discard (private)
+ *
+ * Description:	Remove the instructions in the given set from the graph.
+ */
+
+static void discard(Graph *graph, const set<Instruction *> &removed)
+{
+    if (removed.empty())
+	return;
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+	Instructions kept;
+
+	for (unsigned j = 0; j < instructions.size(); j ++)
+	    if (removed.count(instructions[j]) == 0)
+		kept.push_back(instructions[j]);
+
+	instructions = kept;
+    }
+}
+
+
+/*
+ * Function:	frontiers (private)
+ *
+ * Description:	Compute the dominance frontier of every block, using the
+ *		method of Cooper, Harvey, and Kennedy: a join point is in
+ *		the frontier of each block on the path up the dominator
+ *		tree from each of its predecessors to its dominator.
+ */
+
+static vector<BasicBlocks> frontiers(Graph *graph)
+{
+    vector<BasicBlocks> result(graph->_blocks.size());
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+
+	if (block->_predecessors.size() < 2)
+	    continue;
+
+	for (unsigned j = 0; j < block->_predecessors.size(); j ++) {
+	    BasicBlock *runner = block->_predecessors[j];
+
+	    while (runner != block->_dominator) {
+		BasicBlocks &frontier = result[runner->_number];
+
+		if (frontier.empty() || frontier.back() != block)
+		    frontier.push_back(block);
+
+		runner = runner->_dominator;
+	    }
+	}
+    }
+
+    return result;
+}
+
+
+/*
+ * Function:	rename (private)
+ *
+ * Description:	Rename the variables in a block and then in the blocks it
+ *		dominates.  Each variable has a stack of its reaching
+ *		definitions.  A get is replaced by the definition on top of
+ *		the stack, and a set pushes its operand.  A variable used
+ *		before it is ever set is given the value zero.
+ */
+
+static void rename(Graph *graph, BasicBlock *block,
+	vector<Instructions> &stacks, Values &values, Instructions &undefined)
+{
+    vector<unsigned> pushed;
+    Values::iterator it;
+
+
+    for (unsigned i = 0; i < block->_instructions.size(); i ++) {
+	Instruction *in = block->_instructions[i];
+
+	for (unsigned j = 0; j < in->_operands.size(); j ++)
+	    if ((it = values.find(in->_operands[j])) != values.end())
+		in->_operands[j] = it->second;
+
+	if (in->_opcode == OP_PHI || in->_opcode == OP_SET) {
+	    stacks[in->_value].push_back(in->_opcode == OP_PHI ? in : in->_operands[0]);
+	    pushed.push_back(in->_value);
+
+	} else if (in->_opcode == OP_GET) {
+	    if (stacks[in->_value].empty()) {
+		Instruction *zero = new Instruction(OP_CONST, in->_size);
+
+		stacks[in->_value].push_back(zero);
+		undefined.push_back(zero);
+	    }
+
+	    values[in] = stacks[in->_value].back();
+	}
+    }
+
+
+    /* Fill in the operands of the phi functions of each successor. */
+
+    for (unsigned i = 0; i < block->_successors.size(); i ++) {
+	BasicBlock *next = block->_successors[i];
+
+	for (unsigned j = 0; j < next->_predecessors.size(); j ++) {
+	    if (next->_predecessors[j] != block)
+		continue;
+
+	    for (unsigned k = 0; k < next->_instructions.size(); k ++) {
+		Instruction *phi = next->_instructions[k];
+
+		if (phi->_opcode != OP_PHI)
+		    break;
+
+		if (stacks[phi->_value].empty()) {
+		    Instruction *zero = new Instruction(OP_CONST, phi->_size);
+
+		    stacks[phi->_value].push_back(zero);
+		    undefined.push_back(zero);
+		}
+
+		phi->_operands[j] = stacks[phi->_value].back();
+	    }
+	}
+    }
+
+    for (unsigned i = 0; i < block->_children.size(); i ++)
+	rename(graph, block->_children[i], stacks, values, undefined);
+
+    for (unsigned i = 0; i < pushed.size(); i ++)
+	stacks[pushed[i]].pop_back();
+}
+
+
+/*
+ * Function:	constructSSA
+ *
+ * Description:	Put the graph in SSA form, replacing all gets and sets of
+ *		the local variables.  The blocks are first ordered and
+ *		their dominators computed.
+ */
+
+void constructSSA(Graph *graph)
+{
+    unsigned numVars = graph->_variables.size();
+    vector<BasicBlocks> frontier, sites(numVars);
+    vector<int> placed, queued;
+    vector<Instructions> stacks(numVars);
+    Instructions undefined;
+    set<Instruction *> removed;
+    Values values;
+
+
+    graph->order();
+    graph->dominators();
+    frontier = frontiers(graph);
+    placed.assign(graph->_blocks.size(), -1);
+    queued.assign(graph->_blocks.size(), -1);
+
+
+    /* Find the blocks in which each variable is set. */
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+
+	for (unsigned j = 0; j < block->_instructions.size(); j ++) {
+	    Instruction *in = block->_instructions[j];
+
+	    if (in->_opcode == OP_SET)
+		if (sites[in->_value].empty() || sites[in->_value].back() != block)
+		    sites[in->_value].push_back(block);
+	}
+    }
+
+
+    /* Place the phi functions at the iterated dominance frontiers. */
+
+    for (unsigned var = 0; var < numVars; var ++) {
+	BasicBlocks work = sites[var];
+
+	for (unsigned i = 0; i < work.size(); i ++)
+	    queued[work[i]->_number] = var;
+
+	while (!work.empty()) {
+	    BasicBlock *block = work.back();
+
+	    work.pop_back();
+
+	    for (unsigned i = 0; i < frontier[block->_number].size(); i ++) {
+		BasicBlock *join = frontier[block->_number][i];
+
+		if (placed[join->_number] == (int) var)
+		    continue;
+
+		Instruction *phi = new Instruction(OP_PHI, graph->_variables[var],
+			Instructions(join->_predecessors.size()), var);
+
+		join->insert(phi, 0);
+		placed[join->_number] = var;
+
+		if (queued[join->_number] != (int) var) {
+		    queued[join->_number] = var;
+		    work.push_back(join);
+		}
+	    }
+	}
+    }
+
+
+    /* Rename the variables, and remove the gets and sets. */
+
+    rename(graph, graph->_entry, stacks, values, undefined);
+
+    for (unsigned i = 0; i < undefined.size(); i ++)
+	graph->_entry->insert(undefined[i], 0);
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    if (instructions[j]->_opcode == OP_GET || instructions[j]->_opcode == OP_SET)
+		removed.insert(instructions[j]);
+	    else if (instructions[j]->_opcode == OP_PHI)
+		instructions[j]->_value = 0;
+	}
+    }
+
+    discard(graph, removed);
+    graph->replace(values);
+}
+
+
+/*
+ * Function:	fold (private)
+ *
+ * Description:	Compute the value of the given instruction from the values
+ *		of its operands, returning false if it cannot be computed
+ *		at compile time.  Division by zero and overflow in division
+ *		are left to happen at run time.
+ */
+
+static bool fold(const Instruction *in, const vector<long> &args, long &result)
+{
+    unsigned long a = args.size() > 0 ? args[0] : 0;
+    unsigned long b = args.size() > 1 ? args[1] : 0;
+    long x = a, y = b;
+
+
+    switch (in->_opcode) {
+    case OP_CONST:
+	result = in->_value;
+	return true;
+
+    case OP_ADD:
+	result = a + b;
+	break;
+
+    case OP_SUB:
+	result = a - b;
+	break;
+
+    case OP_MUL:
+	result = a * b;
+	break;
+
+    case OP_DIV: case OP_REM:
+	if (y == 0 || (y == -1 && x == normalize(1UL << (in->_size * 8 - 1), in->_size)))
+	    return false;
+
+	result = in->_opcode == OP_DIV ? x / y : x % y;
+	break;
+
+    case OP_NEG:
+	result = -a;
+	break;
+
+    case OP_LT: result = x < y; break;
+    case OP_GT: result = x > y; break;
+    case OP_LE: result = x <= y; break;
+    case OP_GE: result = x >= y; break;
+    case OP_EQ: result = x == y; break;
+    case OP_NE: result = x != y; break;
+
+    case OP_EXT: case OP_TRUNC: case OP_COPY:
+	result = x;
+	break;
+
+    default:
+	return false;
+    }
+
+    result = normalize(result, in->_size);
+    return true;
+}
+
+
+/*
+ * Function:	propagateConstants
+ *
+ * Description:	Perform sparse conditional constant propagation.  Each
+ *		value is either unknown (top), a known constant, or varying
+ *		(bottom).  Only the blocks reachable along edges that may
+ *		be executed are considered, so constants are found that
+ *		flow along only some paths.  Afterward, every instruction
+ *		with a constant value is replaced by the constant, and any
+ *		branch on a constant becomes a jump.
+ */
+
+enum { TOP, CONSTANT, BOTTOM };
+
+struct Lattice {
+    int state;
+    long value;
+};
+
+void propagateConstants(Graph *graph)
+{
+    map<Instruction *, Lattice> lattice;
+    map<Instruction *, Instructions> users;
+    vector<vector<bool>> edges(graph->_blocks.size());
+    vector<bool> reached(graph->_blocks.size(), false);
+    vector<pair<BasicBlock *, unsigned>> flow;
+    Instructions work;
+
+
+    /* Find the users of each value. */
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+
+	edges[i].assign(block->_successors.size(), false);
+
+	for (unsigned j = 0; j < block->_instructions.size(); j ++) {
+	    Instruction *in = block->_instructions[j];
+
+	    lattice[in].state = TOP;
+
+	    for (unsigned k = 0; k < in->_operands.size(); k ++)
+		users[in->_operands[k]].push_back(in);
+	}
+    }
+
+
+    /* Evaluate an instruction, and return whether its value changed. */
+
+    auto visit = [&](Instruction *in) {
+	BasicBlock *block = in->_block;
+	Lattice &old = lattice[in], now = {TOP, 0};
+
+
+	if (in->_opcode == OP_JUMP)
+	    flow.push_back(make_pair(block, 0));
+
+	else if (in->_opcode == OP_BRANCH) {
+	    Lattice &cond = lattice[in->_operands[0]];
+
+	    if (cond.state == BOTTOM || (cond.state == CONSTANT && cond.value != 0))
+		flow.push_back(make_pair(block, 0));
+
+	    if (cond.state == BOTTOM || (cond.state == CONSTANT && cond.value == 0))
+		flow.push_back(make_pair(block, 1));
+
+	} else if (in->_opcode == OP_PHI) {
+	    for (unsigned i = 0; i < block->_predecessors.size(); i ++) {
+		BasicBlock *pred = block->_predecessors[i];
+		bool executable = false;
+
+		for (unsigned j = 0; j < pred->_successors.size(); j ++)
+		    if (pred->_successors[j] == block && edges[pred->_number][j])
+			executable = true;
+
+		if (executable) {
+		    Lattice &arg = lattice[in->_operands[i]];
+
+		    if (arg.state == BOTTOM ||
+			    (now.state == CONSTANT && arg.state == CONSTANT &&
+			     now.value != arg.value))
+			now.state = BOTTOM;
+		    else if (now.state == TOP)
+			now = arg;
+		}
+	    }
+
+	} else if (in->isPure()) {
+	    bool top = false, bottom = false;
+	    vector<long> args;
+
+	    for (unsigned i = 0; i < in->_operands.size(); i ++) {
+		Lattice &arg = lattice[in->_operands[i]];
+
+		top = top || arg.state == TOP;
+		bottom = bottom || arg.state == BOTTOM;
+		args.push_back(arg.value);
+	    }
+
+	    if (bottom)
+		now.state = BOTTOM;
+	    else if (!top)
+		now.state = fold(in, args, now.value) ? CONSTANT : BOTTOM;
+
+	} else
+	    now.state = BOTTOM;
+
+	if (now.state != old.state || now.value != old.value) {
+	    old = now;
+	    return true;
+	}
+
+	return false;
+    };
+
+
+    /* Iterate until both worklists are empty. */
+
+    reached[0] = true;
+
+    for (unsigned i = 0; i < graph->_entry->_instructions.size(); i ++)
+	if (visit(graph->_entry->_instructions[i]))
+	    work.push_back(graph->_entry->_instructions[i]);
+
+    while (!flow.empty() || !work.empty()) {
+	if (!flow.empty()) {
+	    BasicBlock *block = flow.back().first;
+	    unsigned i = flow.back().second;
+	    BasicBlock *next = block->_successors[i];
+
+	    flow.pop_back();
+
+	    if (edges[block->_number][i])
+		continue;
+
+	    edges[block->_number][i] = true;
+
+	    for (unsigned j = 0; j < next->_instructions.size(); j ++) {
+		Instruction *in = next->_instructions[j];
+
+		if (reached[next->_number] && in->_opcode != OP_PHI)
+		    break;
+
+		if (visit(in))
+		    work.push_back(in);
+	    }
+
+	    reached[next->_number] = true;
+
+	} else {
+	    Instruction *in = work.back();
+	    Instructions &uses = users[in];
+
+	    work.pop_back();
+
+	    for (unsigned i = 0; i < uses.size(); i ++)
+		if (reached[uses[i]->_block->_number] && visit(uses[i]))
+		    work.push_back(uses[i]);
+	}
+    }
+
+
+    /* Replace the constants, and the branches on constants. */
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	BasicBlock *block = graph->_blocks[i];
+	Instructions phis, others;
+
+	if (!reached[i])
+	    continue;
+
+	for (unsigned j = 0; j < block->_instructions.size(); j ++) {
+	    Instruction *in = block->_instructions[j];
+	    Lattice &value = lattice[in];
+
+	    if (in->_opcode == OP_BRANCH && value.state != BOTTOM) {
+		Lattice &cond = lattice[in->_operands[0]];
+		unsigned taken = cond.state == CONSTANT && cond.value == 0;
+
+		if (cond.state == BOTTOM)
+		    continue;
+
+		block->_successors[1 - taken]->disconnect(block);
+		block->_successors.erase(block->_successors.begin() + 1 - taken);
+		in->_opcode = OP_JUMP;
+		in->_operands.clear();
+
+	    } else if (value.state == CONSTANT && in->_opcode != OP_CONST) {
+		in->_opcode = OP_CONST;
+		in->_value = value.value;
+		in->_operands.clear();
+	    }
+	}
+
+	/* A phi function that became a constant must follow the others. */
+
+	for (unsigned j = 0; j < block->_instructions.size(); j ++) {
+	    Instruction *in = block->_instructions[j];
+	    (in->_opcode == OP_PHI ? phis : others).push_back(in);
+	}
+
+	phis.insert(phis.end(), others.begin(), others.end());
+	block->_instructions = phis;
+    }
+
+    graph->order();
+}
+
+
+/*
+ * Function:	propagateCopies
+ *
+ * Description:	Perform copy propagation, replacing each copy by its
+ *		operand.  A phi function whose operands are all the same
+ *		value, other than itself, is also just a copy of that value.
+ */
+
+void propagateCopies(Graph *graph)
+{
+    set<Instruction *> removed;
+    Values values;
+    Values::iterator it;
+    bool changed = true;
+
+
+    while (changed) {
+	changed = false;
+
+	for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	    Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	    for (unsigned j = 0; j < instructions.size(); j ++) {
+		Instruction *in = instructions[j], *same = nullptr;
+
+		if (removed.count(in) > 0)
+		    continue;
+
+		if (in->_opcode == OP_COPY)
+		    same = in->_operands[0];
+
+		else if (in->_opcode == OP_PHI) {
+		    for (unsigned k = 0; k < in->_operands.size(); k ++) {
+			Instruction *arg = in->_operands[k];
+
+			while ((it = values.find(arg)) != values.end())
+			    arg = it->second;
+
+			if (arg == in || arg == same)
+			    continue;
+
+			if (same != nullptr) {
+			    same = nullptr;
+			    break;
+			}
+
+			same = arg;
+		    }
+		}
+
+		if (same != nullptr) {
+		    values[in] = same;
+		    removed.insert(in);
+		    changed = true;
+		}
+	    }
+	}
+    }
+
+    discard(graph, removed);
+    graph->replace(values);
+}
+
+
+/*
+ * Function:	simplify (private)
+ *
+ * Description:	Apply algebraic identities to an instruction.  Return the
+ *		value that the instruction is equivalent to, if any.  An
+ *		instruction that becomes a constant is changed in place,
+ *		which includes one whose operands have become constants
+ *		since constant propagation.  Vectors are left alone.
+ */
+
+static Instruction *simplify(Instruction *in)
+{
+    Instruction *a, *b;
+    vector<long> args;
+    long value;
+
+
+    if (in->isVector())
+	return nullptr;
+
+    for (unsigned i = 0; i < in->_operands.size(); i ++)
+	if (in->_operands[i]->_opcode == OP_CONST)
+	    args.push_back(in->_operands[i]->_value);
+
+    if (in->isPure() && !args.empty() && args.size() == in->_operands.size() &&
+	    fold(in, args, value)) {
+	in->_opcode = OP_CONST;
+	in->_value = value;
+	in->_operands.clear();
+	return nullptr;
+    }
+
+    if (in->_operands.size() != 2)
+	return nullptr;
+
+    a = in->_operands[0];
+    b = in->_operands[1];
+
+    if (in->_opcode == OP_ADD || in->_opcode == OP_MUL)
+	if (a->_opcode == OP_CONST && b->_opcode != OP_CONST)
+	    swap(a, b);
+
+    if (b->_opcode == OP_CONST && a->_size == in->_size) {
+	if (in->_opcode == OP_ADD && b->_value == 0)
+	    return a;
+
+	if (in->_opcode == OP_SUB && b->_value == 0)
+	    return a;
+
+	if ((in->_opcode == OP_MUL || in->_opcode == OP_DIV) && b->_value == 1)
+	    return a;
+    }
+
+    if ((in->_opcode == OP_MUL && b->_opcode == OP_CONST && b->_value == 0) ||
+	    (in->_opcode == OP_SUB && a == b)) {
+	in->_opcode = OP_CONST;
+	in->_value = 0;
+	in->_operands.clear();
+    }
+
+    return nullptr;
+}
+
+
+/*
+ * Function:	number (private)
+ *
+ * Description:	Perform global value numbering.  Walking the dominator
+ *		tree, each pure instruction is looked up by its operation
+ *		and operands in a table of the values available at that
+ *		point, which are exactly those computed in the dominating
+ *		blocks.  If found, the instruction is redundant.  The table
+ *		is scoped, so entries are removed on the way back up.
+ */
+
+typedef pair<vector<long>, string> Key;
+
+static void number(BasicBlock *block, map<Key, Instruction *> &table,
+	Values &values, set<Instruction *> &removed)
+{
+    vector<Key> added;
+    Values::iterator it;
+
+
+    for (unsigned i = 0; i < block->_instructions.size(); i ++) {
+	Instruction *in = block->_instructions[i], *same;
+	vector<pair<long, long>> operands;
+	Key key;
+
+	for (unsigned j = 0; j < in->_operands.size(); j ++)
+	    while ((it = values.find(in->_operands[j])) != values.end())
+		in->_operands[j] = it->second;
+
+	if ((same = simplify(in)) != nullptr) {
+	    values[in] = same;
+	    removed.insert(in);
+	    continue;
+	}
+
+	if (!in->isPure() && in->_opcode != OP_PHI)
+	    continue;
+
+	for (unsigned j = 0; j < in->_operands.size(); j ++) {
+	    Instruction *arg = in->_operands[j];
+
+	    if (arg->_opcode == OP_CONST)
+		operands.push_back(make_pair(arg->_size, arg->_value));
+	    else
+		operands.push_back(make_pair(0, arg->_number));
+	}
+
+	if (in->_opcode == OP_ADD || in->_opcode == OP_MUL ||
+		in->_opcode == OP_EQ || in->_opcode == OP_NE)
+	    sort(operands.begin(), operands.end());
+
+	key.first.push_back(in->_opcode);
+	key.first.push_back(in->_size);
+	key.first.push_back(in->_opcode == OP_PHI ? block->_number : in->_value);
+	key.second = in->_name;
+
+	for (unsigned j = 0; j < operands.size(); j ++) {
+	    key.first.push_back(operands[j].first);
+	    key.first.push_back(operands[j].second);
+	}
+
+	if (table.count(key) > 0) {
+	    values[in] = table[key];
+	    removed.insert(in);
+	} else {
+	    table[key] = in;
+	    added.push_back(key);
+	}
+    }
+
+    for (unsigned i = 0; i < block->_children.size(); i ++)
+	number(block->_children[i], table, values, removed);
+
+    for (unsigned i = 0; i < added.size(); i ++)
+	table.erase(added[i]);
+}
+
+
+/*
+ * Function:	numberValues
+ *
+ * Description:	Perform global value numbering over the entire graph.
+ */
+
+void numberValues(Graph *graph)
+{
+    map<Key, Instruction *> table;
+    set<Instruction *> removed;
+    Values values;
+
+
+    graph->dominators();
+    number(graph->_entry, table, values, removed);
+    discard(graph, removed);
+    graph->replace(values);
+}
+
+
+/*
+ * Function:	eliminateDeadCode
+ *
+ * Description:	Perform dead code elimination.  Starting with the
+ *		instructions that have an effect, we mark every instruction
+ *		whose value they use, and remove the others.
+ */
+
+void eliminateDeadCode(Graph *graph)
+{
+    set<Instruction *> live, removed;
+    Instructions work;
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    int opcode = instructions[j]->_opcode;
+
+	    if (opcode == OP_STORE || opcode == OP_CALL || instructions[j]->isTerminator()) {
+		live.insert(instructions[j]);
+		work.push_back(instructions[j]);
+	    }
+	}
+    }
+
+    while (!work.empty()) {
+	Instruction *in = work.back();
+
+	work.pop_back();
+
+	for (unsigned i = 0; i < in->_operands.size(); i ++)
+	    if (live.insert(in->_operands[i]).second)
+		work.push_back(in->_operands[i]);
+    }
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	for (unsigned j = 0; j < instructions.size(); j ++)
+	    if (live.count(instructions[j]) == 0)
+		removed.insert(instructions[j]);
+    }
+
+    discard(graph, removed);
+}
+
+
+/*
+ * Function:	redirect (private)
+ *
+ * Description:	Make each edge from one block to another go instead to a
+ *		third block.
+ */
+
+static void redirect(BasicBlock *block, BasicBlock *from, BasicBlock *to)
+{
+    for (unsigned i = 0; i < block->_successors.size(); i ++)
+	if (block->_successors[i] == from) {
+	    block->_successors[i] = to;
+	    to->_predecessors.push_back(block);
+	    from->disconnect(block);
+	}
+}
+
+
+/*
+ * Function:	simplifyGraph
+ *
+ * Description:	Simplify the flow graph.  A branch on a constant, which
+ *		value numbering may leave behind, or to the same block
+ *		either way becomes a jump, a block with only a jump is
+ *		bypassed if its target has no phi functions, and a block
+ *		with a single predecessor that jumps to it is merged into
+ *		it.
+ */
+
+void simplifyGraph(Graph *graph)
+{
+    bool changed = true;
+    unsigned taken;
+
+
+    while (changed) {
+	changed = false;
+
+	for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	    BasicBlock *block = graph->_blocks[i];
+	    Instruction *last = block->terminator();
+
+	    if (last == nullptr)
+		continue;
+
+	    if (last->_opcode == OP_BRANCH &&
+		    last->_operands[0]->_opcode == OP_CONST) {
+		taken = last->_operands[0]->_value == 0;
+		block->_successors[1 - taken]->disconnect(block);
+		block->_successors.erase(block->_successors.begin() + 1 - taken);
+		last->_opcode = OP_JUMP;
+		last->_operands.clear();
+		changed = true;
+	    }
+
+	    if (last->_opcode == OP_BRANCH &&
+		    block->_successors[0] == block->_successors[1]) {
+		block->_successors[1]->disconnect(block);
+		block->_successors.pop_back();
+		last->_opcode = OP_JUMP;
+		last->_operands.clear();
+	    }
+
+	    if (last->_opcode != OP_JUMP || block == graph->_entry)
+		continue;
+
+	    BasicBlock *next = block->_successors[0];
+
+	    if (block->_instructions.size() == 1 && next != block &&
+		    next->_instructions[0]->_opcode != OP_PHI &&
+		    !block->_predecessors.empty()) {
+		BasicBlocks preds = block->_predecessors;
+
+		for (unsigned j = 0; j < preds.size(); j ++)
+		    redirect(preds[j], block, next);
+
+		changed = true;
+	    }
+	}
+
+	for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	    BasicBlock *block = graph->_blocks[i];
+	    Instruction *last = block->terminator();
+
+	    if (last == nullptr || last->_opcode != OP_JUMP)
+		continue;
+
+	    BasicBlock *next = block->_successors[0];
+
+	    if (next == block || next == graph->_entry || next->_predecessors.size() != 1)
+		continue;
+
+	    if (next->_instructions[0]->_opcode == OP_PHI)
+		continue;
+
+	    block->_instructions.pop_back();
+
+	    for (unsigned j = 0; j < next->_instructions.size(); j ++)
+		block->append(next->_instructions[j]);
+
+	    next->_instructions.clear();
+	    block->_successors = next->_successors;
+
+	    for (unsigned j = 0; j < next->_successors.size(); j ++) {
+		BasicBlocks &preds = next->_successors[j]->_predecessors;
+		replace(preds.begin(), preds.end(), next, block);
+	    }
+
+	    next->_successors.clear();
+	    next->_predecessors.clear();
+	    changed = true;
+	}
+
+	graph->order();
+    }
+}
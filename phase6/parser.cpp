@@ -7,8 +7,17 @@
  */
 
 # include <cstdlib>
+# include <fstream>
+# include <sstream>
 # include <iostream>
+# include "assembler.h"
 # include "generator.h"
+# include "IR.h"
+# include "jit.h"
+# include "interpreter.h"
+# include "machine.h"
+# include "statistics.h"
+# include "profile.h"
 # include "checker.h"
 # include "tokens.h"
 # include "lexer.h"
@@ -19,6 +28,8 @@ static int lookahead, nexttoken;
 static string lexbuf, nextbuf;
 
 static Type returnType;
+static vector<Function *> functions;
+static unsigned numStatements;
 static Expression *expression(), *castExpression();
 static Statement *statement();
 
@@ -282,15 +293,12 @@ static Expression *primaryExpression()
 	match('(');
 	expr = expression();
 	match(')');
-
     } else if (lookahead == STRING) {
 	expr = new String(lexbuf);
 	match(STRING);
-
     } else if (lookahead == NUM) {
 	expr = new Number(lexbuf);
 	match(NUM);
-
     } else if (lookahead == ID) {
 	symbol = checkIdentifier(identifier());
 
@@ -375,22 +383,18 @@ static Expression *unaryExpression()
 	match('!');
 	expr = castExpression();
 	expr = checkNot(expr);
-
     } else if (lookahead == '-') {
 	match('-');
 	expr = castExpression();
 	expr = checkNegate(expr);
-
     } else if (lookahead == '*') {
 	match('*');
 	expr = castExpression();
 	expr = checkDereference(expr);
-
     } else if (lookahead == '&') {
 	match('&');
 	expr = castExpression();
 	expr = checkAddress(expr);
-
     } else if (lookahead == SIZEOF) {
 	match(SIZEOF);
 
@@ -719,8 +723,11 @@ static Statement *statement()
     Statements stmts;
     Expression *expr;
     Statement *stmt;
+    unsigned line = lineno;
 
 
+    numStatements ++;
+
     if (lookahead == '{') {
 	match('{');
 	decls = openScope();
@@ -728,28 +735,21 @@ static Statement *statement()
 	stmts = statements();
 	closeScope();
 	match('}');
-	return new Block(decls, stmts);
-    }
-    
-    if (lookahead == RETURN) {
+	stmt = new Block(decls, stmts);
+    } else if (lookahead == RETURN) {
 	match(RETURN);
 	expr = expression();
 	checkReturn(expr, returnType);
 	match(';');
-	return new Return(expr);
-    }
-    
-    if (lookahead == WHILE) {
+	stmt = new Return(expr);
+    } else if (lookahead == WHILE) {
 	match(WHILE);
 	match('(');
 	expr = expression();
 	checkTest(expr);
 	match(')');
-	stmt = statement();
-	return new While(expr, stmt);
-    }
-    
-    if (lookahead == IF) {
+	stmt = new While(expr, statement());
+    } else if (lookahead == IF) {
 	match(IF);
 	match('(');
 	expr = expression();
@@ -758,21 +758,24 @@ static Statement *statement()
 	stmt = statement();
 
 	if (lookahead != ELSE)
-	    return new If(expr, stmt, nullptr);
-
-	match(ELSE);
-	return new If(expr, stmt, statement());
-    }
+	    stmt = new If(expr, stmt, nullptr);
+	else {
+	    match(ELSE);
+	    stmt = new If(expr, stmt, statement());
+	}
+    } else {
+	expr = expression();
 
-    expr = expression();
+	if (lookahead == '=') {
+	    match('=');
+	    stmt = checkAssignment(expr, expression());
+	} else
+	    stmt = expr;
 
-    if (lookahead == '=') {
-	match('=');
-	stmt = checkAssignment(expr, expression());
-    } else
-	stmt = expr;
+	match(';');
+    }
 
-    match(';');
+    stmt->_line = line;
     return stmt;
 }
 
@@ -866,7 +869,6 @@ static void globalDeclarator(int typespec)
 	match('(');
 	declareFunction(name, Type(typespec, indirection, nullptr));
 	match(')');
-
     } else if (lookahead == '[') {
 	match('[');
 	declareVariable(name, Type(typespec, indirection, number()));
@@ -917,13 +919,18 @@ static void globalOrFunction()
     Statements stmts;
     Parameters *params;
     Function *function;
-    unsigned indirection;
+    unsigned indirection, line;
     int typespec;
     string name;
+    Instant start;
 
 
+    if (timeTrace)
+	start = now();
+
     typespec = specifier();
     indirection = pointers();
+    line = lineno;
     name = identifier();
 
     if (lookahead == '[') {
@@ -931,7 +938,6 @@ static void globalOrFunction()
 	declareVariable(name, Type(typespec, indirection, number()));
 	match(']');
 	remainingDeclarators(typespec);
-
     } else if (lookahead == '(') {
 	match('(');
 
@@ -948,14 +954,19 @@ static void globalOrFunction()
 	    match(')');
 	    match('{');
 	    declarations();
+	    numStatements = 0;
 	    stmts = statements();
 	    closeScope();
 	    match('}');
 
 	    function = new Function(symbol, new Block(decls, stmts));
+	    function->_line = line;
+	    functions.push_back(function);
 
-	    if (numerrors == 0)
-		function->generate();
+	    if (timeTrace) {
+		countStatements(name, numStatements);
+		trace("parse/check", start, name);
+	    }
 	}
 
     } else {
@@ -965,20 +976,291 @@ static void globalOrFunction()
 }
 
 
+/*
+ * Function:	generateFunctions (private)
+ *
+ * Description:	Generate code for the function definitions, which are kept
+ *		until the end of the translation unit, so that the pass
+ *		manager can run each pass over all of them.  When
+ *		optimizing, all the flow graphs are thus built first, and
+ *		calls to small functions can be inlined before each flow
+ *		graph is optimized and written as assembly code.  With a
+ *		profile, the functions entered most often are placed first.
+ */
+
+static void generateFunctions()
+{
+    if (numerrors > 0)
+	return;
+
+    orderFunctions(functions);
+    runPasses(functions);
+    generateProfile(functions);
+}
+
+
+/*
+ * Function:	usage (private)
+ *
+ * Description:	Report the command line usage and terminate.
+ */
+
+static void usage(const string &arg)
+{
+    cerr << "scc: unrecognized option '" << arg << "'" << endl;
+    cerr << "usage: scc [-O0 | -O1 | -O2] [-mavx2] [-fno-vectorize]";
+    cerr << " [-fomit-frame-pointer]" << endl;
+    cerr << "           [-march=x86-64[-v2|-v3|-v4]] [--target=triple]" << endl;
+    cerr << "           [-fpass | -fno-pass] [-fdump-ir] [-g] [-c] [-o file] [file]" << endl;
+    cerr << "           [-ftime-report[=json]] [-fmem-report[=json]]";
+    cerr << " [-ftime-trace[=file]]" << endl;
+    cerr << "           [-fprofile-generate[=file] | -fprofile-use[=file]]" << endl;
+    cerr << "       scc [options] --run file [args]" << endl;
+    cerr << "       scc --interp file [args]" << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	create (private)
+ *
+ * Description:	Create the given output file, or report that we cannot
+ *		and terminate.
+ */
+
+static void create(ofstream &file, const string &name)
+{
+    file.open(name.c_str(), ios::out | ios::binary);
+
+    if (!file) {
+	cerr << "scc: cannot open '" << name << "'" << endl;
+	exit(EXIT_FAILURE);
+    }
+}
+
+
 /*
  * Function:	main
  *
- * Description:	Analyze the standard input stream.
+ * Description:	Analyze the standard input stream, or the given source
+ *		file.  By default, the generated assembly code is written
+ *		to the standard output.  With -c, it is instead assembled
+ *		directly into an object file, which is not created if
+ *		there are errors.  With --run, it is assembled into memory
+ *		and executed with any remaining arguments.
+ *		With --interp, no code is generated: the functions are
+ *		instead interpreted, which starts a short program sooner.
+ *		With -O1, each function is optimized using the SSA form
+ *		intermediate representation before generating code, calls
+ *		to small leaf functions are inlined, and simple loops are
+ *		vectorized using SSE2, or AVX2 with -mavx2 or an -march
+ *		level that has it.  With -O2, the scalar optimizations are
+ *		repeated after those of the loops.  Each optional pass may
+ *		also be enabled or disabled by name.  With
+ *		-fprofile-generate, the program counts how often its code
+ *		runs, and with -fprofile-use, those counts guide the
+ *		layout of the code and the inlining of calls.  With -g,
+ *		the source lines and stack frames are described to the
+ *		debugger and profiler.  With --target, the assembly code
+ *		is written for another system than the host.  With
+ *		-ftime-report and -fmem-report, the time taken by each
+ *		phase and the objects created are reported, and with
+ *		-ftime-trace, the work on each function is traced.
  */
 
-int main()
+int main(int argc, char *argv[])
 {
+    string input, output;
+    bool assembleOnly = false, execute = false, interpreted = false;
+    int first = argc;
+    stringstream assembly;
+    ifstream source;
+    ofstream target;
+    streambuf *saved;
+    Instant start;
+
+
+    for (int i = 1; i < argc; i ++) {
+	string arg = argv[i];
+
+	if (arg == "--run" && i + 1 < argc) {
+	    execute = true;
+	    input = argv[first = i + 1];
+	    break;
+
+	} else if (arg == "--interp" && i + 1 < argc) {
+	    interpreted = true;
+	    input = argv[first = i + 1];
+	    profileGenerate.clear();
+	    break;
+
+	} else if (arg == "-c")
+	    assembleOnly = true;
+	else if (arg == "-O0" || arg == "-O1" || arg == "-O2")
+	    optimization = arg[2] - '0';
+	else if (arg == "-ftime-report" || arg == "-ftime-report=json") {
+	    timeReport = true;
+	    jsonReport |= arg != "-ftime-report";
+	} else if (arg == "-fmem-report" || arg == "-fmem-report=json") {
+	    memReport = true;
+	    jsonReport |= arg != "-fmem-report";
+	} else if (arg == "-ftime-trace" || arg.compare(0, 13, "-ftime-trace=") == 0) {
+	    timeTrace = true;
+	    traceFile = arg.substr(arg.size() > 12 ? 13 : 12);
+	} else if (arg == "-mavx2")
+	    vectorSize = 32;
+	else if (arg == "-march=x86-64" || arg == "-march=x86-64-v2")
+	    vectorSize = 16;
+	else if (arg == "-march=x86-64-v3" || arg == "-march=x86-64-v4")
+	    vectorSize = 32;
+	else if (arg.compare(0, 9, "--target=") == 0 && selectTarget(arg.substr(9)))
+	    continue;
+	else if (arg == "-fno-vectorize")
+	    vectorizeLoops = false;
+	else if (arg == "-fomit-frame-pointer")
+	    framePointer = false;
+	else if (arg == "-g")
+	    debugInfo = true;
+	else if (arg == "-fprofile-generate")
+	    profileGenerate = "prof.data";
+	else if (arg == "-fprofile-use")
+	    profileUse = "prof.data";
+	else if (arg.compare(0, 19, "-fprofile-generate=") == 0)
+	    profileGenerate = arg.substr(19);
+	else if (arg.compare(0, 14, "-fprofile-use=") == 0)
+	    profileUse = arg.substr(14);
+	else if (arg.compare(0, 5, "-fno-") == 0 && enablePass(arg.substr(5), false))
+	    continue;
+	else if (arg.compare(0, 2, "-f") == 0 && enablePass(arg.substr(2), true))
+	    continue;
+	else if (arg == "-o" && i + 1 < argc)
+	    output = argv[++ i];
+	else if (arg[0] == '-' && arg.size() > 1)
+	    usage(arg);
+	else
+	    input = arg;
+    }
+
+    if ((assembleOnly || execute) && !elf_target) {
+	cerr << "scc: only ELF objects can be assembled" << endl;
+	exit(EXIT_FAILURE);
+    }
+
+    if (!input.empty()) {
+	source.open(input.c_str());
+
+	if (!source) {
+	    cerr << "scc: cannot open '" << input << "'" << endl;
+	    exit(EXIT_FAILURE);
+	}
+
+	cin.rdbuf(source.rdbuf());
+    }
+
+    if (assembleOnly && output.empty()) {
+	output = input.substr(input.rfind('/') + 1);
+	output = output.substr(0, output.rfind('.')) + ".o";
+
+	if (input.empty())
+	    output = "a.o";
+    }
+
+    if (timeTrace && traceFile.empty()) {
+	traceFile = input.substr(input.rfind('/') + 1);
+	traceFile = traceFile.substr(0, traceFile.rfind('.')) + ".json";
+
+	if (input.empty())
+	    traceFile = "a.json";
+    }
+
+    if (!output.empty() && !assembleOnly)
+	create(target, output);
+
+    saved = cout.rdbuf(assembleOnly || execute ? assembly.rdbuf() :
+	    !output.empty() ? target.rdbuf() : cout.rdbuf());
+
+    if (memReport)
+	cout.rdbuf(countInstructions(cout.rdbuf()));
+
+    generateFile(input);
     openScope();
+
+    if (timeReport || timeTrace)
+	start = now();
+
     lookahead = lexan(lexbuf);
 
     while (lookahead != DONE)
 	globalOrFunction();
 
+    finish(PARSING, start);
+
+    if (interpreted) {
+	cout.rdbuf(saved);
+
+	if (numerrors > 0)
+	    exit(EXIT_FAILURE);
+
+	exit(interpret(functions, closeScope(), argc - first, argv + first));
+    }
+
+    generateFunctions();
+
+    if (timeReport || timeTrace)
+	start = now();
+
     generateGlobals(closeScope());
+    cout.flush();
+    cout.rdbuf(saved);
+
+    finish(OUTPUT, start);
+
+    if (assembleOnly) {
+	Object object;
+
+	if (numerrors > 0)
+	    exit(EXIT_FAILURE);
+
+	if (timeReport || timeTrace)
+	    start = now();
+
+	assemble(assembly, object);
+	create(target, output);
+	writeObject(object, target);
+
+	finish(ASSEMBLING, start);
+    }
+
+    if (execute) {
+	Object object;
+
+	if (numerrors > 0)
+	    exit(EXIT_FAILURE);
+
+	if (timeReport || timeTrace)
+	    start = now();
+
+	assemble(assembly, object);
+
+	finish(ASSEMBLING, start);
+
+	if (timeReport || memReport)
+	    reportStatistics();
+
+	if (timeTrace)
+	    writeTrace();
+
+	exit(run(object, argc - first, argv + first));
+    }
+
+    if (target.is_open())
+	target.close();
+
+    if ((timeReport || memReport) && numerrors == 0)
+	reportStatistics();
+
+    if (timeTrace && numerrors == 0)
+	writeTrace();
+
     exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,376 @@
+/*
+ * File:	passes.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for the pass manager, which runs the passes of
+ *		the compiler over the functions of a translation unit.
+ *
+ *		Each pass works on either the abstract syntax tree of a
+ *		function, all the flow graphs at once, or one flow graph at
+ *		a time.  The pipeline lists every pass in the order in
+ *		which they run, along with the optimization levels that run
+ *		it by default.  Without optimization, code is generated
+ *		directly from the tree.  Otherwise, the flow graphs are
+ *		built, optimized, and written as assembly code, with -O2
+ *		repeating the scalar optimizations once the loops have been
+ *		optimized.
+ *
+ *		Any optional pass may be enabled with -fname or disabled
+ *		with -fno-name, which affects every occurrence of the pass
+ *		in the pipeline.  Unless compiled with NDEBUG, the flow
+ *		graphs are verified before each pass, so that a pass that
+ *		leaves them inconsistent is caught right away.  With
+ *		-ftime-report, the time taken by each pass and the change
+ *		it made to the size of the flow graphs are recorded.  With
+ *		-ftime-trace, each pass is traced, and so is its work on
+ *		each function, except for the passes over all the graphs
+ *		at once.
+ */
+
+# include <map>
+# include <set>
+# include <algorithm>
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <iostream>
+# include "Tree.h"
+# include "IR.h"
+# include "statistics.h"
+
+# define O0 1
+# define O1 2
+# define O2 4
+
+using namespace std;
+
+unsigned optimization = 0;
+
+struct Pass {
+    const char *name;
+    unsigned levels;
+    bool optional;
+    void (*tree)(Function *function);
+    void (*module)(const vector<Graph *> &graphs);
+    void (*graph)(Graph *graph);
+};
+
+static void generate(Function *function);
+static void build(Function *function);
+static void dumpGraph(Graph *graph);
+
+static Pass pipeline[] = {
+    {"generate", O0, false, generate, nullptr, nullptr},
+    {"build", O1 | O2, false, build, nullptr, nullptr},
+    {"inline", O1 | O2, true, nullptr, inlineCalls, nullptr},
+    {"ssa", O1 | O2, false, nullptr, nullptr, constructSSA},
+    {"ccp", O1 | O2, true, nullptr, nullptr, propagateConstants},
+    {"copy-prop", O1 | O2, true, nullptr, nullptr, propagateCopies},
+    {"gvn", O1 | O2, true, nullptr, nullptr, numberValues},
+    {"dce", O1 | O2, true, nullptr, nullptr, eliminateDeadCode},
+    {"loops", O1 | O2, true, nullptr, nullptr, optimizeLoops},
+    {"ccp", O2, true, nullptr, nullptr, propagateConstants},
+    {"copy-prop", O2, true, nullptr, nullptr, propagateCopies},
+    {"gvn", O1 | O2, true, nullptr, nullptr, numberValues},
+    {"dce", O1 | O2, true, nullptr, nullptr, eliminateDeadCode},
+    {"simplify-cfg", O1 | O2, true, nullptr, nullptr, simplifyGraph},
+    {"dump-ir", 0, true, nullptr, nullptr, dumpGraph},
+    {"emit", O1 | O2, false, nullptr, nullptr, emit},
+};
+
+static const unsigned numPasses = sizeof(pipeline) / sizeof(pipeline[0]);
+static map<string, bool> overrides;
+
+
+/*
+ * Function:	generate (private)
+ *
+ * Description:	Generate code for a function directly from its tree.
+ */
+
+static void generate(Function *function)
+{
+    function->generate();
+}
+
+
+/*
+ * Function:	build (private)
+ *
+ * Description:	Build the flow graph for a function from its tree.
+ */
+
+static void build(Function *function)
+{
+    function->build();
+}
+
+
+/*
+ * Function:	dumpGraph (private)
+ *
+ * Description:	Write a flow graph to the standard error for debugging.
+ */
+
+static void dumpGraph(Graph *graph)
+{
+    dump(graph, cerr);
+}
+
+
+/*
+ * Function:	enablePass
+ *
+ * Description:	Enable or disable every occurrence of the named pass,
+ *		regardless of the optimization level.  Only the optional
+ *		passes may be named.
+ */
+
+bool enablePass(const string &name, bool enabled)
+{
+    for (unsigned i = 0; i < numPasses; i ++)
+	if (pipeline[i].optional && name == pipeline[i].name) {
+	    overrides[name] = enabled;
+	    return true;
+	}
+
+    return false;
+}
+
+
+/*
+ * Function:	isEnabled (private)
+ *
+ * Description:	Return whether a pass runs at the current optimization
+ *		level, taking into account the command line.
+ */
+
+static bool isEnabled(const Pass &pass)
+{
+    map<string, bool>::iterator it = overrides.find(pass.name);
+    bool graphs = (pass.levels & O0) == 0;
+
+
+    /* The command line overrides the level, but without optimization
+       there are no flow graphs on which to run a pass. */
+
+    if (it != overrides.end() && graphs == (optimization > 0))
+	return it->second;
+
+    return (pass.levels & (1 << optimization)) != 0;
+}
+
+
+/*
+ * Function:	size (private)
+ *
+ * Description:	Compute the number of blocks and instructions in the given
+ *		flow graphs.
+ */
+
+static void size(const vector<Graph *> &graphs, long &blocks, long &instructions)
+{
+    blocks = instructions = 0;
+
+    for (unsigned i = 0; i < graphs.size(); i ++)
+	for (unsigned j = 0; j < graphs[i]->_blocks.size(); j ++) {
+	    blocks ++;
+	    instructions += graphs[i]->_blocks[j]->_instructions.size();
+	}
+}
+
+
+# ifndef NDEBUG
+
+/*
+ * Function:	verify (private)
+ *
+ * Description:	Check that a flow graph is consistent before running the
+ *		given pass, and if not, report the problem and abort.  Each
+ *		block must end with its only terminator, have as many
+ *		successors as the terminator has targets, and appear among
+ *		the predecessors of each of its successors.  The phi
+ *		functions must come first in a block, with one operand for
+ *		each predecessor, and every operand must be defined by an
+ *		instruction in the graph.  A block that cannot be reached
+ *		is ignored, as it is removed once the graph is ordered.
+ */
+
+static void verify(const Graph *graph, const char *pass)
+{
+    set<const Instruction *> defined;
+    string problem;
+    unsigned targets;
+
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	const Instructions &instructions = graph->_blocks[i]->_instructions;
+	defined.insert(instructions.begin(), instructions.end());
+    }
+
+    for (unsigned i = 0; i < graph->_blocks.size() && problem.empty(); i ++) {
+	const BasicBlock *block = graph->_blocks[i];
+	const Instructions &instructions = block->_instructions;
+
+	if (block != graph->_entry && block->_predecessors.empty())
+	    continue;
+
+	if (instructions.empty() || !instructions.back()->isTerminator()) {
+	    problem = "block without terminator";
+	    break;
+	}
+
+	targets = instructions.back()->_opcode == OP_JUMP ? 1 :
+	    instructions.back()->_opcode == OP_BRANCH ? 2 : 0;
+
+	if (block->_successors.size() != targets)
+	    problem = "wrong number of successors";
+
+	for (unsigned j = 0; j < block->_successors.size(); j ++) {
+	    const BasicBlocks &preds = block->_successors[j]->_predecessors;
+
+	    if (find(preds.begin(), preds.end(), block) == preds.end())
+		problem = "successor without predecessor";
+	}
+
+	for (unsigned j = 0; j < instructions.size(); j ++) {
+	    const Instruction *in = instructions[j];
+
+	    if (in->isTerminator() && j + 1 < instructions.size())
+		problem = "terminator within block";
+
+	    if (in->_opcode == OP_PHI) {
+		if (j > 0 && instructions[j - 1]->_opcode != OP_PHI)
+		    problem = "phi function after other instructions";
+
+		if (in->_operands.size() != block->_predecessors.size())
+		    problem = "phi function without operand for each predecessor";
+	    }
+
+	    for (unsigned k = 0; k < in->_operands.size(); k ++)
+		if (defined.count(in->_operands[k]) == 0)
+		    problem = "operand not defined in graph";
+	}
+    }
+
+    if (!problem.empty()) {
+	cerr << "scc: invalid flow graph for '" << graph->_id->name();
+	cerr << "' before " << pass << ": " << problem << endl;
+	abort();
+    }
+}
+
+# endif
+
+
+/*
+ * Function:	runTree (private)
+ *
+ * Description:	Run a pass over the tree of a function, tracing it if
+ *		asked.  Generating code directly from the tree lays out the
+ *		frame of the function.
+ */
+
+static void runTree(const Pass &pass, Function *function)
+{
+    Instant start;
+
+
+    if (!timeTrace) {
+	pass.tree(function);
+	return;
+    }
+
+    start = now();
+    pass.tree(function);
+    trace(pass.name, start, function->id()->name(),
+	strcmp(pass.name, "generate") == 0);
+}
+
+
+/*
+ * Function:	runGraph (private)
+ *
+ * Description:	Run a pass over a flow graph, tracing it if asked.
+ *		Emitting the graph lays out the frame of the function.
+ */
+
+static void runGraph(const Pass &pass, Graph *graph)
+{
+    Instant start;
+
+
+    if (!timeTrace) {
+	pass.graph(graph);
+	return;
+    }
+
+    start = now();
+    pass.graph(graph);
+    trace(pass.name, start, graph->_id->name(), strcmp(pass.name, "emit") == 0);
+}
+
+
+/*
+ * Function:	runPasses
+ *
+ * Description:	Run the enabled passes of the pipeline over the given
+ *		functions.  A pass over the flow graphs finishes with every
+ *		graph before the next pass begins.
+ */
+
+void runPasses(const vector<Function *> &functions)
+{
+    Instant start;
+    Timing allocating, timing;
+    long oldBlocks = 0, oldInstructions = 0, newBlocks, newInstructions;
+    vector<Graph *> graphs;
+
+
+    for (unsigned i = 0; i < numPasses; i ++) {
+	const Pass &pass = pipeline[i];
+
+	if (!isEnabled(pass))
+	    continue;
+
+# ifndef NDEBUG
+	for (unsigned j = 0; j < graphs.size(); j ++)
+	    verify(graphs[j], pass.name);
+# endif
+
+	if (timeReport || timeTrace) {
+	    start = now();
+	    allocating = phaseTimes[ALLOCATING];
+	}
+
+	if (pass.tree != nullptr)
+	    for (unsigned j = 0; j < functions.size(); j ++)
+		runTree(pass, functions[j]);
+	else if (pass.module != nullptr)
+	    pass.module(graphs);
+	else
+	    for (unsigned j = 0; j < graphs.size(); j ++)
+		runGraph(pass, graphs[j]);
+
+	if (pass.tree == build)
+	    for (unsigned j = 0; j < functions.size(); j ++)
+		graphs.push_back(functions[j]->flowGraph());
+
+	if (timeReport) {
+	    timing = Timing {pass.name};
+	    charge(timing, start);
+	    timing.wall -= phaseTimes[ALLOCATING].wall - allocating.wall;
+	    timing.cpu -= phaseTimes[ALLOCATING].cpu - allocating.cpu;
+
+	    size(graphs, newBlocks, newInstructions);
+	    timing.blocks = newBlocks - oldBlocks;
+	    timing.instructions = newInstructions - oldInstructions;
+	    oldBlocks = newBlocks;
+	    oldInstructions = newInstructions;
+	    passTimes.push_back(timing);
+	}
+
+	if (timeTrace)
+	    trace(pass.name, start);
+    }
+}
@@ -0,0 +1,288 @@
+/*
+ * File:	profile.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for profile-guided optimization.
+ *
+ *		With -fprofile-generate, each function gets an array of
+ *		counters in the .bss section: one for its entry, one for
+ *		each call it makes, and two for each if statement (reached
+ *		and then taken) and each while statement (entered and body
+ *		executed).  The code generators increment the counters, and
+ *		a small routine placed in the .fini_array section appends
+ *		them to the profile when the program ends.  Each line of the
+ *		profile holds the name of a function, its checksum, the
+ *		number of counters, and then the counters.
+ *
+ *		With -fprofile-use, the profile is read back, summing the
+ *		lines from several runs.  The counts for a function are
+ *		used only if its checksum still matches, so that editing
+ *		one function leaves the profile of the others valid.
+ */
+
+# include <map>
+# include <fstream>
+# include <sstream>
+# include <iostream>
+# include <algorithm>
+# include "machine.h"
+# include "profile.h"
+
+using namespace std;
+
+typedef pair<unsigned long, Counts> Entry;
+
+string profileGenerate, profileUse;
+
+static map<string, Entry> entries;
+static bool loaded;
+
+
+/*
+ * Function:	counter
+ *
+ * Description:	Return the memory operand for the given counter of the
+ *		named function.
+ */
+
+string counter(const string &name, unsigned probe)
+{
+    stringstream ss;
+
+    ss << label_prefix << "prof_" << name;
+
+    if (probe > 0)
+	ss << "+" << probe * SIZEOF_LONG;
+
+    ss << global_suffix;
+    return ss.str();
+}
+
+
+/*
+ * Function:	load (private)
+ *
+ * Description:	Read the profile, adding together the counts for any
+ *		function with the same checksum that appears more than once.
+ */
+
+static void load()
+{
+    ifstream file(profileUse.c_str());
+    unsigned long checksum, count;
+    string line, name;
+    unsigned size;
+
+
+    loaded = true;
+
+    if (!file) {
+	cerr << "scc: warning: cannot open profile '" << profileUse << "'" << endl;
+	return;
+    }
+
+    while (getline(file, line)) {
+	istringstream fields(line);
+
+	if (!(fields >> name >> checksum >> size))
+	    continue;
+
+	Entry &entry = entries[name];
+
+	if (entry.second.size() != size || entry.first != checksum)
+	    entry = Entry(checksum, Counts(size));
+
+	for (unsigned i = 0; i < size && fields >> count; i ++)
+	    entry.second[i] += count;
+    }
+}
+
+
+/*
+ * Function:	profile
+ *
+ * Description:	Return the counts for the given function, or a null
+ *		pointer if there is no profile for it, or it is stale.
+ */
+
+const Counts *profile(const Function *function)
+{
+    map<string, Entry>::iterator it;
+    const string &name = function->id()->name();
+
+
+    if (profileUse.empty())
+	return nullptr;
+
+    if (!loaded)
+	load();
+
+    it = entries.find(name);
+
+    if (it == entries.end())
+	return nullptr;
+
+    if (it->second.first != function->checksum() ||
+	    it->second.second.size() != function->probes()) {
+	cerr << "scc: warning: profile for '" << name;
+	cerr << "' does not match the source and is ignored" << endl;
+	entries.erase(it);
+	return nullptr;
+    }
+
+    return &it->second.second;
+}
+
+
+/*
+ * Function:	isRare
+ *
+ * Description:	Return whether code executed the given number of times out
+ *		of the total is rare enough to be moved out of the way of
+ *		the code usually executed, which costs an extra jump.
+ */
+
+bool isRare(unsigned long count, unsigned long total)
+{
+    return count * RARITY < total;
+}
+
+
+/*
+ * Function:	isHotter (private)
+ *
+ * Description:	Return whether the first function is entered more often
+ *		than the second, according to the profile.
+ */
+
+static bool isHotter(const Function *first, const Function *second)
+{
+    const Counts *a = profile(first), *b = profile(second);
+
+    return (a != nullptr ? (*a)[0] : 0) > (b != nullptr ? (*b)[0] : 0);
+}
+
+
+/*
+ * Function:	orderFunctions
+ *
+ * Description:	Sort the functions so that the most frequently entered
+ *		come first, which packs the hot code together, and those
+ *		never entered come last.  Otherwise, the order is kept.
+ */
+
+void orderFunctions(vector<Function *> &functions)
+{
+    if (!profileUse.empty())
+	stable_sort(functions.begin(), functions.end(), isHotter);
+}
+
+
+/*
+ * Function:	generateProfile
+ *
+ * Description:	Generate the counters of each function, a table that
+ *		describes them, and the code to write them to the profile.
+ *		The table has an entry of four quadwords for each function
+ *		(its name, checksum, number of counters, and counters) and
+ *		ends with a null name.
+ */
+
+void generateProfile(const vector<Function *> &functions)
+{
+    Label table, dump, record, next, close, done, path, mode, header, value;
+    vector<Label> names(functions.size());
+
+
+    if (profileGenerate.empty())
+	return;
+
+    cout << "\t.bss" << endl;
+
+    for (unsigned i = 0; i < functions.size(); i ++) {
+	cout << "\t.p2align\t3" << endl;
+	cout << label_prefix << "prof_" << functions[i]->id()->name() << ":" << endl;
+	cout << "\t.zero\t" << functions[i]->probes() * SIZEOF_LONG << endl;
+    }
+
+    cout << "\t.data" << endl;
+    cout << "\t.p2align\t3" << endl;
+    cout << table << ":" << endl;
+
+    for (unsigned i = 0; i < functions.size(); i ++) {
+	cout << "\t.quad\t" << names[i] << endl;
+	cout << "\t.quad\t" << (long) functions[i]->checksum() << endl;
+	cout << "\t.quad\t" << functions[i]->probes() << endl;
+	cout << "\t.quad\t" << label_prefix << "prof_" << functions[i]->id()->name() << endl;
+    }
+
+    cout << "\t.quad\t0" << endl;
+
+    for (unsigned i = 0; i < functions.size(); i ++)
+	cout << names[i] << ":\t.asciz\t\"" << functions[i]->id()->name() << "\"" << endl;
+
+    cout << path << ":\t.asciz\t\"" << profileGenerate << "\"" << endl;
+    cout << mode << ":\t.asciz\t\"a\"" << endl;
+    cout << header << ":\t.asciz\t\"%s %lu %lu\"" << endl;
+    cout << value << ":\t.asciz\t\" %lu\"" << endl;
+
+
+    /* The routine to append the counters to the profile, with the file
+       in %r12, the table entry in %rbx, and the counter in %r13. */
+
+    cout << "\t.text" << endl;
+    cout << dump << ":" << endl;
+    cout << "\tpushq\t%rbx" << endl;
+    cout << "\tpushq\t%r12" << endl;
+    cout << "\tpushq\t%r13" << endl;
+    cout << "\tleaq\t" << path << global_suffix << ", %rdi" << endl;
+    cout << "\tleaq\t" << mode << global_suffix << ", %rsi" << endl;
+    cout << "\tcall\t" << global_prefix << "fopen" << endl;
+    cout << "\ttestq\t%rax, %rax" << endl;
+    cout << "\tje\t" << done << endl;
+    cout << "\tmovq\t%rax, %r12" << endl;
+    cout << "\tleaq\t" << table << global_suffix << ", %rbx" << endl;
+
+    cout << record << ":" << endl;
+    cout << "\tcmpq\t$0, (%rbx)" << endl;
+    cout << "\tje\t" << close << endl;
+    cout << "\tmovq\t%r12, %rdi" << endl;
+    cout << "\tleaq\t" << header << global_suffix << ", %rsi" << endl;
+    cout << "\tmovq\t(%rbx), %rdx" << endl;
+    cout << "\tmovq\t8(%rbx), %rcx" << endl;
+    cout << "\tmovq\t16(%rbx), %r8" << endl;
+    cout << "\tmovl\t$0, %eax" << endl;
+    cout << "\tcall\t" << global_prefix << "fprintf" << endl;
+    cout << "\tmovl\t$0, %r13d" << endl;
+
+    cout << next << ":" << endl;
+    cout << "\tmovq\t%r12, %rdi" << endl;
+    cout << "\tleaq\t" << value << global_suffix << ", %rsi" << endl;
+    cout << "\tmovq\t24(%rbx), %rdx" << endl;
+    cout << "\tmovq\t(%rdx,%r13,8), %rdx" << endl;
+    cout << "\tmovl\t$0, %eax" << endl;
+    cout << "\tcall\t" << global_prefix << "fprintf" << endl;
+    cout << "\taddq\t$1, %r13" << endl;
+    cout << "\tcmpq\t16(%rbx), %r13" << endl;
+    cout << "\tjl\t" << next << endl;
+
+    cout << "\tmovl\t$10, %edi" << endl;
+    cout << "\tmovq\t%r12, %rsi" << endl;
+    cout << "\tcall\t" << global_prefix << "fputc" << endl;
+    cout << "\taddq\t$32, %rbx" << endl;
+    cout << "\tjmp\t" << record << endl;
+
+    cout << close << ":" << endl;
+    cout << "\tmovq\t%r12, %rdi" << endl;
+    cout << "\tcall\t" << global_prefix << "fclose" << endl;
+    cout << done << ":" << endl;
+    cout << "\tpopq\t%r13" << endl;
+    cout << "\tpopq\t%r12" << endl;
+    cout << "\tpopq\t%rbx" << endl;
+    cout << "\tret" << endl << endl;
+
+    cout << "\t.section\t.fini_array,\"aw\"" << endl;
+    cout << "\t.p2align\t3" << endl;
+    cout << "\t.quad\t" << dump << endl;
+    cout << "\t.text" << endl;
+}
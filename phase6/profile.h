@@ -0,0 +1,27 @@
+/*
+ * File:	profile.h
+ *
+ * Description:	This file contains the function declarations for
+ *		instrumenting a program to count how often its code runs,
+ *		and for reading those counts back to guide the compiler.
+ */
+
+# ifndef PROFILE_H
+# define PROFILE_H
+# include <string>
+# include <vector>
+# include "Tree.h"
+
+# define RARITY 4
+
+typedef std::vector<unsigned long> Counts;
+
+extern std::string profileGenerate, profileUse;
+
+std::string counter(const std::string &name, unsigned probe);
+const Counts *profile(const Function *function);
+bool isRare(unsigned long count, unsigned long total);
+void orderFunctions(std::vector<Function *> &functions);
+void generateProfile(const std::vector<Function *> &functions);
+
+# endif /* PROFILE_H */
@@ -0,0 +1,662 @@
+/*
+ * File:	statistics.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for measuring the costs of the compiler itself.
+ *
+ *		With -ftime-report, the wall-clock and processor time of
+ *		each phase and pass is reported.  The phases are timed
+ *		where they start and finish, except for lexing, which is
+ *		interleaved with parsing one token at a time.  Reading the
+ *		processor time is a system call, too slow to make for every
+ *		token, so lexing is timed only by the clock, and its share
+ *		of the processor time of parsing is taken to be the same as
+ *		its share of the wall-clock time.  The time taken to
+ *		allocate the frames and registers is reported as a phase of
+ *		its own, rather than as part of the pass during which it
+ *		happens.
+ *
+ *		With -fmem-report, the numbers of tokens, tree nodes of each
+ *		class, symbols, scopes, types, labels, flow graph
+ *		instructions and blocks, spilled values, and emitted
+ *		instructions are reported, along with the bytes taken by
+ *		the objects of each kind.  The bytes are those of the
+ *		objects themselves, and not of the strings and vectors they
+ *		own.  The emitted instructions are counted as the assembly
+ *		code is written, by passing it through a stream buffer that
+ *		counts the lines that are neither labels, directives, nor
+ *		comments.
+ *
+ *		Both reports end with the peak memory used, and are written
+ *		to the standard error, either as tables or, if either
+ *		option is given as =json, as a single JSON object.
+ *
+ *		With -ftime-trace, a span is recorded for each phase and
+ *		pass, and within them for the work on each function, which
+ *		are written as complete events in the trace event format
+ *		read by Perfetto and chrome://tracing.  Each span for a
+ *		function is annotated with its name and the number of its
+ *		statements, and the spans that allocate its frame and
+ *		generate its code also with the size of the frame and the
+ *		number of values spilled.  Those two are counted for each
+ *		thread, and the spans are recorded with the thread that ran
+ *		them, under a lock, so that functions may be compiled in
+ *		parallel.
+ */
+
+# include <map>
+# include <mutex>
+# include <atomic>
+# include <string>
+# include <cstdio>
+# include <cstdlib>
+# include <typeinfo>
+# include <fstream>
+# include <sstream>
+# include <iostream>
+# include <algorithm>
+# include <cxxabi.h>
+# include <sys/resource.h>
+# include "IR.h"
+# include "Tree.h"
+# include "Label.h"
+# include "Scope.h"
+# include "statistics.h"
+
+using namespace std;
+
+bool timeReport = false, memReport = false, jsonReport = false;
+bool timeTrace = false;
+string traceFile;
+
+/* The size of the frame of the function last laid out by this thread,
+   and the number of values this thread has spilled to frames. */
+
+thread_local int frameSize;
+thread_local unsigned long frameSpills;
+
+Timing phaseTimes[NUM_PHASES] = {
+    {"lex"}, {"parse/check"}, {"allocate"}, {"output"}, {"assemble"},
+};
+
+vector<Timing> passTimes;
+unsigned long tallies[NUM_COUNTS];
+
+static vector<const Node *> nodes;
+static unsigned long nodeBytes, emitted, assemblyBytes;
+
+struct Event {
+    string name, args;
+    double start, duration;
+    unsigned thread;
+};
+
+static vector<Event> events;
+static map<string, unsigned> statements;
+static mutex traceLock;
+static atomic<unsigned> numThreads(0);
+static const Instant origin = now();
+
+
+/* A stream buffer that counts the instructions and bytes written
+   through it to another stream buffer. */
+
+class Counter : public streambuf {
+    streambuf *_output;
+    unsigned _column;
+    bool _instruction;
+
+protected:
+    virtual int overflow(int c);
+    virtual streamsize xsputn(const char *s, streamsize n);
+    virtual int sync();
+
+public:
+    Counter(streambuf *output);
+};
+
+
+/*
+ * Function:	Counter::Counter (constructor)
+ *
+ * Description:	Initialize this counter to pass its output to the given
+ *		stream buffer.
+ */
+
+Counter::Counter(streambuf *output)
+    : _output(output), _column(0), _instruction(false)
+{
+}
+
+
+/*
+ * Function:	Counter::overflow
+ *
+ * Description:	Count and write a character.  A line is an instruction if
+ *		it starts with a tab that is not followed by a directive or
+ *		a comment.
+ */
+
+int Counter::overflow(int c)
+{
+    if (c == EOF)
+	return 0;
+
+    assemblyBytes ++;
+
+    if (c == '\n') {
+	if (_instruction)
+	    emitted ++;
+
+	_column = 0;
+	_instruction = false;
+    } else if (_column ++ == 1)
+	_instruction = (c != '.' && c != '#');
+
+    return _output->sputc(c);
+}
+
+
+/*
+ * Function:	Counter::xsputn
+ *
+ * Description:	Count and write a sequence of characters.
+ */
+
+streamsize Counter::xsputn(const char *s, streamsize n)
+{
+    for (streamsize i = 0; i < n; i ++)
+	if (overflow((unsigned char) s[i]) == EOF)
+	    return i;
+
+    return n;
+}
+
+
+/*
+ * Function:	Counter::sync
+ *
+ * Description:	Flush the stream buffer to which output is passed.
+ */
+
+int Counter::sync()
+{
+    return _output->pubsync();
+}
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Return the current wall-clock and processor time.
+ */
+
+Instant now()
+{
+    Instant instant;
+
+
+    instant.wall = chrono::steady_clock::now();
+    instant.cpu = clock();
+    instant.spills = frameSpills;
+    return instant;
+}
+
+
+/*
+ * Function:	charge
+ *
+ * Description:	Charge the time since the given instant to a phase or
+ *		pass.
+ */
+
+void charge(Timing &timing, const Instant &start)
+{
+    chrono::duration<double, milli> elapsed;
+
+
+    elapsed = chrono::steady_clock::now() - start.wall;
+    timing.wall += elapsed.count();
+    timing.cpu += 1000.0 * (clock() - start.cpu) / CLOCKS_PER_SEC;
+}
+
+void charge(Phase phase, const Instant &start)
+{
+    charge(phaseTimes[phase], start);
+}
+
+
+/*
+ * Function:	finish
+ *
+ * Description:	Finish a phase that started at the given instant, charging
+ *		and tracing its time if asked.
+ */
+
+void finish(Phase phase, const Instant &start)
+{
+    if (timeReport)
+	charge(phase, start);
+
+    if (timeTrace)
+	trace(phaseTimes[phase].name, start);
+}
+
+
+/*
+ * Function:	record
+ *
+ * Description:	Record the allocation of a tree node of the given size,
+ *		so that the nodes of each class can be counted once they
+ *		have been constructed.
+ */
+
+void record(const Node *node, size_t size)
+{
+    nodes.push_back(node);
+    tallies[NODES] ++;
+    nodeBytes += size;
+}
+
+
+/*
+ * Function:	countInstructions
+ *
+ * Description:	Return a stream buffer that counts the instructions written
+ *		through it to the given stream buffer.
+ */
+
+streambuf *countInstructions(streambuf *output)
+{
+    return new Counter(output);
+}
+
+
+/*
+ * Function:	peakMemory (private)
+ *
+ * Description:	Return the peak memory used in kilobytes.  The maximum
+ *		resident set size is in kilobytes on Linux, but in bytes on
+ *		macOS.
+ */
+
+static long peakMemory()
+{
+    struct rusage usage;
+
+
+    getrusage(RUSAGE_SELF, &usage);
+# if defined (__APPLE__)
+    usage.ru_maxrss /= 1024;
+# endif
+    return usage.ru_maxrss;
+}
+
+
+/*
+ * Function:	className (private)
+ *
+ * Description:	Return the name of the class of a tree node.
+ */
+
+static string className(const Node *node)
+{
+    const char *mangled = typeid(*node).name();
+    char *demangled;
+    string name;
+    int status;
+
+
+    demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    name = status == 0 ? demangled : mangled;
+    free(demangled);
+    return name;
+}
+
+
+/*
+ * Function:	writeTiming (private)
+ *
+ * Description:	Write the time taken by a phase or pass as a row of a
+ *		table or as a JSON object.
+ */
+
+static void writeTiming(const Timing &timing, double total, bool pass)
+{
+    char line[200];
+
+
+    if (jsonReport)
+	snprintf(line, sizeof(line), "{\"name\": \"%s\", \"wall_ms\": %.3f, "
+	    "\"cpu_ms\": %.3f, \"blocks\": %ld, \"instructions\": %ld}",
+	    timing.name, timing.wall, timing.cpu, timing.blocks,
+	    timing.instructions);
+    else if (pass)
+	snprintf(line, sizeof(line), "%-16s %11.3f %11.3f %7.1f %+9ld %+13ld",
+	    timing.name, timing.wall, timing.cpu,
+	    total > 0 ? 100 * timing.wall / total : 0, timing.blocks,
+	    timing.instructions);
+    else
+	snprintf(line, sizeof(line), "%-16s %11.3f %11.3f %7.1f", timing.name,
+	    timing.wall, timing.cpu, total > 0 ? 100 * timing.wall / total : 0);
+
+    cerr << line;
+}
+
+
+/*
+ * Function:	reportTimes (private)
+ *
+ * Description:	Write the time taken by each phase and by each pass that
+ *		ran, and the change each pass made to the number of blocks
+ *		and instructions.  The phases that precede the passes are
+ *		written before them, and those that follow, after them.
+ */
+
+static void reportTimes()
+{
+    vector<Timing> rows;
+    Timing total = {"total"}, &lex = phaseTimes[LEXING];
+    Timing &parse = phaseTimes[PARSING];
+
+
+    if (parse.wall > 0)
+	lex.cpu = parse.cpu * lex.wall / parse.wall;
+
+    parse.wall -= lex.wall;
+    parse.cpu -= lex.cpu;
+
+    rows.assign(phaseTimes, phaseTimes + OUTPUT);
+    rows.insert(rows.end(), passTimes.begin(), passTimes.end());
+
+    for (unsigned i = OUTPUT; i < NUM_PHASES; i ++)
+	if (i != ASSEMBLING || phaseTimes[i].wall > 0)
+	    rows.push_back(phaseTimes[i]);
+
+    for (unsigned i = 0; i < rows.size(); i ++) {
+	total.wall += rows[i].wall;
+	total.cpu += rows[i].cpu;
+	total.blocks += rows[i].blocks;
+	total.instructions += rows[i].instructions;
+    }
+
+    if (jsonReport) {
+	cerr << "\"time\": {\"phases\": [";
+
+	for (unsigned i = 0; i < NUM_PHASES; i ++) {
+	    cerr << (i > 0 ? ", " : "");
+	    writeTiming(phaseTimes[i], total.wall, false);
+	}
+
+	cerr << "], \"passes\": [";
+
+	for (unsigned i = 0; i < passTimes.size(); i ++) {
+	    cerr << (i > 0 ? ", " : "");
+	    writeTiming(passTimes[i], total.wall, true);
+	}
+
+	cerr << "], \"total\": ";
+	writeTiming(total, total.wall, true);
+	cerr << "}";
+	return;
+    }
+
+    cerr << "pass               wall (ms)    cpu (ms)       %    blocks  instructions" << endl;
+
+    for (unsigned i = 0; i < rows.size(); i ++) {
+	writeTiming(rows[i], total.wall, i >= OUTPUT && i < OUTPUT + passTimes.size());
+	cerr << endl;
+    }
+
+    writeTiming(total, total.wall, true);
+    cerr << endl;
+}
+
+
+/*
+ * Function:	reportMemory (private)
+ *
+ * Description:	Write the number of objects of each kind that were created,
+ *		and the bytes they take, with the tree nodes also counted by
+ *		class from the most to the least numerous.
+ */
+
+static void reportMemory()
+{
+    static const char *names[] = {
+	"tokens", "nodes", "symbols", "scopes", "instructions", "blocks",
+	"spills",
+    };
+
+    vector<pair<string, unsigned long>> rows;
+    vector<pair<unsigned long, string>> classes;
+    map<string, unsigned long> numbers;
+    unsigned long numTypes, typeBytes;
+    const char *separator = "";
+    char line[100];
+
+
+    numTypes = Type::tables(typeBytes);
+
+    for (unsigned i = 0; i < nodes.size(); i ++)
+	numbers[className(nodes[i])] ++;
+
+    for (auto &entry : numbers)
+	classes.push_back(make_pair(entry.second, entry.first));
+
+    sort(classes.begin(), classes.end(),
+	[](const pair<unsigned long, string> &a, const pair<unsigned long, string> &b) {
+	    return a.first > b.first || (a.first == b.first && a.second < b.second);
+	});
+
+    rows.push_back(make_pair("nodes", nodeBytes));
+    rows.push_back(make_pair("symbols", tallies[SYMBOLS] * sizeof(Symbol)));
+    rows.push_back(make_pair("scopes", tallies[SCOPES] * sizeof(Scope)));
+    rows.push_back(make_pair("types", typeBytes));
+    rows.push_back(make_pair("instructions", tallies[INSTRUCTIONS] * sizeof(Instruction)));
+    rows.push_back(make_pair("blocks", tallies[BLOCKS] * sizeof(BasicBlock)));
+    rows.push_back(make_pair("assembly", assemblyBytes));
+
+    if (jsonReport) {
+	cerr << "\"memory\": {\"counts\": {";
+
+	for (unsigned i = 0; i < NUM_COUNTS; i ++)
+	    cerr << (i > 0 ? ", " : "") << "\"" << names[i] << "\": " << tallies[i];
+
+	cerr << ", \"types\": " << numTypes << ", \"labels\": " << Label::count();
+	cerr << ", \"emitted\": " << emitted << "}, \"nodes\": {";
+
+	for (unsigned i = 0; i < classes.size(); i ++) {
+	    cerr << separator << "\"" << classes[i].second << "\": " << classes[i].first;
+	    separator = ", ";
+	}
+
+	cerr << "}, \"bytes\": {";
+
+	for (unsigned i = 0; i < rows.size(); i ++)
+	    cerr << (i > 0 ? ", " : "") << "\"" << rows[i].first << "\": " << rows[i].second;
+
+	cerr << "}}";
+	return;
+    }
+
+    cerr << "item                    count         bytes" << endl;
+
+    for (unsigned i = 0; i < NUM_COUNTS; i ++) {
+	snprintf(line, sizeof(line), "%-16s %12lu", names[i], tallies[i]);
+	cerr << line;
+
+	for (unsigned j = 0; j < rows.size(); j ++)
+	    if (rows[j].first == names[i]) {
+		snprintf(line, sizeof(line), " %13lu", rows[j].second);
+		cerr << line;
+	    }
+
+	cerr << endl;
+
+	if (i == NODES)
+	    for (unsigned j = 0; j < classes.size(); j ++) {
+		snprintf(line, sizeof(line), "  %-14s %12lu", classes[j].second.c_str(),
+		    classes[j].first);
+		cerr << line << endl;
+	    }
+    }
+
+    snprintf(line, sizeof(line), "%-16s %12lu %13lu", "types", numTypes, typeBytes);
+    cerr << line << endl;
+    snprintf(line, sizeof(line), "%-16s %12u", "labels", Label::count());
+    cerr << line << endl;
+    snprintf(line, sizeof(line), "%-16s %12lu %13lu", "emitted", emitted, assemblyBytes);
+    cerr << line << endl;
+}
+
+
+/*
+ * Function:	reportStatistics
+ *
+ * Description:	Write the reports that were asked for, followed by the
+ *		peak memory used.
+ */
+
+void reportStatistics()
+{
+    if (jsonReport) {
+	cerr << "{";
+
+	if (timeReport) {
+	    reportTimes();
+	    cerr << ", ";
+	}
+
+	if (memReport) {
+	    reportMemory();
+	    cerr << ", ";
+	}
+
+	cerr << "\"peak_memory_kb\": " << peakMemory() << "}" << endl;
+	return;
+    }
+
+    if (timeReport)
+	reportTimes();
+
+    if (memReport)
+	reportMemory();
+
+    cerr << "peak memory (KB)  " << peakMemory() << endl;
+}
+
+
+/*
+ * Function:	trace
+ *
+ * Description:	Record a span from the given instant until now, run by
+ *		the current thread.  The threads are numbered in the order
+ *		in which they first record a span.  A span for a function
+ *		is annotated with its name and number of statements, and,
+ *		if it laid out the frame, with its size and the number of
+ *		values spilled to it.
+ */
+
+void trace(const char *name, const Instant &start, const string &function,
+	bool frame)
+{
+    static thread_local unsigned thread = numThreads ++;
+    chrono::duration<double, micro> offset, duration;
+    stringstream args;
+    Event event;
+
+
+    duration = chrono::steady_clock::now() - start.wall;
+    offset = start.wall - origin.wall;
+
+    if (!function.empty()) {
+	traceLock.lock();
+	args << "{\"function\": \"" << function << "\", \"statements\": ";
+	args << statements[function];
+	traceLock.unlock();
+
+	if (frame) {
+	    args << ", \"frame_size\": " << frameSize;
+	    args << ", \"spills\": " << frameSpills - start.spills;
+	}
+
+	args << "}";
+    }
+
+    event.name = name;
+    event.args = args.str();
+    event.start = offset.count();
+    event.duration = duration.count();
+    event.thread = thread;
+
+    traceLock.lock();
+    events.push_back(event);
+    traceLock.unlock();
+}
+
+void trace(const char *name, const Instant &start)
+{
+    trace(name, start, "");
+}
+
+
+/*
+ * Function:	countStatements
+ *
+ * Description:	Record the number of statements in a function, with
+ *		which its spans are annotated.
+ */
+
+void countStatements(const string &function, unsigned count)
+{
+    traceLock.lock();
+    statements[function] = count;
+    traceLock.unlock();
+}
+
+
+/*
+ * Function:	writeTrace
+ *
+ * Description:	Write the spans to the trace file as complete events,
+ *		preceded by the names of the process and its threads.  The
+ *		times are in microseconds since the compiler started.
+ */
+
+void writeTrace()
+{
+    ofstream file(traceFile.c_str());
+    char line[100];
+
+
+    if (!file) {
+	cerr << "scc: cannot open '" << traceFile << "'" << endl;
+	return;
+    }
+
+    file << "{\"traceEvents\": [" << endl;
+    file << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, ";
+    file << "\"tid\": 0, \"args\": {\"name\": \"scc\"}}";
+
+    for (unsigned i = 0; i < numThreads; i ++) {
+	file << "," << endl << "{\"name\": \"thread_name\", \"ph\": \"M\", ";
+	file << "\"pid\": 1, \"tid\": " << i << ", \"args\": {\"name\": \"";
+	file << (i == 0 ? "main" : "worker " + to_string(i)) << "\"}}";
+    }
+
+    for (unsigned i = 0; i < events.size(); i ++) {
+	snprintf(line, sizeof(line), "\"ts\": %.3f, \"dur\": %.3f",
+	    events[i].start, events[i].duration);
+	file << "," << endl << "{\"name\": \"" << events[i].name << "\", ";
+	file << "\"ph\": \"X\", " << line << ", \"pid\": 1, ";
+	file << "\"tid\": " << events[i].thread;
+
+	if (!events[i].args.empty())
+	    file << ", \"args\": " << events[i].args;
+
+	file << "}";
+    }
+
+    file << endl << "], \"displayTimeUnit\": \"ms\"}" << endl;
+}
@@ -0,0 +1,62 @@
+/*
+ * File:	statistics.h
+ *
+ * Description:	This file contains the declarations for measuring the
+ *		costs of the compiler itself: the time taken by the phases
+ *		that run outside the pass manager and by each pass, which
+ *		are reported by -ftime-report, and the numbers and sizes of
+ *		the objects it creates, which are reported by -fmem-report.
+ *		With -ftime-trace, each phase and the work on each function
+ *		are also traced.  Nothing is measured unless it is to be
+ *		reported or traced.
+ */
+
+# ifndef STATISTICS_H
+# define STATISTICS_H
+# include <ctime>
+# include <chrono>
+# include <string>
+# include <vector>
+# include <streambuf>
+
+enum Phase {LEXING, PARSING, ALLOCATING, OUTPUT, ASSEMBLING, NUM_PHASES};
+
+enum Count {
+    TOKENS, NODES, SYMBOLS, SCOPES, INSTRUCTIONS, BLOCKS, SPILLS, NUM_COUNTS
+};
+
+struct Instant {
+    std::chrono::steady_clock::time_point wall;
+    std::clock_t cpu;
+    unsigned long spills;
+};
+
+struct Timing {
+    const char *name;
+    double wall, cpu;
+    long blocks, instructions;
+};
+
+extern bool timeReport, memReport, jsonReport, timeTrace;
+extern std::string traceFile;
+extern thread_local int frameSize;
+extern thread_local unsigned long frameSpills;
+extern Timing phaseTimes[NUM_PHASES];
+extern std::vector<Timing> passTimes;
+extern unsigned long tallies[NUM_COUNTS];
+
+Instant now();
+void charge(Timing &timing, const Instant &start);
+void charge(Phase phase, const Instant &start);
+void finish(Phase phase, const Instant &start);
+void record(const class Node *node, size_t size);
+std::streambuf *countInstructions(std::streambuf *output);
+void reportStatistics();
+
+void trace(const char *name, const Instant &start);
+void trace(const char *name, const Instant &start, const std::string &function,
+	bool frame = false);
+void countStatements(const std::string &function, unsigned count);
+void writeTrace();
+
+# endif /* STATISTICS_H */
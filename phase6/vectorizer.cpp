@@ -0,0 +1,539 @@
+/*
+ * File:	vectorizer.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for the loop vectorizer, which rewrites a
+ *		counted loop such as
+ *
+ *		    while (i < n) { a[i] = b[i] + c[i]; i = i + 1; }
+ *
+ *		so that each iteration does the work of several, using the
+ *		SSE2 instructions on 16-byte vectors, or the AVX2
+ *		instructions on 32-byte vectors if requested.  Only a loop
+ *		of a single block is vectorized.  Its only phi function
+ *		must be a variable that is incremented by one and compared
+ *		against an invariant limit at the bottom of the loop, and
+ *		its loads and stores must all be of consecutive int or long
+ *		elements of arrays indexed by that variable.  The stored
+ *		values must be computed by adding, subtracting, and
+ *		multiplying the loaded elements, the variable itself, and
+ *		invariant values.
+ *
+ *		Since the arrays are usually pointer parameters, we cannot
+ *		know whether they overlap.  So before the loop we check
+ *		that each stored array is at least a vector away from every
+ *		other array, in which case no iteration of the vector loop
+ *		can write an element read or written by another.  Arrays
+ *		that are distinct variables never overlap and need no
+ *		check.  If the check passes and at least one vector of
+ *		iterations remains, the vector loop is run, and then the
+ *		original loop does whatever iterations are left:
+ *
+ *		    preheader:	check, and branch to scalar or vector
+ *		    vector:	splats of the invariant values
+ *		    body:	the vector loop, while a vector remains
+ *		    middle:	branch to scalar if iterations remain
+ *		    scalar:	phi for the variable from either path
+ *		    loop:	the original loop
+ *		    done:	phi for the final value of the variable
+ */
+
+# include <algorithm>
+# include "machine.h"
+# include "IR.h"
+
+using namespace std;
+
+unsigned vectorSize = 16;
+bool vectorizeLoops = true;
+
+static BasicBlock *loop;
+static Instruction *induction, *initial, *index, *ramp;
+static unsigned lane, width, lanes;
+static Instructions constants, setup, body;
+static map<Instruction *, Instruction *> widened, cloned;
+
+
+/*
+ * Function:	constant (private)
+ *
+ * Description:	Create a constant, to be placed in the preheader.
+ */
+
+static Instruction *constant(unsigned size, long value)
+{
+    Instruction *in = new Instruction(OP_CONST, size, {}, value);
+
+    constants.push_back(in);
+    return in;
+}
+
+
+/*
+ * Function:	base (private)
+ *
+ * Description:	Return the invariant base of an address of the form base +
+ *		i * size, where i is the induction variable and size is
+ *		the size of each lane, or null if it is not of that form.
+ */
+
+static Instruction *base(Instruction *address)
+{
+    if (address->_opcode != OP_ADD || address->_block != loop)
+	return nullptr;
+
+    for (unsigned i = 0; i < 2; i ++) {
+	Instruction *start = address->_operands[i];
+	Instruction *offset = address->_operands[1 - i];
+
+	if (start->_block == loop || offset->_opcode != OP_MUL ||
+		offset->_block != loop)
+	    continue;
+
+	for (unsigned j = 0; j < 2; j ++) {
+	    Instruction *x = offset->_operands[j], *c = offset->_operands[1 - j];
+
+	    if (c->_opcode != OP_CONST || c->_value != lane)
+		continue;
+
+	    if (x == induction && x->_size == SIZEOF_PTR)
+		return start;
+
+	    if (x->_opcode == OP_EXT && x->_operands[0] == induction)
+		return start;
+	}
+    }
+
+    return nullptr;
+}
+
+
+/*
+ * Function:	scalar (private)
+ *
+ * Description:	Return the value in the vector loop of a scalar computed
+ *		from the induction variable, which is the value for the
+ *		first of its lanes.
+ */
+
+static Instruction *scalar(Instruction *in)
+{
+    Instruction *copy;
+
+
+    if (in == induction)
+	return index;
+
+    if (in->_block != loop)
+	return in;
+
+    if (cloned.count(in) > 0)
+	return cloned[in];
+
+    copy = new Instruction(in->_opcode, in->_size, in->_operands, in->_value);
+
+    for (unsigned i = 0; i < copy->_operands.size(); i ++)
+	copy->_operands[i] = scalar(copy->_operands[i]);
+
+    body.push_back(copy);
+    cloned[in] = copy;
+    return copy;
+}
+
+
+/*
+ * Function:	sequence (private)
+ *
+ * Description:	Return the vector holding the values of the induction
+ *		variable in each lane, which is a phi function starting at
+ *		the initial value plus the lane numbers.  Its second
+ *		operand is filled in once the body is done.
+ */
+
+static Instruction *sequence()
+{
+    Instruction *first = initial, *splat, *iota, *start;
+
+
+    if (ramp == nullptr) {
+	if (first->_size != lane) {
+	    first = new Instruction(OP_EXT, lane, {initial});
+	    setup.push_back(first);
+	}
+
+	splat = new Instruction(OP_SPLAT, width, {first}, lane);
+	iota = new Instruction(OP_IOTA, width, {}, lane);
+	start = new Instruction(OP_ADD, width, {splat, iota}, lane);
+	setup.insert(setup.end(), {splat, iota, start});
+	ramp = new Instruction(OP_PHI, width, {start, nullptr}, lane);
+    }
+
+    return ramp;
+}
+
+
+/*
+ * Function:	widen (private)
+ *
+ * Description:	Return the vector of the values of a scalar in each lane,
+ *		or null if it cannot be computed as a vector.  An invariant
+ *		value is splatted in the vector preheader.
+ */
+
+static Instruction *widen(Instruction *in)
+{
+    Instruction *a, *b, *result;
+
+
+    if (widened.count(in) > 0)
+	return widened[in];
+
+    if (in->_size != lane)
+	return nullptr;
+
+    if (in->_block != loop) {
+	result = new Instruction(OP_SPLAT, width, {in}, lane);
+	setup.push_back(result);
+
+    } else if (in == induction ||
+	    (in->_opcode == OP_EXT && in->_operands[0] == induction))
+	result = sequence();
+
+    else if (in->_opcode == OP_ADD || in->_opcode == OP_SUB ||
+	    (in->_opcode == OP_MUL && lane == SIZEOF_INT)) {
+	if ((a = widen(in->_operands[0])) == nullptr)
+	    return nullptr;
+
+	if ((b = widen(in->_operands[1])) == nullptr)
+	    return nullptr;
+
+	result = new Instruction(in->_opcode, width, {a, b}, lane);
+	body.push_back(result);
+
+    } else
+	return nullptr;
+
+    widened[in] = result;
+    return result;
+}
+
+
+/*
+ * Function:	translate (private)
+ *
+ * Description:	Translate the loads and stores of the loop into the body
+ *		of the vector loop, in their original order, along with the
+ *		values they need.  The bases of the accessed arrays are
+ *		recorded, with a store flagged by a true second member.
+ *		Return false if some instruction cannot be vectorized.
+ */
+
+static bool translate(vector<pair<Instruction *, bool>> &bases)
+{
+    Instructions &instructions = loop->_instructions;
+    Instruction *start, *address, *value;
+
+
+    for (unsigned i = 0; i < instructions.size(); i ++) {
+	Instruction *in = instructions[i];
+
+	if (in->_opcode == OP_CALL || (in->_opcode == OP_PHI && in != induction))
+	    return false;
+
+	if (in->_opcode != OP_LOAD && in->_opcode != OP_STORE)
+	    continue;
+
+	if (lane == 0)
+	    lane = in->_size;
+
+	if (in->_size != lane || (lane != SIZEOF_INT && lane != SIZEOF_LONG))
+	    return false;
+
+	if ((start = base(in->_operands[0])) == nullptr)
+	    return false;
+
+	lanes = width / lane;
+	address = scalar(in->_operands[0]);
+	bases.push_back(make_pair(start, in->_opcode == OP_STORE));
+
+	if (in->_opcode == OP_LOAD) {
+	    widened[in] = new Instruction(OP_LOAD, width, {address}, lane);
+	    body.push_back(widened[in]);
+
+	} else {
+	    if ((value = widen(in->_operands[1])) == nullptr)
+		return false;
+
+	    body.push_back(new Instruction(OP_STORE, width, {address, value}, lane));
+	}
+    }
+
+    return true;
+}
+
+
+/*
+ * Function:	distinct (private)
+ *
+ * Description:	Return whether two arrays are distinct variables, which
+ *		can never overlap.
+ */
+
+static bool distinct(const Instruction *a, const Instruction *b)
+{
+    return (a->_opcode == OP_FRAME || a->_opcode == OP_GLOBAL) &&
+	(b->_opcode == OP_FRAME || b->_opcode == OP_GLOBAL);
+}
+
+
+/*
+ * Function:	link (private)
+ *
+ * Description:	Add an edge between two blocks.
+ */
+
+static void link(BasicBlock *from, BasicBlock *to)
+{
+    from->_successors.push_back(to);
+    to->_predecessors.push_back(from);
+}
+
+
+/*
+ * Function:	vectorize
+ *
+ * Description:	Vectorize the loop of a single block with the given
+ *		preheader, if possible.  Return whether the flow graph was
+ *		changed, in which case it must be ordered again.
+ */
+
+bool vectorize(Graph *graph, BasicBlock *preheader, BasicBlock *header)
+{
+    BasicBlock *start, *wide, *middle, *rest, *done, *exit;
+    Instruction *branch = header->terminator(), *next, *cond, *limit;
+    Instruction *first, *last, *test, *step, *stop, *resume, *final;
+    vector<pair<Instruction *, bool>> bases;
+    vector<pair<Instruction *, Instruction *>> pairs;
+    unsigned back, entry, count = 0;
+
+
+    /* Check that the loop is counted. */
+
+    if (!vectorizeLoops || branch == nullptr || branch->_opcode != OP_BRANCH)
+	return false;
+
+    if (header->_predecessors.size() != 2 || header->_successors[0] != header ||
+	    header->_successors[1] == header)
+	return false;
+
+    if (preheader->terminator() == nullptr ||
+	    preheader->terminator()->_opcode != OP_JUMP)
+	return false;
+
+    back = header->_predecessors[0] == header ? 0 : 1;
+    entry = 1 - back;
+    induction = header->_instructions[0];
+
+    if (induction->_opcode != OP_PHI || induction->_size < SIZEOF_INT)
+	return false;
+
+    next = induction->_operands[back];
+    cond = branch->_operands[0];
+
+    if (next->_opcode != OP_ADD || next->_block != header)
+	return false;
+
+    if (!(next->_operands[0] == induction && next->_operands[1]->_opcode == OP_CONST &&
+		next->_operands[1]->_value == 1) &&
+	    !(next->_operands[1] == induction && next->_operands[0]->_opcode == OP_CONST &&
+		next->_operands[0]->_value == 1))
+	return false;
+
+    if (cond->_opcode != OP_LT || cond->_operands[0] != next ||
+	    cond->_operands[1]->_block == header)
+	return false;
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++) {
+	Instructions &instructions = graph->_blocks[i]->_instructions;
+
+	if (graph->_blocks[i] != header)
+	    for (unsigned j = 0; j < instructions.size(); j ++)
+		for (unsigned k = 0; k < instructions[j]->_operands.size(); k ++) {
+		    Instruction *in = instructions[j]->_operands[k];
+
+		    if (in->_block == header && in != next)
+			return false;
+		}
+    }
+
+
+    /* Translate the body. */
+
+    loop = header;
+    limit = cond->_operands[1];
+    initial = induction->_operands[entry];
+    index = new Instruction(OP_PHI, induction->_size, Instructions(2));
+    ramp = nullptr;
+    lane = 0;
+    width = vectorSize;
+    constants.clear();
+    setup.clear();
+    body.clear();
+    widened.clear();
+    cloned.clear();
+
+    if (!translate(bases))
+	return false;
+
+
+    /* Find the pairs of arrays that may overlap, one being stored. */
+
+    for (unsigned i = 0; i < bases.size(); i ++)
+	for (unsigned j = 0; j < bases.size(); j ++) {
+	    Instruction *a = bases[i].first, *b = bases[j].first;
+	    bool found = a == b || distinct(a, b);
+
+	    if (!bases[i].second || (bases[j].second && j < i))
+		continue;
+
+	    for (unsigned k = 0; k < pairs.size(); k ++)
+		if ((pairs[k].first == a && pairs[k].second == b) ||
+			(pairs[k].first == b && pairs[k].second == a))
+		    found = true;
+
+	    if (!found)
+		pairs.push_back(make_pair(a, b));
+	}
+
+    if (find_if(bases.begin(), bases.end(), [](const pair<Instruction *, bool> &p) {
+		return p.second; }) == bases.end())
+	return false;
+
+
+    /* The preheader skips the vector loop if less than a vector of
+       iterations remain, computed using long integers so nothing can
+       overflow, or if some pair of arrays is less than a vector apart. */
+
+    start = new BasicBlock();
+    wide = new BasicBlock();
+    middle = new BasicBlock();
+    rest = new BasicBlock();
+    done = new BasicBlock();
+    exit = header->_successors[1];
+
+    first = initial;
+    last = limit;
+    preheader->_instructions.pop_back();
+
+    if (induction->_size != SIZEOF_LONG) {
+	first = new Instruction(OP_EXT, SIZEOF_LONG, {initial});
+	last = new Instruction(OP_EXT, SIZEOF_LONG, {limit});
+	preheader->append(first);
+	preheader->append(last);
+    }
+
+    stop = new Instruction(OP_SUB, SIZEOF_LONG, {last, constant(SIZEOF_LONG, lanes - 1)});
+    test = new Instruction(OP_GE, SIZEOF_INT, {first, stop});
+    preheader->append(stop);
+    preheader->append(test);
+
+    for (unsigned i = 0; i < pairs.size(); i ++) {
+	Instruction *distance, *above, *below, *near;
+
+	distance = new Instruction(OP_SUB, SIZEOF_PTR, {pairs[i].second, pairs[i].first});
+	above = new Instruction(OP_GT, SIZEOF_INT, {distance, constant(SIZEOF_PTR, -(long) width)});
+	below = new Instruction(OP_LT, SIZEOF_INT, {distance, constant(SIZEOF_PTR, width)});
+	near = new Instruction(OP_MUL, SIZEOF_INT, {above, below});
+	preheader->append(distance);
+	preheader->append(above);
+	preheader->append(below);
+	preheader->append(near);
+	test = new Instruction(OP_ADD, SIZEOF_INT, {test, near});
+	preheader->append(test);
+    }
+
+    preheader->append(new Instruction(OP_BRANCH, 0, {test}));
+    preheader->_successors.clear();
+    header->_predecessors[entry] = rest;
+    link(preheader, rest);
+    link(preheader, start);
+
+
+    /* The vector preheader and the vector loop, which continues while
+       another vector of iterations remains. */
+
+    stop = new Instruction(OP_SUB, induction->_size,
+	    {limit, constant(induction->_size, lanes - 1)});
+    step = new Instruction(OP_ADD, induction->_size,
+	    {index, constant(induction->_size, lanes)});
+    index->_operands = {initial, step};
+
+    for (unsigned i = 0; i < setup.size(); i ++)
+	start->append(setup[i]);
+
+    start->append(stop);
+    start->append(new Instruction(OP_JUMP, 0));
+    link(start, wide);
+
+    wide->append(index);
+
+    if (ramp != nullptr) {
+	Instruction *splat = new Instruction(OP_SPLAT, width,
+		{constant(lane, lanes)}, lane);
+
+	start->insert(splat, start->_instructions.size() - 1);
+	ramp->_operands[1] = new Instruction(OP_ADD, width, {ramp, splat}, lane);
+	body.push_back(ramp->_operands[1]);
+	wide->append(ramp);
+    }
+
+    for (unsigned i = 0; i < body.size(); i ++)
+	wide->append(body[i]);
+
+    test = new Instruction(OP_LT, SIZEOF_INT, {step, stop});
+    wide->append(step);
+    wide->append(test);
+    wide->append(new Instruction(OP_BRANCH, 0, {test}));
+    link(wide, wide);
+    link(wide, middle);
+
+
+    /* The remaining iterations, if any, are done by the original loop,
+       and the final value of the variable comes from either loop. */
+
+    test = new Instruction(OP_LT, SIZEOF_INT, {step, limit});
+    middle->append(test);
+    middle->append(new Instruction(OP_BRANCH, 0, {test}));
+    link(middle, rest);
+    link(middle, done);
+
+    resume = new Instruction(OP_PHI, induction->_size, {initial, step});
+    induction->_operands[entry] = resume;
+    rest->append(resume);
+    rest->append(new Instruction(OP_JUMP, 0));
+    rest->_successors.push_back(header);
+
+    final = new Instruction(OP_PHI, induction->_size, {step, next});
+    done->append(final);
+    done->append(new Instruction(OP_JUMP, 0));
+    done->_predecessors.push_back(header);
+    done->_successors.push_back(exit);
+    header->_successors[1] = done;
+    replace(exit->_predecessors.begin(), exit->_predecessors.end(), header, done);
+
+    for (unsigned i = 0; i < graph->_blocks.size(); i ++)
+	if (graph->_blocks[i] != header)
+	    for (unsigned j = 0; j < graph->_blocks[i]->_instructions.size(); j ++) {
+		Instructions &operands = graph->_blocks[i]->_instructions[j]->_operands;
+		replace(operands.begin(), operands.end(), next, final);
+	    }
+
+    while (preheader->_instructions[count]->_opcode == OP_PHI)
+	count ++;
+
+    for (unsigned i = 0; i < constants.size(); i ++)
+	preheader->insert(constants[i], count);
+
+    graph->_blocks.insert(graph->_blocks.end(), {start, wide, middle, rest, done});
+    return true;
+}